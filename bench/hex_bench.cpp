@@ -0,0 +1,401 @@
+/********************************************************************************
+ * File: hex_bench.cpp
+ * Author: ppkantorski
+ * Description:
+ *   Host benchmark for the hex layer of libultra. A deterministic generator
+ *   writes a binary of configurable size with known patterns planted through
+ *   it, and each search and edit entry point is timed against it, reporting
+ *   ops/sec, time per call, throughput over the file and heap allocations.
+ *
+ *   Build from the repository root on Linux or macOS:
+ *     g++ -std=c++20 -O2 -include memory -Ilibultra/include bench/hex_bench.cpp \
+ *         libultra/source/{hex_funcs,path_funcs,get_funcs,string_funcs,debug_funcs,global_vars}.cpp \
+ *         -lpthread -o hex_bench
+ *
+ *   Run it from a scratch directory. libultra roots every path at "sdmc:/", so
+ *   the binary is written under ./sdmc:/bench/.
+ *     ./hex_bench [file MiB] [seed]
+ *
+ *   USING_MMAP_DIRECTIVE defaults to 1 on hosts; add -DUSING_MMAP_DIRECTIVE=0 and
+ *   rerun to compare every scan row against the buffered read path.
+ *
+ *   Rows that say "cold" drop the in-memory offsets and the on-disk offset index
+ *   before every call, so each call scans the file.
+ *
+ *   For the latest updates and contributions, visit the project's GitHub repository.
+ *   (GitHub Repository: https://github.com/ppkantorski/Ultrahand-Overlay)
+ *
+ *   Note: Please be aware that this notice cannot be altered or removed. It is a part
+ *   of the project's documentation and must remain intact.
+ *
+ *  Licensed under both GPLv2 and CC-BY-4.0
+ *  Copyright (c) 2024 ppkantorski
+ ********************************************************************************/
+
+#include <hex_funcs.hpp>
+#include <path_funcs.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <tuple>
+#include <utime.h>
+
+namespace ult {
+    // Normally defined by download_funcs.cpp, which needs curl and zlib
+    std::atomic<int> downloadPercentage(-1);
+    std::atomic<int> unzipPercentage(-1);
+}
+
+namespace {
+    std::atomic<size_t> allocationCount{0};
+    std::atomic<size_t> allocationBytes{0};
+    volatile size_t benchSink = 0;  // Keeps byte sums from being optimized away
+}
+
+// Every heap allocation made by the process is counted
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* block = std::malloc(size ? size : 1)) return block;
+    throw std::bad_alloc();
+}
+void operator delete(void* block) noexcept { std::free(block); }
+void operator delete(void* block, size_t) noexcept { std::free(block); }
+
+namespace {
+    using namespace ult;
+
+    struct BinarySpec {
+        size_t sizeMiB = 32;
+        uint32_t seed = 1;
+    };
+
+    // xorshift32, so a seed gives the same binary with any standard library
+    struct BinaryRandom {
+        uint32_t state;
+        explicit BinaryRandom(uint32_t seed) : state(seed ? seed : 1) {}
+        uint32_t next() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+        uint32_t below(uint32_t bound) { return bound ? next() % bound : 0; }
+    };
+
+    constexpr size_t PATTERN_COUNT = 64;
+    constexpr size_t PATTERN_LENGTH = 8;
+    constexpr size_t PLANTS_PER_PATTERN = 16;
+
+    struct GeneratedBinary {
+        std::vector<unsigned char> bytes;
+        std::vector<std::string> patterns;  // Hex strings, each planted PLANTS_PER_PATTERN times
+    };
+
+    std::string toHex(const unsigned char* data, size_t length) {
+        static constexpr char DIGITS[] = "0123456789ABCDEF";
+        std::string hex;
+        hex.reserve(length * 2);
+        for (size_t i = 0; i < length; ++i) {
+            hex += DIGITS[data[i] >> 4];
+            hex += DIGITS[data[i] & 0x0F];
+        }
+        return hex;
+    }
+
+    GeneratedBinary generateBinary(const BinarySpec& spec) {
+        BinaryRandom random(spec.seed);
+        GeneratedBinary binary;
+        binary.bytes.resize(spec.sizeMiB << 20);
+        for (unsigned char& byte : binary.bytes) byte = static_cast<unsigned char>(random.next() >> 24);
+
+        for (size_t p = 0; p < PATTERN_COUNT; ++p) {
+            unsigned char pattern[PATTERN_LENGTH];
+            for (unsigned char& byte : pattern) byte = static_cast<unsigned char>(random.next() >> 24);
+            binary.patterns.push_back(toHex(pattern, PATTERN_LENGTH));
+            for (size_t n = 0; n < PLANTS_PER_PATTERN; ++n) {
+                const size_t offset = random.below(static_cast<uint32_t>(binary.bytes.size() - PATTERN_LENGTH));
+                std::memcpy(binary.bytes.data() + offset, pattern, PATTERN_LENGTH);
+            }
+        }
+        return binary;
+    }
+
+    void writeBinary(const std::string& path, const std::vector<unsigned char>& bytes) {
+        if (FILE* file = fopen(path.c_str(), "wb")) {
+            fwrite(bytes.data(), 1, bytes.size(), file);
+            fclose(file);
+        }
+        // Stamp it well outside the racy window so the caches may keep it
+        const struct utimbuf times{1000000000, 1000000000};
+        utime(path.c_str(), &times);
+    }
+
+    // Drops every remembered offset so the next search reads the file
+    void forgetHexResults() {
+        clearHexSumCache();
+        clearHexOffsetIndex();
+    }
+
+    size_t fileBytes = 0;  // Bytes each scan row covers, for the MiB/s column; 0 for edit rows
+
+    template <typename Operation>
+    void measure(const std::string& name, Operation&& operation) {
+        operation();  // Warm-up, not counted
+
+        using Clock = std::chrono::steady_clock;
+        const auto minimum = std::chrono::milliseconds(500);
+        const size_t allocationsBefore = allocationCount.load();
+        const size_t allocatedBefore = allocationBytes.load();
+
+        size_t iterations = 0;
+        const auto start = Clock::now();
+        auto elapsed = Clock::duration::zero();
+        do {
+            operation();
+            ++iterations;
+            elapsed = Clock::now() - start;
+        } while (elapsed < minimum);
+
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        const double n = static_cast<double>(iterations);
+        char throughput[16] = "-";
+        if (fileBytes) snprintf(throughput, sizeof(throughput), "%.0f", static_cast<double>(fileBytes) * n / seconds / (1 << 20));
+        printf("%-48s %10.1f ops/s %10.3f ms %9s MiB/s %9.1f allocs %10.0f B alloc\n",
+               name.c_str(), n / seconds, seconds * 1000.0 / n, throughput,
+               static_cast<double>(allocationCount.load() - allocationsBefore) / n,
+               static_cast<double>(allocationBytes.load() - allocatedBefore) / n);
+    }
+}
+
+int main(int argc, char** argv) {
+    BinarySpec spec;
+    if (argc > 1) spec.sizeMiB = std::strtoul(argv[1], nullptr, 10);
+    if (argc > 2) spec.seed = static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10));
+    if (spec.sizeMiB == 0) {
+        fprintf(stderr, "usage: %s [file MiB] [seed]\n", argv[0]);
+        return 1;
+    }
+
+    mkdir("sdmc:", 0777);  // createDirectory starts below the volume root
+    createDirectory("sdmc:/bench/");
+    const std::string binaryPath = "sdmc:/bench/binary.bin";
+    const GeneratedBinary binary = generateBinary(spec);
+    writeBinary(binaryPath, binary.bytes);
+    fileBytes = binary.bytes.size();
+
+    printf("binary: %zu MiB, %zu patterns x %zu plants, seed %u\n"
+           "HEX_BUFFER_SIZE %zu B, USING_MMAP_DIRECTIVE %d, %u hardware threads\n\n",
+           spec.sizeMiB, PATTERN_COUNT, PLANTS_PER_PATTERN, spec.seed, HEX_BUFFER_SIZE, USING_MMAP_DIRECTIVE,
+           std::thread::hardware_concurrency());
+
+    const size_t scanThreads = HEX_SCAN_THREADS;
+    HEX_SCAN_THREADS = 1;
+
+    // K patterns found in one pass, against K single-pattern scans
+    for (const size_t count : {1, 4, 16, 64}) {
+        const std::vector<std::string> patterns(binary.patterns.begin(), binary.patterns.begin() + count);
+        const std::string suffix = " x" + std::to_string(count) + " (cold)";
+        measure("findHexDataOffsets grouped" + suffix, [&]() {
+            forgetHexResults();
+            findHexDataOffsets(binaryPath, patterns);
+        });
+        measure("findHexDataOffsetValues each" + suffix, [&]() {
+            forgetHexResults();
+            for (const std::string& pattern : patterns) findHexDataOffsetValues(binaryPath, pattern);
+        });
+    }
+
+    // One pattern scanned, answered from the on-disk index, then from memory
+    const std::string indexed = binary.patterns[0];
+    measure("findHexDataOffsetValues (cold)", [&]() {
+        forgetHexResults();
+        findHexDataOffsetValues(binaryPath, indexed);
+    });
+    fileBytes = 0;  // Cache hits read no file bytes
+    measure("findHexDataOffsetValues (on-disk index)", [&]() {
+        clearHexSumCache();
+        findHexDataOffsetValues(binaryPath, indexed);
+    });
+    measure("findHexDataOffsetValues (in memory)", [&]() {
+        findHexDataOffsetValues(binaryPath, indexed);
+    });
+    const std::vector<std::string> prefetched(binary.patterns.begin(), binary.patterns.begin() + 16);
+    fileBytes = binary.bytes.size();
+    measure("prefetchHexDataOffsets x16 (cold)", [&]() {
+        forgetHexResults();
+        prefetchHexDataOffsets(binaryPath, prefetched);
+    });
+    fileBytes = 0;
+    measure("findHexDataOffsetValues x16 (prefetched)", [&]() {
+        for (const std::string& pattern : prefetched) findHexDataOffsetValues(binaryPath, pattern);
+    });
+    fileBytes = binary.bytes.size();
+
+    // Every match as strings and as integers, then stopping at the first match
+    const std::string streamed = binary.patterns[1];
+    measure("findHexDataOffsets strings (cold)", [&]() {
+        forgetHexResults();
+        findHexDataOffsets(binaryPath, streamed);
+    });
+    measure("findHexDataOffsetValues all (cold)", [&]() {
+        forgetHexResults();
+        findHexDataOffsetValues(binaryPath, streamed);
+    });
+    fileBytes = 0;  // Early exits read only up to the first match
+    measure("findHexDataOffsetValues max 1 (cold)", [&]() {
+        forgetHexResults();
+        findHexDataOffsetValues(binaryPath, streamed, 1);
+    });
+    measure("findNthHexDataOffset 0th (cold)", [&]() {
+        forgetHexResults();
+        uint64_t offset = 0;
+        findNthHexDataOffset(binaryPath, streamed, 0, offset);
+    });
+    measure("forEachHexDataOffset stop at first (cold)", [&]() {
+        forgetHexResults();
+        forEachHexDataOffset(binaryPath, streamed, [](uint64_t) { return false; }, 1);
+    });
+    fileBytes = binary.bytes.size();
+
+    // A version string 64 KiB from the end, found from the whole file, from the tail and missed by the head
+    const std::string versionPath = "sdmc:/bench/version.bin";
+    {
+        std::vector<unsigned char> versioned = binary.bytes;
+        static constexpr char VERSION[] = "v1.2.3";
+        std::memcpy(versioned.data() + versioned.size() - (64 << 10), VERSION, sizeof(VERSION));
+        writeBinary(versionPath, versioned);
+    }
+    const std::tuple<const char*, VersionScanRegion, size_t> versionRegions[] = {
+        {"whole", VersionScanRegion::Whole, 0},
+        {"tail 1 MiB", VersionScanRegion::Tail, 1 << 20},
+        {"head 1 MiB, miss", VersionScanRegion::Head, 1 << 20},
+    };
+    for (const auto& [label, region, regionBytes] : versionRegions) {
+        fileBytes = regionBytes ? regionBytes : binary.bytes.size();
+        measure("extractVersionFromBinary " + std::string(label) + " (cold)", [&]() {
+            clearHexSumCache();
+            extractVersionFromBinary(versionPath, region, regionBytes);
+        });
+    }
+    fileBytes = 0;
+    measure("extractVersionFromBinary whole (cached)", [&]() {
+        extractVersionFromBinary(versionPath);
+    });
+    printf("  found \"%s\"\n", extractVersionFromBinary(versionPath).c_str());
+    fileBytes = binary.bytes.size();
+
+    // Touching every byte through MappedFile, against plain fread loops
+    const auto sumBytes = [](const unsigned char* data, size_t length) {
+        size_t sum = 0;
+        for (size_t i = 0; i < length; ++i) sum += data[i];
+        return sum;
+    };
+    measure("MappedFile::forEachRange (sequential)", [&]() {
+        MappedFile file(binaryPath);
+        size_t sum = 0;
+        file.forEachRange(HEX_BUFFER_SIZE, 0, [&](const unsigned char* data, size_t length, size_t) {
+            sum += sumBytes(data, length);
+            return true;
+        });
+        benchSink = sum;
+    });
+    for (const size_t bufferSize : {HEX_BUFFER_SIZE, size_t(1) << 20}) {
+        measure("fread loop, " + std::to_string(bufferSize) + " B buffer", [&]() {
+            std::vector<unsigned char> buffer(bufferSize);
+            size_t sum = 0;
+            if (FILE* file = fopen(binaryPath.c_str(), "rb")) {
+                size_t length;
+                while ((length = fread(buffer.data(), 1, buffer.size(), file)) > 0) sum += sumBytes(buffer.data(), length);
+                fclose(file);
+            }
+            benchSink = sum;
+        });
+    }
+
+    // One pattern exact, then with wildcard nibbles; masked patterns are not cached, so every row scans
+    const std::string exact = binary.patterns[0];
+    const std::pair<const char*, std::string> maskedPatterns[] = {
+        {"exact", exact},
+        {"1 wildcard byte", exact.substr(0, 6) + "??" + exact.substr(8)},
+        {"leading wildcard", "??" + exact.substr(2)},
+        {"4 wildcard nibbles", exact.substr(0, 4) + "?" + exact.substr(5, 4) + "?" + exact.substr(10, 2) + "????"},
+    };
+    for (const auto& [label, pattern] : maskedPatterns) {
+        measure("findHexDataOffsets " + std::string(label) + " (cold)", [&]() {
+            forgetHexResults();
+            findHexDataOffsets(binaryPath, pattern);
+        });
+    }
+    const HexMaskedSearcher compiled(maskedPatterns[1].second);
+    measure("findHexDataOffsets precompiled mask", [&]() {
+        findHexDataOffsets(binaryPath, compiled);
+    });
+
+    // Scan workers; files are split into segments of at least 4 MiB
+    const std::vector<std::string> scaled(binary.patterns.begin(), binary.patterns.begin() + 16);
+    for (size_t threads = 1; threads <= 4; ++threads) {
+        HEX_SCAN_THREADS = threads;
+        const std::string suffix = " (" + std::to_string(threads) + " workers, cold)";
+        measure("findHexDataOffsetValues" + suffix, [&]() {
+            forgetHexResults();
+            findHexDataOffsetValues(binaryPath, binary.patterns[0]);
+        });
+        measure("findHexDataOffsets grouped x16" + suffix, [&]() {
+            forgetHexResults();
+            findHexDataOffsets(binaryPath, scaled);
+        });
+    }
+    HEX_SCAN_THREADS = 1;
+
+    // N edits as N single-edit calls, then as one batch; clustered edits share writes
+    const std::string scratchPath = "sdmc:/bench/scratch.bin";
+    writeBinary(scratchPath, binary.bytes);
+    fileBytes = 0;
+    BinaryRandom editRandom(spec.seed);
+    for (const size_t count : {1, 16, 256}) {
+        std::vector<HexEdit> scattered, clustered;
+        for (size_t e = 0; e < count; ++e) {
+            HexEdit edit;
+            edit.offset = editRandom.below(static_cast<uint32_t>(binary.bytes.size() - PATTERN_LENGTH));
+            edit.bytes.assign(PATTERN_LENGTH, static_cast<unsigned char>(e));
+            scattered.push_back(edit);
+            edit.offset = binary.bytes.size() / 2 + e * 2 * PATTERN_LENGTH;
+            clustered.push_back(std::move(edit));
+        }
+        std::vector<std::pair<std::string, std::string>> singleCalls;
+        for (const HexEdit& edit : scattered) {
+            singleCalls.emplace_back(std::to_string(edit.offset), toHex(edit.bytes.data(), edit.bytes.size()));
+        }
+
+        const std::string suffix = " x" + std::to_string(count);
+        measure("hexEditByOffset" + suffix + " (scattered)", [&]() {
+            for (const auto& [offset, hex] : singleCalls) hexEditByOffset(scratchPath, offset, hex);
+        });
+        HexEditResult scatteredResult, clusteredResult;
+        measure("applyHexEdits" + suffix + " (scattered)", [&]() {
+            scatteredResult = applyHexEdits(scratchPath, scattered);
+        });
+        measure("applyHexEdits" + suffix + " (clustered)", [&]() {
+            clusteredResult = applyHexEdits(scratchPath, clustered);
+        });
+        printf("  writes per batch: %zu scattered, %zu clustered\n", scatteredResult.writes, clusteredResult.writes);
+
+        // The same batch journaled, then journaled and rolled back
+        measure("applyHexEdits" + suffix + " (scattered, journal)", [&]() {
+            applyHexEdits(scratchPath, scattered, true);
+        });
+        bool reverted = true;
+        measure("applyHexEdits+revertHexEdits" + suffix, [&]() {
+            applyHexEdits(scratchPath, scattered, true);
+            reverted = revertHexEdits(scratchPath) && reverted;
+        });
+        if (!reverted) printf("  revertHexEdits failed\n");
+    }
+    fileBytes = binary.bytes.size();
+
+    HEX_SCAN_THREADS = scanThreads;
+    return 0;
+}
@@ -0,0 +1,310 @@
+/********************************************************************************
+ * File: hex_search_test.cpp
+ * Author: ppkantorski
+ * Description:
+ *   Differential test for the hex search engine of libultra. Randomized
+ *   buffers and files are searched with HexSearcher, HexMaskedSearcher and
+ *   findHexDataOffsets, and every result is checked against a naive
+ *   byte-by-byte reference. Small alphabets produce dense, overlapping hits,
+ *   and planted patterns straddle every read-chunk boundary and, with four
+ *   scan workers, every 4 MiB segment boundary.
+ *
+ *   Build from the repository root. Mapped reads are disabled so files go
+ *   through the HEX_BUFFER_SIZE chunk loop that the console uses:
+ *     g++ -std=c++20 -O2 -include memory -DUSING_MMAP_DIRECTIVE=0 -Ilibultra/include \
+ *         bench/hex_search_test.cpp \
+ *         libultra/source/{hex_funcs,path_funcs,get_funcs,string_funcs,debug_funcs,global_vars}.cpp \
+ *         -lpthread -o hex_search_test
+ *
+ *   On x86-64 this checks the SSE2 paths; add -U__SSE2__ to check the portable
+ *   ones. Build with an aarch64 toolchain (e.g. aarch64-linux-gnu-g++ -static,
+ *   run under qemu-aarch64) to check the NEON paths. Run it from a scratch
+ *   directory; files are written under ./sdmc:/hex_test/.
+ *     ./hex_search_test [seed]
+ *
+ *   For the latest updates and contributions, visit the project's GitHub repository.
+ *   (GitHub Repository: https://github.com/ppkantorski/Ultrahand-Overlay)
+ *
+ *   Note: Please be aware that this notice cannot be altered or removed. It is a part
+ *   of the project's documentation and must remain intact.
+ *
+ *  Licensed under both GPLv2 and CC-BY-4.0
+ *  Copyright (c) 2024 ppkantorski
+ ********************************************************************************/
+
+#include <hex_funcs.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <utime.h>
+
+namespace ult {
+    // Normally defined by download_funcs.cpp, which needs curl and zlib
+    std::atomic<int> downloadPercentage(-1);
+    std::atomic<int> unzipPercentage(-1);
+}
+
+namespace {
+    using namespace ult;
+
+    struct TestRandom {
+        uint32_t state;
+        explicit TestRandom(uint32_t seed) : state(seed ? seed : 1) {}
+        uint32_t next() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+        uint32_t below(uint32_t bound) { return bound ? next() % bound : 0; }
+    };
+
+    size_t cases = 0;
+    size_t failures = 0;
+
+    void check(bool passed, const char* what, size_t detail) {
+        ++cases;
+        if (!passed && failures++ < 10) {
+            printf("FAIL %s (%zu)\n", what, detail);
+        }
+    }
+
+    // Bytes drawn from a small alphabet so patterns recur and overlap
+    std::vector<unsigned char> randomBytes(TestRandom& random, size_t length) {
+        static constexpr unsigned char ALPHABETS[][4] = {
+            {0x00, 0x00, 0x00, 0xFF},  // Horspool territory
+            {0x41, 0x41, 0x42, 0x00},  // Runs of one byte
+            {0x4D, 0x4F, 0x44, 0x30},  // "MOD0"
+            {0x12, 0x34, 0xFF, 0x7F},
+        };
+        const bool full = random.below(4) == 0;
+        const unsigned char* alphabet = ALPHABETS[random.below(4)];
+        std::vector<unsigned char> bytes(length);
+        for (unsigned char& b : bytes) {
+            b = full ? static_cast<unsigned char>(random.next()) : alphabet[random.below(4)];
+        }
+        return bytes;
+    }
+
+    std::vector<unsigned char> randomPattern(TestRandom& random, const std::vector<unsigned char>& data, size_t length) {
+        // Usually a slice of the data, so there is at least one hit
+        if (data.size() >= length && random.below(4) != 0) {
+            const size_t at = random.below(static_cast<uint32_t>(data.size() - length + 1));
+            return std::vector<unsigned char>(data.begin() + at, data.begin() + at + length);
+        }
+        return randomBytes(random, length);
+    }
+
+    std::vector<uint64_t> naiveFind(const std::vector<unsigned char>& data, const std::vector<unsigned char>& pattern) {
+        std::vector<uint64_t> hits;
+        for (size_t i = 0; pattern.size() <= data.size() && i <= data.size() - pattern.size(); ++i) {
+            if (std::equal(pattern.begin(), pattern.end(), data.begin() + i)) hits.push_back(i);
+        }
+        return hits;
+    }
+
+    std::vector<uint64_t> searcherFind(const HexSearcher& searcher, const std::vector<unsigned char>& data) {
+        std::vector<uint64_t> hits;
+        for (size_t at = searcher.find(data.data(), data.size()); at != std::string::npos;
+             at = searcher.find(data.data(), data.size(), at + 1)) {
+            hits.push_back(at);
+        }
+        return hits;
+    }
+
+    std::string toHex(const std::vector<unsigned char>& bytes) {
+        static constexpr char DIGITS[] = "0123456789ABCDEF";
+        std::string hex;
+        for (unsigned char b : bytes) {
+            hex += DIGITS[b >> 4];
+            hex += DIGITS[b & 0x0F];
+        }
+        return hex;
+    }
+
+    // In-memory searches, unaligned starts and every tail length the 16-byte loops can leave
+    void testSearchers(TestRandom& random) {
+        for (int round = 0; round < 20000; ++round) {
+            const size_t length = random.below(300);
+            const size_t slack = random.below(16);  // Misaligns data relative to the allocation
+            std::vector<unsigned char> storage = randomBytes(random, length + slack);
+            const std::vector<unsigned char> data(storage.begin() + slack, storage.end());
+            const size_t patternLength = 1 + random.below(40);
+            const std::vector<unsigned char> pattern = randomPattern(random, data, patternLength);
+
+            const HexSearcher searcher(pattern);
+            check(searcherFind(searcher, data) == naiveFind(data, pattern), "HexSearcher", round);
+
+            // The same pattern with some nibbles masked out
+            std::string masked = toHex(pattern);
+            std::vector<unsigned char> maskBits(pattern.size(), 0xFF);
+            for (size_t i = 0; i < masked.size(); ++i) {
+                if (random.below(6) == 0) {
+                    masked[i] = '?';
+                    maskBits[i / 2] &= (i % 2) ? 0xF0 : 0x0F;
+                }
+            }
+            const HexMaskedSearcher maskedSearcher(masked);
+            std::vector<uint64_t> expected;
+            for (size_t i = 0; pattern.size() <= data.size() && i <= data.size() - pattern.size(); ++i) {
+                bool equal = true;
+                for (size_t j = 0; j < pattern.size() && equal; ++j) {
+                    equal = (data[i + j] & maskBits[j]) == (pattern[j] & maskBits[j]);
+                }
+                if (equal) expected.push_back(i);
+            }
+            std::vector<uint64_t> found;
+            for (size_t at = maskedSearcher.find(data.data(), data.size()); at != std::string::npos;
+                 at = maskedSearcher.find(data.data(), data.size(), at + 1)) {
+                found.push_back(at);
+            }
+            check(found == expected, "HexMaskedSearcher", round);
+        }
+    }
+
+    // File searches with chunk sizes 1-64 and 4 KiB, patterns planted across chunk boundaries
+    void testFiles(TestRandom& random) {
+        const std::string path = "sdmc:/hex_test/data.bin";
+        std::vector<size_t> chunkSizes;
+        for (size_t size = 1; size <= 64; ++size) chunkSizes.push_back(size);
+        chunkSizes.push_back(4096);
+
+        for (size_t chunkSize : chunkSizes) {
+            HEX_BUFFER_SIZE = chunkSize;
+            for (int round = 0; round < 12; ++round) {
+                const size_t length = (chunkSize == 4096 ? 4 * chunkSize : 40 * chunkSize) + random.below(64);
+                std::vector<unsigned char> data = randomBytes(random, length);
+                const size_t patternLength = 1 + random.below(24);
+                const std::vector<unsigned char> pattern = randomPattern(random, data, patternLength);
+
+                // Plant copies that straddle chunk boundaries by every offset up to the pattern length
+                for (size_t boundary = chunkSize; boundary < length; boundary += chunkSize * (1 + random.below(3))) {
+                    const size_t back = random.below(static_cast<uint32_t>(patternLength));
+                    if (boundary >= back && boundary - back + patternLength <= length) {
+                        std::copy(pattern.begin(), pattern.end(), data.begin() + (boundary - back));
+                    }
+                }
+
+                if (FILE* file = fopen(path.c_str(), "wb")) {
+                    fwrite(data.data(), 1, data.size(), file);
+                    fclose(file);
+                }
+                clearHexOffsetIndex();
+
+                const std::vector<uint64_t> expected = naiveFind(data, pattern);
+                const std::string hex = toHex(pattern);
+                check(findHexDataOffsetValues(path, hex) == expected, "findHexDataOffsetValues", chunkSize);
+
+                const size_t limit = 1 + random.below(4);
+                const std::vector<uint64_t> firstHits(expected.begin(), expected.begin() + std::min(limit, expected.size()));
+                clearHexOffsetIndex();
+                check(findHexDataOffsetValues(path, hex, limit) == firstHits, "findHexDataOffsetValues maxCount", chunkSize);
+
+                // A second pattern through the single-pass multi-pattern scanner
+                const std::vector<unsigned char> other = randomPattern(random, data, 1 + random.below(12));
+                clearHexOffsetIndex();
+                const auto multi = findHexDataOffsets(path, std::vector<std::string>{hex, toHex(other)});
+                const std::vector<uint64_t> otherExpected = naiveFind(data, other);
+                bool same = multi.size() == 2 && multi[0].size() == expected.size() && multi[1].size() == otherExpected.size();
+                for (size_t i = 0; same && i < expected.size(); ++i) same = multi[0][i] == std::to_string(expected[i]);
+                for (size_t i = 0; same && i < otherExpected.size(); ++i) same = multi[1][i] == std::to_string(otherExpected[i]);
+                check(same, "findHexDataOffsets (multi)", chunkSize);
+            }
+        }
+    }
+
+    // Multi-worker scans: patterns planted across the 4 MiB segment boundaries of 8-16 MiB files
+    void testParallel(TestRandom& random) {
+        const std::string path = "sdmc:/hex_test/parallel.bin";
+        constexpr size_t SEGMENT = 4 << 20;
+        HEX_BUFFER_SIZE = 4096;
+        HEX_SCAN_THREADS = 4;
+
+        for (int round = 0; round < 4; ++round) {
+            const size_t length = 2 * SEGMENT + random.below(2 * SEGMENT);
+            std::vector<unsigned char> data(length);
+            for (unsigned char& b : data) b = static_cast<unsigned char>(random.next());
+
+            std::vector<std::vector<unsigned char>> patterns;
+            std::vector<std::string> hexPatterns;
+            for (size_t p = 0; p < 3; ++p) {
+                const size_t patternLength = 2 + random.below(23);
+                std::vector<unsigned char> pattern(patternLength);
+                for (unsigned char& b : pattern) b = static_cast<unsigned char>(random.next());
+                for (size_t boundary = SEGMENT; boundary < length; boundary += SEGMENT) {
+                    const size_t back = 1 + random.below(static_cast<uint32_t>(patternLength - 1));
+                    std::copy(pattern.begin(), pattern.end(), data.begin() + (boundary - back) + p * 64);
+                }
+                hexPatterns.push_back(toHex(pattern));
+                patterns.push_back(std::move(pattern));
+            }
+
+            if (FILE* file = fopen(path.c_str(), "wb")) {
+                fwrite(data.data(), 1, data.size(), file);
+                fclose(file);
+            }
+            // Stamp it outside the racy window so prefetched results are cached and indexed
+            const struct utimbuf times{1000000000, 1000000000};
+            utime(path.c_str(), &times);
+
+            std::vector<std::vector<uint64_t>> expected;
+            for (const auto& pattern : patterns) expected.push_back(naiveFind(data, pattern));
+
+            const auto sameOffsets = [&](const std::vector<std::vector<std::string>>& found) {
+                bool same = found.size() == expected.size();
+                for (size_t p = 0; same && p < expected.size(); ++p) {
+                    same = found[p].size() == expected[p].size();
+                    for (size_t i = 0; same && i < expected[p].size(); ++i) same = found[p][i] == std::to_string(expected[p][i]);
+                }
+                return same;
+            };
+
+            clearHexOffsetIndex();
+            for (size_t p = 0; p < patterns.size(); ++p) {
+                check(findHexDataOffsetValues(path, hexPatterns[p]) == expected[p], "parallel findHexDataOffsetValues", length);
+            }
+            clearHexOffsetIndex();
+            check(sameOffsets(findHexDataOffsets(path, hexPatterns)), "parallel findHexDataOffsets (multi)", length);
+
+            // Prefetched results must be whole, both in memory and from the on-disk index
+            clearHexOffsetIndex();
+            prefetchHexDataOffsets(path, hexPatterns);
+            HEX_SCAN_THREADS = 1;
+            for (size_t p = 0; p < patterns.size(); ++p) {
+                check(findHexDataOffsetValues(path, hexPatterns[p]) == expected[p], "prefetch (memory)", length);
+            }
+            clearHexSumCache();
+            for (size_t p = 0; p < patterns.size(); ++p) {
+                check(findHexDataOffsetValues(path, hexPatterns[p]) == expected[p], "prefetch (index)", length);
+            }
+            HEX_SCAN_THREADS = 4;
+        }
+        HEX_SCAN_THREADS = 1;
+        clearHexOffsetIndex();
+        remove(path.c_str());
+    }
+}
+
+int main(int argc, char** argv) {
+    const uint32_t seed = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 1;
+    TestRandom random(seed);
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    const char* simd = "NEON";
+#elif defined(__SSE2__) || defined(_M_X64)
+    const char* simd = "SSE2";
+#else
+    const char* simd = "portable";
+#endif
+    printf("hex search differential test, seed %u, %s paths\n", seed, simd);
+
+    mkdir("sdmc:", 0777);  // createDirectory starts below the volume root
+    createDirectory("sdmc:/hex_test/");
+
+    testSearchers(random);
+    testFiles(random);
+    testParallel(random);
+
+    printf("%zu cases, %zu failures\n", cases, failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,399 @@
+/********************************************************************************
+ * File: ini_bench.cpp
+ * Author: ppkantorski
+ * Description:
+ *   Host benchmark for the INI layer of libultra. A deterministic corpus
+ *   generator writes an INI file of configurable shape, and every INI entry
+ *   point is timed against it, reporting ops/sec, heap allocations and the
+ *   bytes each call reads and writes (from getIniIoStats).
+ *
+ *   Build from the repository root on Linux or macOS:
+ *     g++ -std=c++20 -O2 -include memory -Ilibultra/include bench/ini_bench.cpp \
+ *         libultra/source/{ini_funcs,path_funcs,get_funcs,string_funcs,debug_funcs,global_vars}.cpp \
+ *         -lpthread -o ini_bench
+ *
+ *   Run it from a scratch directory. libultra roots every path at "sdmc:/", so
+ *   the corpus is written under ./sdmc:/bench/.
+ *     ./ini_bench [sections] [keys per section] [value length] [comment %] [seed]
+ *
+ *   For the latest updates and contributions, visit the project's GitHub repository.
+ *   (GitHub Repository: https://github.com/ppkantorski/Ultrahand-Overlay)
+ *
+ *   Note: Please be aware that this notice cannot be altered or removed. It is a part
+ *   of the project's documentation and must remain intact.
+ *
+ *  Licensed under both GPLv2 and CC-BY-4.0
+ *  Copyright (c) 2024 ppkantorski
+ ********************************************************************************/
+
+#include <ini_funcs.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <utime.h>
+
+namespace ult {
+    // Normally defined by download_funcs.cpp, which needs curl and zlib
+    std::atomic<int> downloadPercentage(-1);
+    std::atomic<int> unzipPercentage(-1);
+}
+
+namespace {
+    std::atomic<size_t> allocationCount{0};
+    std::atomic<size_t> allocationBytes{0};
+    volatile size_t benchSink = 0;  // Keeps pure lookups from being optimized away
+}
+
+// Every heap allocation made by the process is counted
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* block = std::malloc(size ? size : 1)) return block;
+    throw std::bad_alloc();
+}
+void operator delete(void* block) noexcept { std::free(block); }
+void operator delete(void* block, size_t) noexcept { std::free(block); }
+
+namespace {
+    using namespace ult;
+
+    struct CorpusSpec {
+        size_t sections = 50;
+        size_t keysPerSection = 20;
+        size_t valueLength = 16;       // Mean; each value is 50-150% of this
+        unsigned commentPercent = 20;  // Share of lines that are comments or blank
+        uint32_t seed = 1;
+    };
+
+    // xorshift32, so a seed gives the same corpus with any standard library
+    struct CorpusRandom {
+        uint32_t state;
+        explicit CorpusRandom(uint32_t seed) : state(seed ? seed : 1) {}
+        uint32_t next() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+        uint32_t below(uint32_t bound) { return bound ? next() % bound : 0; }
+    };
+
+    std::string generateCorpus(const CorpusSpec& spec) {
+        static constexpr char VALUE_CHARS[] = "abcdefghijklmnopqrstuvwxyz0123456789_-./";
+        CorpusRandom random(spec.seed);
+        std::string corpus;
+        const auto addNoise = [&]() {
+            while (random.below(100) < spec.commentPercent) {
+                switch (random.below(3)) {
+                    case 0: corpus += "; generated comment " + std::to_string(random.next()) + '\n'; break;
+                    case 1: corpus += "# generated comment\n"; break;
+                    default: corpus += '\n'; break;
+                }
+            }
+        };
+
+        for (size_t s = 0; s < spec.sections; ++s) {
+            addNoise();
+            corpus += "[section_" + std::to_string(s) + "]\n";
+            for (size_t k = 0; k < spec.keysPerSection; ++k) {
+                addNoise();
+                corpus += "key_" + std::to_string(k);
+                corpus += random.below(2) ? "=" : " = ";
+                const size_t length = spec.valueLength / 2 + random.below(static_cast<uint32_t>(spec.valueLength + 1));
+                for (size_t c = 0; c < length; ++c) {
+                    corpus += VALUE_CHARS[random.below(sizeof(VALUE_CHARS) - 1)];
+                }
+                corpus += '\n';
+            }
+        }
+        return corpus;
+    }
+
+    void writeCorpus(const std::string& path, const std::string& corpus) {
+        if (FILE* file = fopen(path.c_str(), "wb")) {
+            fwrite(corpus.data(), 1, corpus.size(), file);
+            fclose(file);
+        }
+        // Stamp it well outside the racy window so the caches may keep it
+        const struct utimbuf times{1000000000, 1000000000};
+        utime(path.c_str(), &times);
+    }
+
+    // A package.ini with a comment header and `options` sections of commands
+    std::string generatePackage(CorpusRandom& random, size_t index, size_t options) {
+        std::string package = ";title=Package " + std::to_string(index) + "\n"
+                              ";version=1." + std::to_string(random.below(100)) + "\n"
+                              ";creator=ini_bench\n"
+                              ";about=Generated package " + std::to_string(random.next()) + "\n\n";
+        for (size_t o = 0; o < options; ++o) {
+            const std::string option = std::to_string(o);
+            package += "[Option " + option + "]\n";
+            if (random.below(2)) package += ";mode=toggle\n";
+            package += "copy '/switch/.packages/bench/option_" + option + ".ovl' '/switch/.overlays/'\n";
+            package += "set-ini-val '/config/ultrahand/config.ini' 'ultrahand' 'key_" + std::to_string(random.below(50)) + "' '" + std::to_string(random.next()) + "'\n";
+            package += "delete \"/atmosphere/contents/0100000000001000/flags/boot2 " + option + ".flag\"\n";
+        }
+        return package;
+    }
+
+    // Writes `count` packages as <directory>/package_N/package.ini and returns their paths
+    std::vector<std::string> writePackages(const std::string& directory, size_t count, size_t options, uint32_t seed) {
+        CorpusRandom random(seed);
+        std::vector<std::string> paths;
+        paths.reserve(count);
+        for (size_t p = 0; p < count; ++p) {
+            const std::string packageDirectory = directory + "package_" + std::to_string(p) + "/";
+            createDirectory(packageDirectory);
+            paths.push_back(packageDirectory + PACKAGE_FILENAME);
+            writeCorpus(paths.back(), generatePackage(random, p, options));
+        }
+        return paths;
+    }
+
+    template <typename Operation>
+    void measure(const char* name, Operation&& operation) {
+        operation();  // Warm-up, not counted
+
+        using Clock = std::chrono::steady_clock;
+        const auto minimum = std::chrono::milliseconds(500);
+        const size_t allocationsBefore = allocationCount.load();
+        const size_t allocatedBefore = allocationBytes.load();
+        resetIniIoStats();
+        resetIniWriteStats();
+
+        size_t iterations = 0;
+        const auto start = Clock::now();
+        auto elapsed = Clock::duration::zero();
+        do {
+            operation();
+            ++iterations;
+            elapsed = Clock::now() - start;
+        } while (elapsed < minimum);
+
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        const IniIoStats io = getIniIoStats();
+        const double n = static_cast<double>(iterations);
+        printf("%-34s %12.0f ops/s %9.1f allocs %10.0f B alloc %10.0f B read %10.0f B written\n",
+               name, n / seconds,
+               static_cast<double>(allocationCount.load() - allocationsBefore) / n,
+               static_cast<double>(allocationBytes.load() - allocatedBefore) / n,
+               static_cast<double>(io.bytesRead) / n,
+               static_cast<double>(io.bytesWritten) / n);
+    }
+}
+
+int main(int argc, char** argv) {
+    CorpusSpec spec;
+    if (argc > 1) spec.sections = std::strtoul(argv[1], nullptr, 10);
+    if (argc > 2) spec.keysPerSection = std::strtoul(argv[2], nullptr, 10);
+    if (argc > 3) spec.valueLength = std::strtoul(argv[3], nullptr, 10);
+    if (argc > 4) spec.commentPercent = static_cast<unsigned>(std::strtoul(argv[4], nullptr, 10));
+    if (argc > 5) spec.seed = static_cast<uint32_t>(std::strtoul(argv[5], nullptr, 10));
+    if (spec.sections == 0 || spec.keysPerSection == 0) {
+        fprintf(stderr, "usage: %s [sections] [keys per section] [value length] [comment %%] [seed]\n", argv[0]);
+        return 1;
+    }
+
+    mkdir("sdmc:", 0777);  // createDirectory starts below the volume root
+    createDirectory("sdmc:/bench/");
+    const std::string corpusPath = "sdmc:/bench/corpus.ini";
+    const std::string scratchPath = "sdmc:/bench/scratch.ini";
+    const std::string corpus = generateCorpus(spec);
+    writeCorpus(corpusPath, corpus);
+
+    printf("corpus: %zu sections x %zu keys, ~%zu B values, %u%% comments, seed %u -> %zu B\n"
+           "INI_CACHE_BUDGET %zu B\n\n",
+           spec.sections, spec.keysPerSection, spec.valueLength, spec.commentPercent, spec.seed,
+           corpus.size(), INI_CACHE_BUDGET);
+
+    const std::string lastSection = "section_" + std::to_string(spec.sections - 1);
+    const std::string lastKey = "key_" + std::to_string(spec.keysPerSection - 1);
+
+    measure("parseIni", [&]() {
+        parseIni(corpus);
+    });
+    measure("getParsedDataFromIniFile (cold)", [&]() {
+        clearIniCache();
+        getParsedDataFromIniFile(corpusPath);
+    });
+    measure("getParsedDataFromIniFile (cached)", [&]() {
+        getParsedDataFromIniFile(corpusPath);
+    });
+    measure("getFlatIniDataFromIniFile (cold)", [&]() {
+        clearIniCache();
+        getFlatIniDataFromIniFile(corpusPath);
+    });
+    measure("getFlatIniDataFromIniFile (cached)", [&]() {
+        getFlatIniDataFromIniFile(corpusPath);
+    });
+
+    // Map form against flat form on data already in memory
+    const auto mapForm = parseIni(corpus);
+    const auto flatForm = getFlatIniDataFromIniFile(corpusPath);
+    measure("FlatIniData::parse", [&]() {
+        FlatIniData::parse(corpus);  // Includes one copy of the corpus
+    });
+    measure("walk every value (map)", [&]() {
+        size_t bytes = 0;
+        for (const auto& section : mapForm) {
+            for (const auto& pair : section.second) bytes += pair.second.size();
+        }
+        benchSink = bytes;
+    });
+    measure("walk every value (flat)", [&]() {
+        size_t bytes = 0;
+        flatForm->forEachSection([&](std::string_view sectionName) {
+            flatForm->forEachPair(sectionName, [&](std::string_view, std::string_view value) { bytes += value.size(); });
+        });
+        benchSink = bytes;
+    });
+    measure("find last key (map)", [&]() {
+        const auto sectionIt = mapForm.find(lastSection);
+        benchSink = sectionIt->second.find(lastKey)->second.size();
+    });
+    measure("find last key (flat)", [&]() {
+        std::string_view value;
+        flatForm->find(lastSection, lastKey, value);
+        benchSink = value.size();
+    });
+    measure("parseValueFromIniSection (first)", [&]() {
+        parseValueFromIniSection(corpusPath, "section_0", "key_0");
+    });
+    measure("parseValueFromIniSection (last)", [&]() {
+        parseValueFromIniSection(corpusPath, lastSection, lastKey);
+    });
+    measure("getKeyValuePairsFromSection", [&]() {
+        getKeyValuePairsFromSection(corpusPath, lastSection);
+    });
+    // IniLookup holds views, so the key strings must outlive the lookups
+    std::vector<std::string> lookupKeys;
+    for (size_t k = 0; k < std::min<size_t>(spec.keysPerSection, 8); ++k) {
+        lookupKeys.push_back("key_" + std::to_string(k));
+    }
+    std::vector<IniLookup> lookups;
+    for (const std::string& key : lookupKeys) {
+        IniLookup lookup;
+        lookup.section = lastSection;
+        lookup.key = key;
+        lookups.push_back(std::move(lookup));
+    }
+    measure("lookupIniValues (8 keys)", [&]() {
+        lookupIniValues(corpusPath, lookups);
+    });
+
+    writeCorpus(scratchPath, corpus);
+    bool flip = false;
+    // N sequential edits as N single-call setters, then as one transaction.
+    // Same-length values keep the file size steady across iterations.
+    for (const size_t edits : {1, 10, 100}) {
+        const std::string count = std::to_string(edits);
+        measure(("setIniFileValue x" + count).c_str(), [&]() {
+            flip = !flip;
+            for (size_t e = 0; e < edits; ++e) {
+                setIniFileValue(scratchPath, lastSection, "key_" + std::to_string(e % spec.keysPerSection),
+                                flip ? "bench_value_a" : "bench_value_b");
+            }
+        });
+        measure(("IniTransaction x" + count).c_str(), [&]() {
+            flip = !flip;
+            IniTransaction transaction(scratchPath);
+            for (size_t e = 0; e < edits; ++e) {
+                transaction.setValue(lastSection, "key_" + std::to_string(e % spec.keysPerSection),
+                                     flip ? "bench_value_a" : "bench_value_b");
+            }
+            transaction.commit();
+        });
+    }
+    measure("cleanIniFormatting", [&]() {
+        cleanIniFormatting(scratchPath);
+    });
+
+    const auto parsed = parseIni(corpus);
+    measure("saveIniFileData", [&]() {
+        saveIniFileData(scratchPath, parsed);
+    });
+
+    // Section lookups by position in a corpus far over INI_CACHE_BUDGET, served by the section index
+    CorpusSpec largeSpec = spec;
+    largeSpec.sections = 4000;
+    largeSpec.keysPerSection = 32;
+    const std::string largePath = "sdmc:/bench/large.ini";
+    const std::string largeCorpus = generateCorpus(largeSpec);
+    writeCorpus(largePath, largeCorpus);
+    printf("  large corpus: %zu sections x %zu keys -> %zu B\n", largeSpec.sections, largeSpec.keysPerSection, largeCorpus.size());
+    const std::pair<const char*, size_t> positions[] = {
+        {"first", 0}, {"middle", largeSpec.sections / 2}, {"last", largeSpec.sections - 1}
+    };
+    for (const auto& [position, index] : positions) {
+        const std::string section = "section_" + std::to_string(index);
+        measure(("large getKeyValuePairs (" + std::string(position) + ")").c_str(), [&]() {
+            getKeyValuePairsFromSection(largePath, section);
+        });
+        measure(("large parseValue (" + std::string(position) + ")").c_str(), [&]() {
+            parseValueFromIniSection(largePath, section, "key_0");
+        });
+    }
+
+    // One same-length edit to the large corpus, patched in place and then rewritten whole
+    const std::string largeScratchPath = "sdmc:/bench/large_scratch.ini";
+    writeCorpus(largeScratchPath, largeCorpus);
+    const size_t patchMinSize = INI_PATCH_MIN_SIZE;
+    for (const bool patch : {true, false}) {
+        INI_PATCH_MIN_SIZE = patch ? patchMinSize : SIZE_MAX;
+        for (const auto& [position, index] : positions) {
+            const std::string section = "section_" + std::to_string(index);
+            measure(((patch ? "patch edit (" : "rewrite edit (") + std::string(position) + ")").c_str(), [&]() {
+                flip = !flip;
+                IniTransaction(largeScratchPath).setValue(section, "key_0", flip ? "bench_value_a" : "bench_value_b").commit();
+            });
+            const IniWriteStats writes = getIniWriteStats();
+            printf("  %zu commits, %zu patched, %.0f B written vs %.0f B full rewrite per commit\n",
+                   writes.commits, writes.patches,
+                   static_cast<double>(writes.bytesWritten) / static_cast<double>(writes.commits),
+                   static_cast<double>(writes.bytesFullRewrite) / static_cast<double>(writes.commits));
+        }
+    }
+    INI_PATCH_MIN_SIZE = patchMinSize;
+
+    // Package options: cold parses every package and writes its sidecar, warm reads the sidecars back
+    constexpr size_t OPTION_PACKAGES = 20;
+    const std::vector<std::string> packagePaths = writePackages("sdmc:/bench/packages/", OPTION_PACKAGES, 30, spec.seed);
+    measure("loadOptionsFromIni x20 (cold)", [&]() {
+        clearOptionsCache();
+        for (const std::string& path : packagePaths) loadOptionsFromIni(path);
+    });
+    measure("loadOptionsFromIni x20 (warm)", [&]() {
+        for (const std::string& path : packagePaths) loadOptionsFromIni(path);
+    });
+    const IniCacheStats optionsStats = getOptionsCacheStats();
+    printf("  options sidecar cache: %zu hits, %zu misses\n", optionsStats.hits, optionsStats.misses);
+
+    // Header sweep over 500 packages, one call per package and then the threaded directory scan
+    const std::string sweepDirectory = "sdmc:/bench/sweep/";
+    const std::vector<std::string> sweepPaths = writePackages(sweepDirectory, 500, 10, spec.seed);
+    measure("getPackageHeaderFromIni x500 (cold)", [&]() {
+        clearPackageHeaderCache();
+        for (const std::string& path : sweepPaths) getPackageHeaderFromIni(path);
+    });
+    const size_t scanThreads = PACKAGE_SCAN_THREADS;
+    for (const size_t threads : {size_t(1), scanThreads, size_t(4)}) {
+        PACKAGE_SCAN_THREADS = threads;
+        const std::string suffix = " (" + std::to_string(threads) + " threads, ";
+        measure(("header sweep x500" + suffix + "cold)").c_str(), [&]() {
+            clearPackageHeaderCache();
+            getPackageHeadersFromDirectory(sweepDirectory);
+        });
+        measure(("header sweep x500" + suffix + "warm)").c_str(), [&]() {
+            getPackageHeadersFromDirectory(sweepDirectory);
+        });
+    }
+    PACKAGE_SCAN_THREADS = scanThreads;
+
+    const std::string commandLine = "copy '/switch/.overlays/ovlmenu.ovl' \"/config/ultrahand/backup folder/\" 0x1F 'quoted value'";
+    measure("parseCommandLine", [&]() {
+        parseCommandLine(commandLine);
+    });
+    return 0;
+}
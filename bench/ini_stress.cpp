@@ -0,0 +1,209 @@
+/********************************************************************************
+ * File: ini_stress.cpp
+ * Author: ppkantorski
+ * Description:
+ *   Multi-threaded stress benchmark for the INI layer of libultra. Worker
+ *   threads pick files at random from a deterministic set of generated INI
+ *   files and read or write them concurrently. Each row reports throughput,
+ *   the per-file lock table counters (from getIniLockStats) and whether every
+ *   file still holds the last value written to it.
+ *
+ *   Build from the repository root on Linux or macOS:
+ *     g++ -std=c++20 -O2 -include memory -Ilibultra/include bench/ini_stress.cpp \
+ *         libultra/source/{ini_funcs,path_funcs,get_funcs,string_funcs,debug_funcs,global_vars}.cpp \
+ *         -lpthread -o ini_stress
+ *
+ *   Run it from a scratch directory. libultra roots every path at "sdmc:/", so
+ *   the files are written under ./sdmc:/stress/.
+ *     ./ini_stress [max threads] [files] [write %] [ops per thread] [seed]
+ *
+ *   Rows run 1, 2, 4, ... threads up to the maximum.
+ *
+ *   For the latest updates and contributions, visit the project's GitHub repository.
+ *   (GitHub Repository: https://github.com/ppkantorski/Ultrahand-Overlay)
+ *
+ *   Note: Please be aware that this notice cannot be altered or removed. It is a part
+ *   of the project's documentation and must remain intact.
+ *
+ *  Licensed under both GPLv2 and CC-BY-4.0
+ *  Copyright (c) 2024 ppkantorski
+ ********************************************************************************/
+
+#include <ini_funcs.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <utime.h>
+
+namespace ult {
+    // Normally defined by download_funcs.cpp, which needs curl and zlib
+    std::atomic<int> downloadPercentage(-1);
+    std::atomic<int> unzipPercentage(-1);
+}
+
+namespace {
+    using namespace ult;
+
+    struct StressSpec {
+        size_t maxThreads = 8;
+        size_t files = 64;
+        unsigned writePercent = 20;
+        size_t opsPerThread = 2000;
+        uint32_t seed = 1;
+    };
+
+    // xorshift32, so a seed gives the same schedule with any standard library
+    struct StressRandom {
+        uint32_t state;
+        explicit StressRandom(uint32_t seed) : state(seed ? seed : 1) {}
+        uint32_t next() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+        uint32_t below(uint32_t bound) { return bound ? next() % bound : 0; }
+    };
+
+    constexpr size_t STRESS_SECTIONS = 8;
+    constexpr size_t STRESS_KEYS = 8;
+
+    std::string stressPath(size_t file) {
+        return "sdmc:/stress/file_" + std::to_string(file) + ".ini";
+    }
+
+    // Each thread owns one key per section, so the last value it wrote can be checked
+    std::string threadKey(size_t thread) {
+        return "thread_" + std::to_string(thread);
+    }
+
+    void writeStressFiles(const StressSpec& spec) {
+        for (size_t f = 0; f < spec.files; ++f) {
+            std::string content;
+            for (size_t s = 0; s < STRESS_SECTIONS; ++s) {
+                content += "[section_" + std::to_string(s) + "]\n";
+                for (size_t k = 0; k < STRESS_KEYS; ++k) {
+                    content += "key_" + std::to_string(k) + "=value_" + std::to_string(f * 100 + k) + '\n';
+                }
+            }
+            const std::string path = stressPath(f);
+            if (FILE* file = fopen(path.c_str(), "wb")) {
+                fwrite(content.data(), 1, content.size(), file);
+                fclose(file);
+            }
+            // Stamp it well outside the racy window so the caches may keep it
+            const struct utimbuf times{1000000000, 1000000000};
+            utime(path.c_str(), &times);
+        }
+    }
+
+    struct ThreadTally {
+        size_t reads = 0;
+        size_t writes = 0;
+        // Last value this thread wrote to each file and section, empty if none
+        std::vector<std::string> lastWritten;
+    };
+
+    void runWorker(const StressSpec& spec, size_t thread, ThreadTally& tally) {
+        StressRandom random(spec.seed * 7919u + static_cast<uint32_t>(thread) + 1);
+        tally.lastWritten.assign(spec.files * STRESS_SECTIONS, std::string());
+        const std::string key = threadKey(thread);
+
+        for (size_t op = 0; op < spec.opsPerThread; ++op) {
+            const size_t file = random.below(static_cast<uint32_t>(spec.files));
+            const size_t section = random.below(STRESS_SECTIONS);
+            const std::string path = stressPath(file);
+            const std::string sectionName = "section_" + std::to_string(section);
+
+            if (random.below(100) < spec.writePercent) {
+                std::string value = "v" + std::to_string(op);
+                setIniFileValue(path, sectionName, key, value);
+                tally.lastWritten[file * STRESS_SECTIONS + section] = std::move(value);
+                ++tally.writes;
+            } else if (random.below(2)) {
+                parseValueFromIniSection(path, sectionName, "key_" + std::to_string(random.below(STRESS_KEYS)));
+                ++tally.reads;
+            } else {
+                getKeyValuePairsFromSection(path, sectionName);
+                ++tally.reads;
+            }
+        }
+    }
+
+    // Counts values that are missing or differ from what their owning thread wrote last
+    size_t countLostWrites(const StressSpec& spec, const std::vector<ThreadTally>& tallies) {
+        clearIniCache();
+        size_t lost = 0;
+        for (size_t f = 0; f < spec.files; ++f) {
+            const auto data = getParsedDataFromIniFile(stressPath(f));
+            for (size_t s = 0; s < STRESS_SECTIONS; ++s) {
+                const auto sectionIt = data.find("section_" + std::to_string(s));
+                for (size_t t = 0; t < tallies.size(); ++t) {
+                    const std::string& expected = tallies[t].lastWritten[f * STRESS_SECTIONS + s];
+                    if (expected.empty()) continue;
+                    if (sectionIt == data.end()) { ++lost; continue; }
+                    const auto keyIt = sectionIt->second.find(threadKey(t));
+                    if (keyIt == sectionIt->second.end() || keyIt->second != expected) ++lost;
+                }
+            }
+        }
+        return lost;
+    }
+
+    void runRow(const StressSpec& spec, size_t threads) {
+        writeStressFiles(spec);
+        clearIniCache();
+        clearIniMutexCache();
+        resetIniLockStats();
+
+        std::vector<ThreadTally> tallies(threads);
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+
+        using Clock = std::chrono::steady_clock;
+        const auto start = Clock::now();
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back(runWorker, std::cref(spec), t, std::ref(tallies[t]));
+        }
+        for (std::thread& worker : workers) worker.join();
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        const IniLockStats locks = getIniLockStats();
+        size_t reads = 0, writes = 0;
+        for (const ThreadTally& tally : tallies) {
+            reads += tally.reads;
+            writes += tally.writes;
+        }
+        printf("%3zu threads %10.0f ops/s %8zu reads %7zu writes %9zu acquired %8zu contended %8zu shared %6zu evicted %4zu entries %4zu lost\n",
+               threads, static_cast<double>(reads + writes) / seconds, reads, writes,
+               locks.acquisitions, locks.shardContended, locks.shared, locks.evictions, locks.entries,
+               countLostWrites(spec, tallies));
+    }
+}
+
+int main(int argc, char** argv) {
+    StressSpec spec;
+    if (argc > 1) spec.maxThreads = std::strtoul(argv[1], nullptr, 10);
+    if (argc > 2) spec.files = std::strtoul(argv[2], nullptr, 10);
+    if (argc > 3) spec.writePercent = static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10));
+    if (argc > 4) spec.opsPerThread = std::strtoul(argv[4], nullptr, 10);
+    if (argc > 5) spec.seed = static_cast<uint32_t>(std::strtoul(argv[5], nullptr, 10));
+    if (spec.maxThreads == 0 || spec.files == 0) {
+        fprintf(stderr, "usage: %s [max threads] [files] [write %%] [ops per thread] [seed]\n", argv[0]);
+        return 1;
+    }
+
+    mkdir("sdmc:", 0777);  // createDirectory starts below the volume root
+    createDirectory("sdmc:/stress/");
+
+    printf("stress: %zu files x %zu sections, %u%% writes, %zu ops per thread, seed %u\n"
+           "INI_CACHE_BUDGET %zu B\n\n",
+           spec.files, STRESS_SECTIONS, spec.writePercent, spec.opsPerThread, spec.seed, INI_CACHE_BUDGET);
+
+    for (size_t threads = 1; threads <= spec.maxThreads; threads *= 2) {
+        runRow(spec, threads);
+        if (threads < spec.maxThreads && threads * 2 > spec.maxThreads) runRow(spec, spec.maxThreads);
+    }
+    return 0;
+}
@@ -0,0 +1,288 @@
+/********************************************************************************
+ * File: path_bench.cpp
+ * Author: ppkantorski
+ * Description:
+ *   Host benchmark for the file operations of libultra. A deterministic
+ *   generator writes a directory tree of configurable shape, and the copy,
+ *   mirror and delete entry points are timed against it, reporting ops/sec,
+ *   time per call, MiB/s and files/s. Setup such as clearing the target
+ *   between runs is not timed.
+ *
+ *   Build from the repository root on Linux or macOS:
+ *     g++ -std=c++20 -O2 -include memory -Ilibultra/include bench/path_bench.cpp \
+ *         libultra/source/{path_funcs,get_funcs,string_funcs,debug_funcs,global_vars}.cpp \
+ *         -lpthread -o path_bench
+ *
+ *   Run it from a scratch directory. libultra roots every path at "sdmc:/", so
+ *   the trees are written under ./sdmc:/bench/path/, which is removed on exit.
+ *     ./path_bench [files per directory] [max file KiB] [seed] [large file MiB]
+ *
+ *   For the latest updates and contributions, visit the project's GitHub repository.
+ *   (GitHub Repository: https://github.com/ppkantorski/Ultrahand-Overlay)
+ *
+ *   Note: Please be aware that this notice cannot be altered or removed. It is a part
+ *   of the project's documentation and must remain intact.
+ *
+ *  Licensed under both GPLv2 and CC-BY-4.0
+ *  Copyright (c) 2024 ppkantorski
+ ********************************************************************************/
+
+#include <path_funcs.hpp>
+#include <get_funcs.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <utime.h>
+
+namespace ult {
+    // Normally defined by download_funcs.cpp, which needs curl and zlib
+    std::atomic<int> downloadPercentage(-1);
+    std::atomic<int> unzipPercentage(-1);
+}
+
+namespace {
+    using namespace ult;
+
+    struct TreeSpec {
+        size_t topDirectories = 4;
+        size_t subDirectories = 4;   // Per top-level directory
+        size_t filesPerDirectory = 16;
+        size_t maxFileKiB = 64;      // Each file is 1 KiB to this size
+        uint32_t seed = 1;
+        size_t largeFileMiB = 64;    // The single file copied by each CopyBackend
+    };
+
+    // xorshift32, so a seed gives the same tree with any standard library
+    struct TreeRandom {
+        uint32_t state;
+        explicit TreeRandom(uint32_t seed) : state(seed ? seed : 1) {}
+        uint32_t next() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+        uint32_t below(uint32_t bound) { return bound ? next() % bound : 0; }
+    };
+
+    struct TreeTotals {
+        size_t files = 0;
+        size_t bytes = 0;
+    };
+
+    void writeFile(const std::string& path, TreeRandom& random, size_t size) {
+        std::vector<unsigned char> bytes(size);
+        for (unsigned char& byte : bytes) byte = static_cast<unsigned char>(random.next() >> 24);
+        if (FILE* file = fopen(path.c_str(), "wb")) {
+            fwrite(bytes.data(), 1, bytes.size(), file);
+            fclose(file);
+        }
+        // Stamp it well outside the racy window so mirror state may record it
+        const struct utimbuf times{1000000000, 1000000000};
+        utime(path.c_str(), &times);
+    }
+
+    // Writes top/sub/file_N.bin under `root` (which ends in '/')
+    TreeTotals writeTree(const std::string& root, const TreeSpec& spec) {
+        TreeRandom random(spec.seed);
+        TreeTotals totals;
+        for (size_t t = 0; t < spec.topDirectories; ++t) {
+            for (size_t s = 0; s < spec.subDirectories; ++s) {
+                const std::string directory = root + "dir_" + std::to_string(t) + "/sub_" + std::to_string(s) + "/";
+                createDirectory(directory);
+                for (size_t f = 0; f < spec.filesPerDirectory; ++f) {
+                    const size_t size = (1 + random.below(static_cast<uint32_t>(spec.maxFileKiB))) << 10;
+                    writeFile(directory + "file_" + std::to_string(f) + ".bin", random, size);
+                    ++totals.files;
+                    totals.bytes += size;
+                }
+            }
+        }
+        return totals;
+    }
+
+    // Writes `depth` nested directories under `root`, each holding `files` small files
+    TreeTotals writeChain(const std::string& root, size_t depth, size_t files, uint32_t seed) {
+        TreeRandom random(seed);
+        TreeTotals totals;
+        std::string directory = root;
+        for (size_t d = 0; d < depth; ++d) {
+            directory += "level_" + std::to_string(d) + "/";
+            createDirectory(directory);
+            for (size_t f = 0; f < files; ++f) {
+                writeFile(directory + "file_" + std::to_string(f) + ".bin", random, 512);
+                ++totals.files;
+                totals.bytes += 512;
+            }
+        }
+        return totals;
+    }
+
+    /**
+     * Times `operation` until at least 500 ms have been spent in it, calling `prepare`
+     * untimed before every run. `bytes` and `files` are what one run moves.
+     */
+    template <typename Prepare, typename Operation>
+    void measure(const std::string& name, size_t bytes, size_t files, Prepare&& prepare, Operation&& operation) {
+        prepare();
+        operation();  // Warm-up, not counted
+
+        using Clock = std::chrono::steady_clock;
+        const auto minimum = std::chrono::milliseconds(500);
+        size_t iterations = 0;
+        auto elapsed = Clock::duration::zero();
+        do {
+            prepare();
+            const auto start = Clock::now();
+            operation();
+            elapsed += Clock::now() - start;
+            ++iterations;
+        } while (elapsed < minimum);
+
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        const double n = static_cast<double>(iterations);
+        printf("%-44s %9.1f ops/s %10.3f ms %9.0f MiB/s %10.0f files/s\n",
+               name.c_str(), n / seconds, seconds * 1000.0 / n,
+               static_cast<double>(bytes) * n / seconds / (1 << 20),
+               static_cast<double>(files) * n / seconds);
+    }
+}
+
+int main(int argc, char** argv) {
+    TreeSpec spec;
+    if (argc > 1) spec.filesPerDirectory = std::strtoul(argv[1], nullptr, 10);
+    if (argc > 2) spec.maxFileKiB = std::strtoul(argv[2], nullptr, 10);
+    if (argc > 3) spec.seed = static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10));
+    if (argc > 4) spec.largeFileMiB = std::strtoul(argv[4], nullptr, 10);
+    if (spec.filesPerDirectory == 0 || spec.maxFileKiB == 0 || spec.largeFileMiB == 0) {
+        fprintf(stderr, "usage: %s [files per directory] [max file KiB] [seed] [large file MiB]\n", argv[0]);
+        return 1;
+    }
+
+    mkdir("sdmc:", 0777);  // createDirectory starts below the volume root
+    const std::string benchPath = "sdmc:/bench/path/";
+    const std::string treePath = benchPath + "tree/";
+    const std::string targetPath = benchPath + "target/";
+    deleteFileOrDirectory(benchPath);
+    const TreeTotals tree = writeTree(treePath, spec);
+
+    printf("tree: %zu x %zu directories x %zu files, 1-%zu KiB, seed %u -> %zu files, %zu B\n"
+           "COPY_BUFFER_SIZE %zu B, COPY_THREADS %zu, DELETE_THREADS %zu, %u hardware threads\n\n",
+           spec.topDirectories, spec.subDirectories, spec.filesPerDirectory, spec.maxFileKiB, spec.seed,
+           tree.files, tree.bytes, COPY_BUFFER_SIZE, COPY_THREADS, DELETE_THREADS,
+           std::thread::hardware_concurrency());
+
+    const auto clearTarget = [&]() { deleteFileOrDirectory(targetPath); };
+
+    // Tree copy through the work queue, by worker count
+    const size_t copyThreads = COPY_THREADS;
+    for (const size_t threads : {size_t(1), size_t(2), size_t(4)}) {
+        COPY_THREADS = threads;
+        measure("copyFileOrDirectory tree (" + std::to_string(threads) + " threads)", tree.bytes, tree.files, clearTarget, [&]() {
+            copyFileOrDirectory(treePath, targetPath);
+        });
+    }
+    COPY_THREADS = copyThreads;
+    printf("  target holds %lld of %zu B\n", getTotalSize(targetPath), tree.bytes);
+
+    // One large file and the whole tree through each backend
+    const std::string largePath = benchPath + "large.bin";
+    const size_t largeBytes = spec.largeFileMiB << 20;
+    {
+        TreeRandom random(spec.seed);
+        writeFile(largePath, random, largeBytes);
+    }
+    const CopyBackend copyBackend = COPY_BACKEND;
+    const std::pair<const char*, CopyBackend> backends[] = {
+        {"Auto", CopyBackend::Auto},
+        {"Kernel", CopyBackend::Kernel},
+        {"DoubleBuffered", CopyBackend::DoubleBuffered},
+        {"Buffered", CopyBackend::Buffered},
+    };
+    for (const auto& [label, backend] : backends) {
+        COPY_BACKEND = backend;
+        measure("copy large file (" + std::string(label) + ")", largeBytes, 1, clearTarget, [&]() {
+            copyFileOrDirectory(largePath, targetPath + "large.bin");
+        });
+        measure("copy tree (" + std::string(label) + ")", tree.bytes, tree.files, clearTarget, [&]() {
+            copyFileOrDirectory(treePath, targetPath);
+        });
+    }
+    COPY_BACKEND = copyBackend;
+    printf("  USING_KERNEL_COPY_DIRECTIVE %d\n", USING_KERNEL_COPY_DIRECTIVE);
+
+    // Wildcard copies planned in one walk, against copying each match on its own.
+    // Matches share names, so the target ends up smaller than what was copied.
+    const std::pair<const char*, std::string> copyPatterns[] = {
+        {"directories", treePath + "dir_*/"},
+        {"files", treePath + "dir_*/sub_*/file_1*.bin"},
+    };
+    for (const auto& [label, pattern] : copyPatterns) {
+        const std::vector<std::string> matches = getFilesListByWildcards(pattern);
+        long long matchedBytes = 0;
+        for (const std::string& match : matches) matchedBytes += getTotalSize(match);
+        const size_t matchedFiles = static_cast<size_t>(std::count_if(matches.begin(), matches.end(), [](const std::string& match) {
+            return match.back() != '/';
+        }));
+        const size_t files = matchedFiles ? matchedFiles : tree.files;
+        measure("copyFileOrDirectoryByPattern " + std::string(label), static_cast<size_t>(matchedBytes), files, clearTarget, [&]() {
+            copyFileOrDirectoryByPattern(pattern, targetPath);
+        });
+        measure("copyFileOrDirectory per match " + std::string(label), static_cast<size_t>(matchedBytes), files, clearTarget, [&]() {
+            for (const std::string& match : getFilesListByWildcards(pattern)) copyFileOrDirectory(match, targetPath);
+        });
+        printf("  %zu matches, %lld B\n", matches.size(), matchedBytes);
+    }
+
+    // Delta mirror into an empty target, then again over the unchanged tree
+    const auto clearMirror = [&]() {
+        clearTarget();
+        deleteFileOrDirectory(MIRROR_STATE_PATH);
+    };
+    MirrorResult mirrored;
+    measure("mirrorFilesDelta (empty target)", tree.bytes, tree.files, clearMirror, [&]() {
+        mirrored = mirrorFilesDelta(treePath, targetPath);
+    });
+    printf("  %zu copied, %zu skipped, %zu failed\n", mirrored.copied, mirrored.skipped, mirrored.failed);
+    for (const bool compareContents : {false, true}) {
+        measure(std::string("mirrorFilesDelta unchanged") + (compareContents ? " (compare)" : ""), tree.bytes, tree.files, []() {}, [&]() {
+            mirrored = mirrorFilesDelta(treePath, targetPath, compareContents);
+        });
+        printf("  %zu copied, %zu skipped, %zu failed\n", mirrored.copied, mirrored.skipped, mirrored.failed);
+    }
+    measure("mirrorFiles copy_delta unchanged", tree.bytes, tree.files, []() {}, [&]() {
+        mirrorFiles(treePath, targetPath, "copy_delta");
+    });
+    measure("copyFileOrDirectory unchanged", tree.bytes, tree.files, []() {}, [&]() {
+        copyFileOrDirectory(treePath, targetPath);
+    });
+    deleteFileOrDirectory(MIRROR_STATE_PATH);
+
+    // Deleting a deep chain, one wide directory and the tree, by worker count
+    const std::string deletePath = benchPath + "delete/";
+    const TreeSpec treeShape = spec;
+    const std::pair<const char*, std::function<TreeTotals()>> shapes[] = {
+        {"deep", [&]() { return writeChain(deletePath, 64, 4, spec.seed); }},
+        {"wide", [&]() { return writeChain(deletePath, 1, 2048, spec.seed); }},
+        {"tree", [&]() { return writeTree(deletePath, treeShape); }},
+    };
+    const size_t deleteThreads = DELETE_THREADS;
+    for (const auto& [label, writeShape] : shapes) {
+        const TreeTotals shape = writeShape();
+        for (const size_t threads : {size_t(1), size_t(2), size_t(4)}) {
+            DELETE_THREADS = threads;
+            measure("deleteFileOrDirectory " + std::string(label) + " (" + std::to_string(threads) + " threads)",
+                    shape.bytes, shape.files, writeShape, [&]() {
+                deleteFileOrDirectory(deletePath);
+            });
+        }
+        if (isDirectory(deletePath)) printf("  %s left behind\n", deletePath.c_str());
+    }
+    DELETE_THREADS = deleteThreads;
+
+    deleteFileOrDirectory(benchPath);
+    return 0;
+}
@@ -529,14 +529,20 @@ namespace tsl {
     static Color trackBarEmptyColor = RGB888("404040");
     
     static void initializeThemeVars() {
-        auto themeData = ult::getParsedDataFromIniFile(ult::THEME_CONFIG_INI_PATH);
-        if (themeData.count(ult::THEME_STR) == 0) return;
-        
-        auto& themeSection = themeData[ult::THEME_STR];
+        // Request every known theme key in one pass (sorted, as defaultThemeSettingsMap is)
+        std::vector<ult::IniLookup> themeLookups;
+        themeLookups.reserve(ult::defaultThemeSettingsMap.size());
+        for (const auto& [key, defaultValue] : ult::defaultThemeSettingsMap) {
+            themeLookups.push_back({ult::THEME_STR, key});
+        }
+        ult::lookupIniValues(ult::THEME_CONFIG_INI_PATH, themeLookups);
+        if (themeLookups.empty() || !themeLookups.front().sectionFound) return;
         
         auto getValue = [&](const char* key) -> const std::string& {
-            auto it = themeSection.find(key);
-            return it != themeSection.end() ? it->second : ult::defaultThemeSettingsMap[key];
+            auto it = std::lower_bound(themeLookups.begin(), themeLookups.end(), std::string_view(key),
+                [](const ult::IniLookup& lookup, std::string_view name) { return lookup.key < name; });
+            if (it != themeLookups.end() && it->key == key && it->found) return it->value;
+            return ult::defaultThemeSettingsMap[key];
         };
         
         auto getColor = [&](const char* key, size_t alpha = 15) {
@@ -920,11 +926,11 @@ namespace tsl {
 
             
             /**
-             * @brief Read Tesla settings file
+             * @brief Read the raw contents of a Tesla settings file
              *
-             * @return Settings data
+             * @return File contents, or an empty string on failure
              */
-            static IniData readOverlaySettings(auto& CONFIG_FILE) {
+            static std::string readOverlaySettingsContents(auto& CONFIG_FILE) {
                 /* Open Sd card filesystem. */
                 FsFileSystem fsSdmc;
                 if (R_FAILED(fsOpenSdCardFileSystem(&fsSdmc)))
@@ -942,14 +948,32 @@ namespace tsl {
                 if (R_FAILED(fsFileGetSize(&fileConfig, &configFileSize)))
                     return {};
                 
-                /* Read and parse config file. */
+                /* Read config file. */
                 std::string configFileData(configFileSize, '\0');
                 u64 readSize;
                 Result rc = fsFileRead(&fileConfig, 0, configFileData.data(), configFileSize, FsReadOption_None, &readSize);
                 if (R_FAILED(rc) || readSize != static_cast<u64>(configFileSize))
                     return {};
                 
-                return ult::parseIni(configFileData);
+                return configFileData;
+            }
+            
+            /**
+             * @brief Read Tesla settings file
+             *
+             * @return Settings data
+             */
+            static IniData readOverlaySettings(auto& CONFIG_FILE) {
+                return ult::parseIni(readOverlaySettingsContents(CONFIG_FILE));
+            }
+            
+            /**
+             * @brief Read Tesla settings file into the flat, allocation-light form
+             *
+             * @return Settings data
+             */
+            static ult::FlatIniData readOverlaySettingsFlat(auto& CONFIG_FILE) {
+                return ult::FlatIniData::parse(readOverlaySettingsContents(CONFIG_FILE));
             }
             
             /**
@@ -12461,20 +12485,20 @@ namespace tsl {
          *
          */
         static void parseOverlaySettings() {
-            hlp::ini::IniData parsedConfig = hlp::ini::readOverlaySettings(ULTRAHAND_CONFIG_FILE);
+            ult::FlatIniData parsedConfig = hlp::ini::readOverlaySettingsFlat(ULTRAHAND_CONFIG_FILE);
             
-            u64 decodedKeys = hlp::comboStringToKeys(parsedConfig[ult::ULTRAHAND_PROJECT_NAME][ult::KEY_COMBO_STR]); // CUSTOM MODIFICATION
+            u64 decodedKeys = hlp::comboStringToKeys(parsedConfig.get(ult::ULTRAHAND_PROJECT_NAME, ult::KEY_COMBO_STR)); // CUSTOM MODIFICATION
             if (decodedKeys)
                 tsl::cfg::launchCombo = decodedKeys;
             else {
-                parsedConfig = hlp::ini::readOverlaySettings(TESLA_CONFIG_FILE);
-                decodedKeys = hlp::comboStringToKeys(parsedConfig["tesla"][ult::KEY_COMBO_STR]);
+                parsedConfig = hlp::ini::readOverlaySettingsFlat(TESLA_CONFIG_FILE);
+                decodedKeys = hlp::comboStringToKeys(parsedConfig.get("tesla", ult::KEY_COMBO_STR));
                 if (decodedKeys)
                     tsl::cfg::launchCombo = decodedKeys;
             }
             
             //#if USING_WIDGET_DIRECTIVE
-            ult::datetimeFormat = parsedConfig[ult::ULTRAHAND_PROJECT_NAME]["datetime_format"]; // read datetime_format
+            ult::datetimeFormat = parsedConfig.get(ult::ULTRAHAND_PROJECT_NAME, "datetime_format"); // read datetime_format
             ult::removeQuotes(ult::datetimeFormat);
             if (ult::datetimeFormat.empty()) {
                 ult::datetimeFormat = ult::DEFAULT_DT_FORMAT;
@@ -12484,51 +12508,51 @@ namespace tsl {
 
             std::string tempStr;
             
-            tempStr = parsedConfig[ult::ULTRAHAND_PROJECT_NAME]["hide_clock"];
+            tempStr = parsedConfig.get(ult::ULTRAHAND_PROJECT_NAME, "hide_clock");
             ult::removeQuotes(tempStr);
             ult::hideClock = tempStr != ult::FALSE_STR;
             
-            tempStr = parsedConfig[ult::ULTRAHAND_PROJECT_NAME]["hide_battery"];
+            tempStr = parsedConfig.get(ult::ULTRAHAND_PROJECT_NAME, "hide_battery");
             ult::removeQuotes(tempStr);
             ult::hideBattery = tempStr != ult::FALSE_STR;
             
-            tempStr = parsedConfig[ult::ULTRAHAND_PROJECT_NAME]["hide_pcb_temp"];
+            tempStr = parsedConfig.get(ult::ULTRAHAND_PROJECT_NAME, "hide_pcb_temp");
             ult::removeQuotes(tempStr);
             ult::hidePCBTemp = tempStr != ult::FALSE_STR;
             
-            tempStr = parsedConfig[ult::ULTRAHAND_PROJECT_NAME]["hide_soc_temp"];
+            tempStr = parsedConfig.get(ult::ULTRAHAND_PROJECT_NAME, "hide_soc_temp");
             ult::removeQuotes(tempStr);
             ult::hideSOCTemp = tempStr != ult::FALSE_STR;
             
-            tempStr = parsedConfig[ult::ULTRAHAND_PROJECT_NAME]["dynamic_widget_colors"];
+            tempStr = parsedConfig.get(ult::ULTRAHAND_PROJECT_NAME, "dynamic_widget_colors");
             ult::removeQuotes(tempStr);
             ult::dynamicWidgetColors = tempStr != ult::FALSE_STR;
             
-            tempStr = parsedConfig[ult::ULTRAHAND_PROJECT_NAME]["hide_widget_backdrop"];
+            tempStr = parsedConfig.get(ult::ULTRAHAND_PROJECT_NAME, "hide_widget_backdrop");
             ult::removeQuotes(tempStr);
             ult::hideWidgetBackdrop = tempStr != ult::FALSE_STR;
             
-            tempStr = parsedConfig[ult::ULTRAHAND_PROJECT_NAME]["center_widget_alignment"];
+            tempStr = parsedConfig.get(ult::ULTRAHAND_PROJECT_NAME, "center_widget_alignment");
             ult::removeQuotes(tempStr);
             ult::centerWidgetAlignment = tempStr != ult::FALSE_STR;
             
-            tempStr = parsedConfig[ult::ULTRAHAND_PROJECT_NAME]["extended_widget_backdrop"];
+            tempStr = parsedConfig.get(ult::ULTRAHAND_PROJECT_NAME, "extended_widget_backdrop");
             ult::removeQuotes(tempStr);
             ult::extendedWidgetBackdrop = tempStr != ult::FALSE_STR;
             
-            tempStr = parsedConfig[ult::ULTRAHAND_PROJECT_NAME]["dynamic_logo"];
+            tempStr = parsedConfig.get(ult::ULTRAHAND_PROJECT_NAME, "dynamic_logo");
             ult::removeQuotes(tempStr);
             ult::useDynamicLogo = tempStr != ult::FALSE_STR;
             
-            tempStr = parsedConfig[ult::ULTRAHAND_PROJECT_NAME]["selection_bg"];
+            tempStr = parsedConfig.get(ult::ULTRAHAND_PROJECT_NAME, "selection_bg");
             ult::removeQuotes(tempStr);
             ult::useSelectionBG = tempStr != ult::FALSE_STR;
             
-            tempStr = parsedConfig[ult::ULTRAHAND_PROJECT_NAME]["selection_text"];
+            tempStr = parsedConfig.get(ult::ULTRAHAND_PROJECT_NAME, "selection_text");
             ult::removeQuotes(tempStr);
             ult::useSelectionText = tempStr != ult::FALSE_STR;
             
-            tempStr = parsedConfig[ult::ULTRAHAND_PROJECT_NAME]["selection_value"];
+            tempStr = parsedConfig.get(ult::ULTRAHAND_PROJECT_NAME, "selection_value");
             ult::removeQuotes(tempStr);
             ult::useSelectionValue = tempStr != ult::FALSE_STR;
 
@@ -13551,6 +13575,11 @@ namespace tsl {
         if (ult::expandedMemory) {
             ult::COPY_BUFFER_SIZE = 262144;
             ult::HEX_BUFFER_SIZE = 8192;
+            ult::INI_CACHE_BUDGET = 262144;
+            ult::PACKAGE_SCAN_THREADS = 4;
+            ult::COPY_THREADS = 4;
+            ult::DELETE_THREADS = 4;
+            ult::HEX_SCAN_THREADS = ult::numThreads;
             ult::UNZIP_READ_BUFFER = 262144;
             ult::UNZIP_WRITE_BUFFER = 131072;
             ult::DOWNLOAD_READ_BUFFER = 262144/2;
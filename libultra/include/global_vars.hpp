@@ -48,6 +48,11 @@ namespace ult {
     extern const std::string FLAGS_PATH;
     extern const std::string NOTIFICATIONS_PATH;
     extern const std::string PAYLOADS_PATH;
+    extern const std::string CACHE_PATH;
+    extern const std::string OPTIONS_CACHE_PATH;
+    extern const std::string HEX_INDEX_CACHE_PATH;
+    extern const std::string HEX_JOURNAL_PATH;
+    extern const std::string MIRROR_STATE_PATH;
     extern const std::string HB_APPSTORE_JSON;
     
     // Can be overriden with APPEARANCE_OVERRIDE_PATH directive
@@ -35,14 +35,28 @@
 #include <cstring> // Added for std::memcmp
 #include <mutex>
 #include <shared_mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include <sys/stat.h>
+#include <ctime>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
 
 #include <global_vars.hpp>
 #include <debug_funcs.hpp>
 #include <string_funcs.hpp>
+#include <path_funcs.hpp>
 
 
 namespace ult {
     extern size_t HEX_BUFFER_SIZE;
+    extern size_t HEX_SCAN_THREADS;  // Workers for scans of large files; 1 scans on the calling thread
     
     
     // For improving the speed of hexing consecutively with the same file and asciiPattern.
@@ -120,20 +134,240 @@ namespace ult {
     
     
     
+    /**
+     * @brief A byte pattern prepared once and searched for in memory.
+     *
+     * The constructor picks a strategy from the pattern: memchr for single bytes,
+     * Boyer-Moore-Horspool when even the rarest pattern byte is common in binaries
+     * (0x00, 0xFF), and otherwise a filter on the two rarest pattern bytes, run
+     * 16 bytes at a time with SSE2/NEON where available and driven by memchr elsewhere.
+     */
+    class HexSearcher {
+    public:
+        enum class Strategy : uint8_t { Empty, SingleByte, RareBytes, Horspool };
+
+        explicit HexSearcher(std::vector<unsigned char> pattern);
+
+        /**
+         * @brief Finds the first match starting at or after `from`.
+         *
+         * @return Position of the match within `data`, or std::string::npos.
+         */
+        size_t find(const unsigned char* data, size_t length, size_t from = 0) const;
+
+        const std::vector<unsigned char>& bytes() const { return pattern; }
+        size_t size() const { return pattern.size(); }
+        bool empty() const { return pattern.empty(); }
+        Strategy strategy() const { return mode; }
+
+    private:
+        std::vector<unsigned char> pattern;
+        std::vector<uint32_t> skip;  // Horspool shift table, filled only for Strategy::Horspool
+        size_t rareIndex = 0;        // Position of the rarest pattern byte
+        size_t pairIndex = 0;        // Position of the next rarest byte
+        Strategy mode = Strategy::Empty;
+
+        size_t findRareBytes(const unsigned char* data, size_t length, size_t from) const;
+        size_t findHorspool(const unsigned char* data, size_t length, size_t from) const;
+    };
+
+    /**
+     * @brief Decodes a hexadecimal string into bytes.
+     *
+     * @return False if the string is empty or has an odd number of digits.
+     */
+    bool hexToBytes(const std::string& hexData, std::vector<unsigned char>& bytes);
+
+    /**
+     * @brief A hexadecimal pattern with wildcards, compiled once and searched for in memory.
+     *
+     * `?` stands for any nibble, so `48??8B?F` matches 0x48, any byte, 0x8B and any byte
+     * ending in 0xF. Candidates are filtered on the two most selective pattern bytes
+     * (16 at a time with SSE2/NEON) and then compared under the mask in full.
+     */
+    class HexMaskedSearcher {
+    public:
+        explicit HexMaskedSearcher(const std::string& hexPattern);
+
+        /**
+         * @brief Finds the first match starting at or after `from`.
+         *
+         * @return Position of the match within `data`, or std::string::npos.
+         */
+        size_t find(const unsigned char* data, size_t length, size_t from = 0) const;
+
+        /**
+         * @brief Whether the `size()` bytes at `data` match the pattern.
+         */
+        bool matches(const unsigned char* data) const;
+
+        size_t size() const { return value.size(); }
+        bool valid() const { return !value.empty(); }
+
+    private:
+        std::vector<unsigned char> value;  // Pattern bytes with wildcard bits cleared
+        std::vector<unsigned char> mask;   // 0xF0, 0x0F, 0xFF or 0x00 per byte
+        size_t rareIndex = 0;              // Most selective pattern byte
+        size_t pairIndex = 0;              // Next most selective byte
+        bool anyFixed = false;             // False when every nibble is a wildcard
+    };
+
+    /**
+     * @brief Whether a hexadecimal pattern contains `?` wildcards.
+     */
+    inline bool isMaskedHexPattern(const std::string& hexPattern) {
+        return hexPattern.find('?') != std::string::npos;
+    }
+
+    /**
+     * @brief An Aho-Corasick automaton matching several byte patterns in one pass.
+     *
+     * Bytes that appear in no pattern share one input class, so the transition table is
+     * (states x classes) rather than (states x 256). The automaton state carries across
+     * calls to scan(), which lets a file be fed chunk by chunk without overlap.
+     */
+    class HexPatternSet {
+    public:
+        explicit HexPatternSet(const std::vector<std::vector<unsigned char>>& patterns);
+
+        /**
+         * @brief Feeds `length` bytes starting at file offset `base`.
+         *
+         * Calls onMatch(patternIndex, matchOffset) for every pattern occurrence ending in this
+         * block; onMatch returns false to stop. Returns false if stopped early.
+         */
+        bool scan(const unsigned char* data, size_t length, size_t base,
+                  const std::function<bool(size_t, size_t)>& onMatch);
+
+        void reset() { state = 0; }
+        size_t size() const { return patternLengths.size(); }
+        size_t stateCount() const { return outputStart.size() - 1; }
+
+    private:
+        static constexpr uint32_t HAS_OUTPUT = 1u << 31;
+
+        uint16_t byteClass[256] = {};
+        bool leavesRoot[256] = {};   // Bytes that move the automaton off its root state
+        bool skipAtRoot = false;
+        size_t classCount = 1;
+        std::vector<uint32_t> next;          // Row offset of the target state, plus HAS_OUTPUT
+        std::vector<uint32_t> outputStart;   // Per state range into outputs
+        std::vector<uint32_t> outputs;       // Pattern indices ending at each state
+        std::vector<size_t> patternLengths;
+        uint32_t state = 0;
+    };
+
+    /**
+     * @brief Finds the offsets of several hexadecimal patterns in one pass over a file.
+     *
+     * @return One offset list per entry of hexPatterns, in the same order; invalid
+     *         patterns get an empty list. Wildcard patterns take a pass of their own.
+     */
+    std::vector<std::vector<std::string>> findHexDataOffsets(const std::string& filePath, const std::vector<std::string>& hexPatterns);
+
+    /**
+     * @brief Scans a file once for several patterns and keeps the offsets for later calls.
+     *
+     * Subsequent findHexDataOffsets calls for these patterns (and so hexEditFindReplace,
+     * hexEditByCustomOffset and parseHexDataAtCustomOffset) are answered without reading the
+     * file. Edits made through hexEditByOffset/applyHexEdits are folded in; any other change
+     * to the file's size or mtime drops the results. clearHexSumCache() forgets them for
+     * this process. Wildcard patterns are not cached.
+     */
+    void prefetchHexDataOffsets(const std::string& filePath, const std::vector<std::string>& hexPatterns);
+
+    /**
+     * @brief Deletes the on-disk offset index and the in-memory offsets.
+     *
+     * Offsets found by findHexDataOffsets (up to 4096 per pattern) and by
+     * prefetchHexDataOffsets are saved under HEX_INDEX_CACHE_PATH, keyed by file path,
+     * size, mtime and pattern, and loaded the first time a file is searched again.
+     */
+    void clearHexOffsetIndex();
+
     /**
      * @brief Finds the offsets of hexadecimal data in a file.
      *
      * This function searches for occurrences of hexadecimal data in a binary file
-     * and returns the file offsets where the data is found.
+     * and returns the file offsets where the data is found. Overlapping matches and
+     * matches spanning read chunks are reported. `?` matches any nibble (see HexMaskedSearcher).
      *
      * @param filePath The path to the binary file.
      * @param hexData The hexadecimal data to search for.
      * @return A vector of strings containing the file offsets where the data is found.
      */
     std::vector<std::string> findHexDataOffsets(const std::string& filePath, const std::string& hexData);
+
+    /**
+     * @brief Calls onOffset for each match of a hexadecimal pattern in a file, in ascending order.
+     *
+     * onOffset returns false to stop the search. Only a search that runs to the end of the
+     * file is recorded in the offset index. Passing the most offsets onOffset will accept as
+     * maxMatches lets a parallel scan (HEX_SCAN_THREADS) stop each segment early.
+     *
+     * @return False if the pattern is invalid or the file cannot be read.
+     */
+    bool forEachHexDataOffset(const std::string& filePath, const std::string& hexData, const std::function<bool(uint64_t)>& onOffset,
+                              size_t maxMatches = 0);
+
+    /**
+     * @brief Finds the offsets of hexadecimal data in a file, stopping after maxCount (0 for all).
+     */
+    std::vector<uint64_t> findHexDataOffsetValues(const std::string& filePath, const std::string& hexData, size_t maxCount = 0);
+
+    /**
+     * @brief Finds the offset of the occurrence-th match (0-based), scanning no further.
+     *
+     * @return False if there are not that many matches.
+     */
+    bool findNthHexDataOffset(const std::string& filePath, const std::string& hexData, size_t occurrence, uint64_t& offset);
+
+    /**
+     * @brief Finds the offsets of a precompiled wildcard pattern in a file.
+     */
+    std::vector<std::string> findHexDataOffsets(const std::string& filePath, const HexMaskedSearcher& searcher);
     
     
     
+    /**
+     * @brief One write of `bytes` at `offset`, for applyHexEdits.
+     */
+    struct HexEdit {
+        size_t offset = 0;
+        std::vector<unsigned char> bytes;
+    };
+
+    struct HexEditResult {
+        size_t applied = 0;
+        size_t rejected = 0;
+        size_t writes = 0;  // Write calls after coalescing
+    };
+
+    /**
+     * @brief Applies a batch of edits to a file through one handle.
+     *
+     * Edits are ordered by offset (ties keep their list order, so later edits win) and
+     * edits lying within HEX_BUFFER_SIZE of each other are merged into a single write. An edit is rejected
+     * if its byte list is empty or its offset is not inside the file.
+     *
+     * With `journal` set, the original bytes of the batch are saved under HEX_JOURNAL_PATH in one
+     * write before the file is touched, and a batch that fails part way is rolled back.
+     *
+     * @param filePath The path to the binary file.
+     * @param edits The edits to apply.
+     * @param journal Whether to record the batch for revertHexEdits.
+     * @return Counts of applied and rejected edits and of writes issued.
+     */
+    HexEditResult applyHexEdits(const std::string& filePath, std::vector<HexEdit> edits, bool journal = false);
+
+    /**
+     * @brief Restores the bytes recorded by the last journaled applyHexEdits batch on a file.
+     *
+     * @param filePath The path to the binary file.
+     * @return True if the file was restored. A journal that no longer matches the file is discarded.
+     */
+    bool revertHexEdits(const std::string& filePath);
+
     /**
      * @brief Edits hexadecimal data in a file at a specified offset.
      *
@@ -205,7 +439,24 @@ namespace ult {
     
     
     
-    std::string extractVersionFromBinary(const std::string &filePath);
+    /**
+     * @brief Which part of a binary extractVersionFromBinary scans.
+     */
+    enum class VersionScanRegion : uint8_t {
+        Whole,  // The entire file
+        Head,   // The first regionBytes bytes
+        Tail    // The last regionBytes bytes
+    };
+
+    /**
+     * @brief Extracts the first "v#.#.#" version string from a binary file.
+     *
+     * The file is streamed through a HEX_BUFFER_SIZE buffer and the scan stops at the first
+     * match. Results are cached per path and region for the file's current size and mtime.
+     *
+     * @return The version string if found; otherwise, an empty string.
+     */
+    std::string extractVersionFromBinary(const std::string &filePath, VersionScanRegion region = VersionScanRegion::Whole, size_t regionBytes = 0);
 }
 
 #endif
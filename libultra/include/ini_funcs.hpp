@@ -23,6 +23,7 @@
 
 #if !USING_FSTREAM_DIRECTIVE // For not using fstream (needs implementing)
 #include <stdio.h>
+#include <unistd.h> // For ftruncate
 #else
 #include <fstream>
 //#include "nx_fstream.hpp"
@@ -30,7 +31,9 @@
 
 #include <cstring>  // For std::string, strlen(), etc.
 #include <string>   // For std::string
+#include <string_view>
 #include <vector>   // For std::vector
+#include <deque>
 #include <map>      // For std::map
 //#include <sstream>  // For std::istringstream
 #include <algorithm> // For std::remove_if
@@ -39,6 +42,9 @@
 #include <shared_mutex>
 #include <unordered_map>
 #include <mutex>
+#include <memory>
+#include <atomic>
+#include <thread>
 
 #include "get_funcs.hpp"
 #include "path_funcs.hpp"
@@ -47,9 +53,80 @@ namespace ult {
 
     extern void clearIniMutexCache();
 
+    /**
+     * @brief Counters describing the per-file lock table.
+     *
+     * shardContended counts lookups that had to wait for their shard; shared counts
+     * lookups that joined a mutex another caller was already holding.
+     */
+    struct IniLockStats {
+        size_t acquisitions = 0;
+        size_t shardContended = 0;
+        size_t shared = 0;
+        size_t evictions = 0;
+        size_t entries = 0;
+    };
+
+    IniLockStats getIniLockStats();
+    void resetIniLockStats();
+
     extern size_t INI_BUFFER_SIZE;
     extern size_t INI_BUFFER_LARGE;
 
+    // Memory budget (in bytes) for the process-wide INI document cache
+    extern size_t INI_CACHE_BUDGET;
+
+    /**
+     * @brief Counters describing the INI document cache.
+     */
+    struct IniCacheStats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+    };
+
+    void invalidateIniCache(const std::string& filePath);
+    void clearIniCache();
+    IniCacheStats getIniCacheStats();
+    void resetIniCacheStats();
+
+    // Files at least this large are patched in place instead of rewritten through a temp file
+    extern size_t INI_PATCH_MIN_SIZE;
+
+    /**
+     * @brief Counters describing INI writes made by IniTransaction.
+     *
+     * bytesFullRewrite is what rewriting every file whole would have cost, for comparison
+     * with bytesWritten.
+     */
+    struct IniWriteStats {
+        size_t commits = 0;
+        size_t patches = 0;
+        size_t bytesWritten = 0;
+        size_t bytesFullRewrite = 0;
+    };
+
+    IniWriteStats getIniWriteStats();
+    void resetIniWriteStats();
+
+    /**
+     * @brief Counters for every file read and write made by the INI layer.
+     *
+     * Sample them around an operation to get files opened and bytes moved per call;
+     * the sidecar caches, section index and package header scanner are included.
+     */
+    struct IniIoStats {
+        size_t fileReads = 0;
+        size_t bytesRead = 0;
+        size_t fileWrites = 0;
+        size_t bytesWritten = 0;
+    };
+
+    IniIoStats getIniIoStats();
+    void resetIniIoStats();
+
     /**
      * @brief Represents a package header structure.
      *
@@ -83,13 +160,31 @@ namespace ult {
     /**
      * @brief Retrieves the package header information from an INI file.
      *
-     * This function parses an INI file and extracts the package header information.
+     * This function reads the comment header of an INI file, up to its first section,
+     * and extracts the package header information. Results are cached by mtime.
      *
      * @param filePath The path to the INI file.
      * @return The package header structure.
      */
     PackageHeader getPackageHeaderFromIni(const std::string& filePath);
     
+    // Worker threads used by getPackageHeadersFromDirectory
+    extern size_t PACKAGE_SCAN_THREADS;
+    
+    /**
+     * @brief Retrieves the package headers of every package in a directory.
+     *
+     * Each subdirectory containing a PACKAGE_FILENAME is scanned in parallel, and
+     * unchanged packages are served from the header cache.
+     *
+     * @param packageDirectory The directory holding one subdirectory per package.
+     * @return Pairs of package directory name and header, sorted by name.
+     */
+    std::vector<std::pair<std::string, PackageHeader>> getPackageHeadersFromDirectory(const std::string& packageDirectory);
+    
+    // Drops every cached package header
+    void clearPackageHeaderCache();
+    
     
     /**
      * @brief Splits a string into a vector of substrings using a specified delimiter.
@@ -115,6 +210,96 @@ namespace ult {
     std::map<std::string, std::map<std::string, std::string>> parseIni(const std::string &str);
     
     
+    /**
+     * @brief Flat, read-only parsed form of an INI document.
+     *
+     * The document bytes are kept in a single arena and every section name, key and
+     * value is stored as an offset/length span into it. Sections, and the pairs within
+     * each section, are sorted so lookups are binary searches, and parsing costs a fixed
+     * handful of allocations no matter how many keys the file holds. The string_views
+     * handed out stay valid for as long as the FlatIniData they came from.
+     *
+     * Duplicate sections are merged and the first occurrence of a key wins, matching
+     * parseIni. toMap() and sectionToMap() adapt to the nested map form for callers
+     * that still need it.
+     */
+    class FlatIniData {
+    public:
+        FlatIniData() = default;
+        
+        // Parses `contents` with the same rules as parseIni, taking ownership of the bytes
+        static FlatIniData parse(std::string contents);
+        
+        bool hasSection(std::string_view sectionName) const;
+        bool find(std::string_view sectionName, std::string_view key, std::string_view& value) const;
+        
+        // Returns the value as a string, or an empty string if the section or key is missing
+        std::string get(std::string_view sectionName, std::string_view key) const;
+        
+        size_t sectionCount() const { return sections.size(); }
+        size_t size() const { return pairs.size(); }
+        size_t headerCount() const { return headers.size(); }
+        bool empty() const { return sections.empty(); }
+        size_t memoryUsage() const;
+        
+        // Calls func(name) for every distinct section, in sorted order
+        template <typename Func>
+        void forEachSection(Func&& func) const {
+            for (const Section& section : sections) func(view(section.name));
+        }
+        
+        // Calls func(name) for every section header in file order, including duplicates
+        template <typename Func>
+        void forEachHeader(Func&& func) const {
+            for (const Span& header : headers) func(view(header));
+        }
+        
+        // Calls func(key, value) for every pair of a section in sorted key order; false if the section is missing
+        template <typename Func>
+        bool forEachPair(std::string_view sectionName, Func&& func) const {
+            const Section* section = findSection(sectionName);
+            if (!section) return false;
+            for (uint32_t i = section->firstPair, end = section->firstPair + section->pairCount; i < end; ++i) {
+                func(view(pairs[i].key), view(pairs[i].value));
+            }
+            return true;
+        }
+        
+        std::map<std::string, std::map<std::string, std::string>> toMap() const;
+        std::map<std::string, std::string> sectionToMap(std::string_view sectionName) const;
+        
+    private:
+        friend struct FlatIniBuilder;
+        
+        struct Span {
+            uint32_t offset = 0;
+            uint32_t length = 0;
+        };
+        
+        struct Section {
+            Span name;
+            uint32_t firstPair = 0;
+            uint32_t pairCount = 0;
+        };
+        
+        struct Pair {
+            Span key;
+            Span value;
+        };
+        
+        std::string_view view(const Span& span) const {
+            return std::string_view(arena.data() + span.offset, span.length);
+        }
+        
+        const Section* findSection(std::string_view sectionName) const;
+        
+        std::string arena;
+        std::vector<Section> sections;
+        std::vector<Pair> pairs;
+        std::vector<Span> headers;
+    };
+    
+    
     /**
      * @brief Parses an INI file and returns its content as a map of sections and key-value pairs.
      *
@@ -128,6 +313,19 @@ namespace ult {
     std::map<std::string, std::map<std::string, std::string>> getParsedDataFromIniFile(const std::string& configIniPath);
     
     
+    /**
+     * @brief Returns the flat parsed form of an INI file without copying it.
+     *
+     * The result is shared with the INI document cache and stays valid for as long
+     * as the pointer is held, even if the file changes afterwards. An unreadable file
+     * yields an empty document.
+     *
+     * @param configIniPath The path to the INI file to be parsed.
+     * @return A shared pointer to the parsed INI data.
+     */
+    std::shared_ptr<const FlatIniData> getFlatIniDataFromIniFile(const std::string& configIniPath);
+    
+    
     /**
      * @brief Parses an INI file and retrieves key-value pairs from a specific section.
      *
@@ -153,6 +351,33 @@ namespace ult {
     
     
     
+    /**
+     * @brief A single (section, key) request for lookupIniValues.
+     *
+     * The section and key views must stay valid until lookupIniValues returns.
+     */
+    struct IniLookup {
+        std::string_view section;
+        std::string_view key;
+        std::string value;          // Filled with the value, or cleared if not found
+        bool found = false;
+        bool sectionFound = false;
+    };
+    
+    /**
+     * @brief Looks up several values from an INI file with a single read.
+     *
+     * Duplicate sections merge and the first occurrence of a key wins, as with findIniValue.
+     * Readers that rely on a later duplicate overriding an earlier one should use
+     * getKeyValuePairsFromSection, where the last occurrence wins.
+     *
+     * @param filePath The path to the INI file.
+     * @param lookups The requests; `value`, `found` and `sectionFound` are filled in.
+     * @return The number of requests whose key was found.
+     */
+    size_t lookupIniValues(const std::string& filePath, std::vector<IniLookup>& lookups);
+    
+    
     /**
      * @brief Parses a specific value from a section and key in an INI file.
      *
@@ -164,6 +389,18 @@ namespace ult {
     std::string parseValueFromIniSection(const std::string& filePath, const std::string& sectionName, const std::string& keyName);
     
     
+    /**
+     * @brief Looks up a value from a section and key in an INI file.
+     *
+     * @param filePath The path to the INI file.
+     * @param sectionName The name of the section containing the desired key.
+     * @param keyName The name of the key whose value is to be retrieved.
+     * @param value Receives the value when the key is found.
+     * @return True if the section and key exist, false otherwise.
+     */
+    bool findIniValue(const std::string& filePath, const std::string& sectionName, const std::string& keyName, std::string& value);
+    
+    
     
     /**
      * @brief Cleans the formatting of an INI file by removing empty lines and standardizing section formatting.
@@ -271,6 +508,62 @@ namespace ult {
     void removeIniKey(const std::string& filePath, const std::string& sectionName, const std::string& keyName);
     
     
+    /**
+     * @brief Batches several edits to one INI file into a single read-modify-write.
+     *
+     * Edits are queued in memory and applied in order by commit(), which reads the file
+     * once, writes the result to "<file>.tmp" and renames it over the original. Files of
+     * at least INI_PATCH_MIN_SIZE bytes are instead patched from the first changed byte. The
+     * single-edit helpers above (setIniFile, addIniSection, ...) are one-edit transactions.
+     *
+     * Example:
+     * @code
+     * IniTransaction(configPath)
+     *     .setValue("settings", "key_a", "1")
+     *     .setValue("settings", "key_b", "2")
+     *     .removeKey("legacy", "key_c")
+     *     .commit();
+     * @endcode
+     */
+    class IniTransaction {
+    public:
+        explicit IniTransaction(const std::string& filePath);
+
+        // Sets `key` to `value` in `sectionName`, creating either if missing. A non-empty `newKey` renames the key.
+        IniTransaction& setValue(const std::string& sectionName, const std::string& key, const std::string& value, const std::string& newKey = "");
+        IniTransaction& addSection(const std::string& sectionName);
+        IniTransaction& renameSection(const std::string& sectionName, const std::string& newSectionName);
+        IniTransaction& removeSection(const std::string& sectionName);
+        IniTransaction& removeKey(const std::string& sectionName, const std::string& key);
+
+        bool commit();
+
+        size_t size() const { return edits.size(); }
+        bool empty() const { return edits.empty(); }
+        void clear() { edits.clear(); }
+
+    private:
+        enum class EditType : uint8_t {
+            SetValue,
+            AddSection,
+            RenameSection,
+            RemoveSection,
+            RemoveKey
+        };
+
+        struct Edit {
+            EditType type;
+            std::string section;
+            std::string key;
+            std::string value;
+            std::string extra;  // New key name or new section name
+        };
+
+        std::string filePath;
+        std::vector<Edit> edits;
+    };
+    
+    
     //void saveIniFileData(const std::string& filePath, const std::map<std::string, std::map<std::string, std::string>>& data) {
     //    std::ofstream file(filePath);
     //    if (!file.is_open()) {
@@ -310,12 +603,20 @@ namespace ult {
      * @brief Loads and parses options from an INI file.
      *
      * This function reads and parses options from an INI file, organizing them by section.
+     * The tokenized result is kept in a binary sidecar under OPTIONS_CACHE_PATH, keyed by
+     * the source's size, mtime and content hash, and reused until the source changes.
      *
      * @param packageIniPath The path to the INI file.
      * @return A vector containing pairs of section names and their associated key-value pairs.
      */
     std::vector<std::pair<std::string, std::vector<std::vector<std::string>>>> loadOptionsFromIni(const std::string& packageIniPath);
     
+    // Hit/miss counters of the loadOptionsFromIni sidecar cache (entries and bytes are unused)
+    IniCacheStats getOptionsCacheStats();
+    
+    // Deletes every loadOptionsFromIni sidecar file and resets the counters
+    void clearOptionsCache();
+    
     /**
      * @brief Loads a specific section from an INI file.
      *
@@ -36,17 +36,80 @@
 #include "get_funcs.hpp"
 #include <queue>
 #include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <unordered_map>
+#include <cstdint>
+#include <ctime>
+
+// Memory-mapped reads where the platform has mmap (host builds); buffered reads elsewhere
+#ifndef USING_MMAP_DIRECTIVE
+#if defined(__linux__) || defined(__APPLE__)
+#define USING_MMAP_DIRECTIVE 1
+#else
+#define USING_MMAP_DIRECTIVE 0
+#endif
+#endif
+
+#if USING_MMAP_DIRECTIVE
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// In-kernel file copies (copy_file_range, then sendfile) where the platform has them
+#ifndef USING_KERNEL_COPY_DIRECTIVE
+#if defined(__linux__)
+#define USING_KERNEL_COPY_DIRECTIVE 1
+#else
+#define USING_KERNEL_COPY_DIRECTIVE 0
+#endif
+#endif
+
+#if USING_KERNEL_COPY_DIRECTIVE
+#include <sys/sendfile.h>
+#include <unistd.h>
+#endif
 
 
 namespace ult {
     extern std::atomic<bool> abortFileOp;
     
     extern size_t COPY_BUFFER_SIZE; // Made const for thread safety
+    extern size_t COPY_THREADS;  // Concurrent small-file copies in copyFileOrDirectory
+    
+    /**
+     * @brief How file contents are moved by the copy functions.
+     *
+     * Auto tries the kernel copy where USING_KERNEL_COPY_DIRECTIVE is set, then uses the double-buffered
+     * reader/writer pair for files of 1 MiB or more and the plain read/write loop for the rest.
+     */
+    enum class CopyBackend {
+        Auto,
+        Kernel,          // copy_file_range or sendfile; falls back to Buffered where unsupported
+        DoubleBuffered,  // A reader thread fills one buffer while the caller writes the other
+        Buffered         // One buffer, read then write
+    };
+    extern CopyBackend COPY_BACKEND;
+    
+    extern size_t DELETE_THREADS;  // Concurrent unlinks in deleteFileOrDirectory
     extern std::atomic<int> copyPercentage;
     
     // Mutex for thread-safe logging operations
     extern std::mutex logMutex;
     
+    /**
+     * @brief True while a file stamped `fileTime` can still be rewritten without its mtime changing.
+     *
+     * FAT32 stores mtimes in 2 s steps, so any size/mtime-validated cache must not trust a file
+     * modified within that window of now.
+     */
+    inline bool isRacyFileTime(long long fileTime) {
+        return fileTime + 2 > static_cast<long long>(time(nullptr));
+    }
+    
     /**
      * @brief Checks if a path points to a directory.
      *
@@ -127,6 +190,7 @@ namespace ult {
      * @brief Deletes a file or directory.
      *
      * This function deletes the file or directory specified by `path`. It can delete both files and directories.
+     * Each line of `logSource` is the path of a deleted file; only directories end in '/'.
      *
      * @param path The path of the file or directory to be deleted.
      */
@@ -247,9 +311,39 @@ namespace ult {
      * @param sourcePath The path of the source directory.
      * @param targetPath The path of the target directory where files will be mirrored and deleted.
      *                   Default is "sdmc:/". You can specify a different target path if needed.
+     * @param mode "delete", "copy", or "copy_delta" to copy only files that changed since the last
+     *             "copy_delta" run; see mirrorFilesDelta for the changes it cannot detect.
      */
     void mirrorFiles(const std::string& sourcePath, const std::string targetPath, const std::string mode);
     
+    struct MirrorResult {
+        size_t copied = 0;
+        size_t skipped = 0;  // Already current in the target
+        size_t failed = 0;
+    };
+    
+    /**
+     * @brief Copies only the files of `sourcePath` whose mirror under `targetPath` is missing or out of date.
+     *
+     * A target file is current when it has the source's size and the source and target mtimes both still
+     * match what was recorded under MIRROR_STATE_PATH when it was last copied; with `compareContents`,
+     * files of equal size are compared byte for byte instead. The target paths written are saved to
+     * `manifestPath`, one per line. mirrorFiles runs this for the "copy_delta" mode.
+     *
+     * Limits: files without a record (first run, cleared cache) are copied again; sources modified
+     * within 2 s of their copy are never recorded, so they are copied again on the next run; and a
+     * same-size change that keeps both mtimes (e.g. a restore that preserves timestamps, or a target
+     * edit within 2 s of the copy) is only seen with `compareContents`.
+     *
+     * @param sourcePath The path of the source directory.
+     * @param targetPath The path of the target directory.
+     * @param compareContents Whether to compare the contents of equally sized files.
+     * @param manifestPath Optional file that receives the list of copied target files.
+     * @return Counts of copied, unchanged and failed files.
+     */
+    MirrorResult mirrorFilesDelta(const std::string& sourcePath, const std::string& targetPath,
+        bool compareContents = false, const std::string& manifestPath = "");
+    
 
     /**
      * @brief For each match of the wildcard pattern, creates an empty text file
@@ -274,6 +368,112 @@ namespace ult {
      * @param sourcePath The path of the directory to clean.
      */
     void dotCleanDirectory(const std::string& sourcePath);
+
+
+    /**
+     * @brief Read-only view of a file for whole-file binary scans.
+     *
+     * Where USING_MMAP_DIRECTIVE is set the file is mapped and ranges are handed out straight
+     * from the mapping, with sequential or random access advice given to the kernel. Otherwise,
+     * or if mapping fails, ranges are read into one reusable buffer through an unbuffered
+     * FILE* (or ifstream), so each byte is copied once.
+     */
+    class MappedFile {
+    public:
+        enum class Access : uint8_t { Sequential, Random };
+
+        explicit MappedFile(const std::string& filePath, Access access = Access::Sequential);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool isOpen() const { return opened; }
+        bool isMapped() const { return mapping != nullptr; }
+        size_t size() const { return fileSize; }
+
+        /**
+         * @brief The whole file when mapped; nullptr otherwise.
+         */
+        const unsigned char* data() const { return mapping; }
+
+        /**
+         * @brief Hands the `limit` bytes at `start` to onRange(data, length, base) in steps of `chunkSize`.
+         *
+         * Consecutive ranges share `overlap` bytes, so a caller looking for N-byte runs passes
+         * N - 1 and never misses one spanning two ranges. `base` is the file offset of data[0].
+         * Mapped files are walked in page-aligned steps of at least MAPPED_FILE_WINDOW bytes,
+         * and pages are unmapped from the process once walked past, so resident memory stays
+         * around one window. onRange returns false to stop early.
+         *
+         * @return False if the file is not open or `start` cannot be reached.
+         */
+        template <typename Callback>
+        bool forEachRange(size_t chunkSize, size_t overlap, Callback&& onRange, size_t start = 0, size_t limit = SIZE_MAX) {
+            if (!opened) return false;
+            if (start >= fileSize) return true;
+
+            const size_t end = start + std::min(limit, fileSize - start);
+            if (mapping) {
+                size_t step = std::max({chunkSize, overlap + 1, MAPPED_FILE_WINDOW});
+                step = (step + pageSize - 1) / pageSize * pageSize;
+
+                adviseRange(start, end - start);
+                for (size_t base = start; base < end; base += step) {
+                    const size_t length = std::min(step + overlap, end - base);
+                    const bool proceed = onRange(static_cast<const unsigned char*>(mapping + base), length, base);
+                    releaseRange(base, step);
+                    if (!proceed || base + length >= end) break;
+                }
+                return true;
+            }
+
+            if (!seekTo(start)) return false;
+
+            chunkSize = std::max(chunkSize, overlap + 1);
+            buffer.resize(overlap + chunkSize);
+            size_t carry = 0;
+            size_t base = start;  // File offset of buffer[0]
+            size_t remaining = end - start;
+            size_t bytesRead, available;
+
+            while (remaining > 0) {
+                bytesRead = readInto(buffer.data() + carry, std::min(chunkSize, remaining));
+                if (bytesRead == 0) break;
+                remaining -= bytesRead;
+
+                available = carry + bytesRead;
+                if (!onRange(static_cast<const unsigned char*>(buffer.data()), available, base)) break;
+
+                carry = std::min(overlap, available);
+                std::memmove(buffer.data(), buffer.data() + available - carry, carry);
+                base += available - carry;
+            }
+            return true;
+        }
+
+    private:
+        static constexpr size_t MAPPED_FILE_WINDOW = 1 << 20;
+
+        bool opened = false;
+        size_t fileSize = 0;
+        unsigned char* mapping = nullptr;
+        size_t pageSize = 4096;
+        std::vector<unsigned char> buffer;  // Reused by the buffered path
+    #if USING_MMAP_DIRECTIVE
+        int descriptor = -1;
+    #endif
+    #if !USING_FSTREAM_DIRECTIVE
+        FILE* file = nullptr;
+    #else
+        std::ifstream file;
+    #endif
+
+        void adviseRange(size_t offset, size_t length);
+        void releaseRange(size_t offset, size_t length);
+        bool seekTo(size_t offset);
+        size_t readInto(unsigned char* destination, size_t length);
+    };
 }
 
 #endif
\ No newline at end of file
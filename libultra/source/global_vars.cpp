@@ -55,6 +55,11 @@ namespace ult {
     const std::string FLAGS_PATH                  = BASE_CONFIG_PATH + "flags/";
     const std::string NOTIFICATIONS_PATH          = BASE_CONFIG_PATH + "notifications/";
     const std::string PAYLOADS_PATH               = BASE_CONFIG_PATH + "payloads/";
+    const std::string CACHE_PATH                  = BASE_CONFIG_PATH + "cache/";
+    const std::string OPTIONS_CACHE_PATH          = CACHE_PATH + "options/";
+    const std::string HEX_INDEX_CACHE_PATH        = CACHE_PATH + "hex/";
+    const std::string HEX_JOURNAL_PATH            = CACHE_PATH + "hex_journal/";
+    const std::string MIRROR_STATE_PATH           = CACHE_PATH + "mirror/";
     const std::string HB_APPSTORE_JSON            = SWITCH_PATH + "appstore/.get/packages/UltrahandOverlay/info.json";
     std::string THEME_CONFIG_INI_PATH             = BASE_CONFIG_PATH + THEME_FILENAME;
     std::string WALLPAPER_PATH                    = BASE_CONFIG_PATH + WALLPAPER_FILENAME;
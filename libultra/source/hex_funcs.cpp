@@ -22,6 +22,7 @@
 
 namespace ult {
     size_t HEX_BUFFER_SIZE = 4096;//65536/4;
+    size_t HEX_SCAN_THREADS = 1;
     
     // Thread-safe cache and file operation mutexes
     std::shared_mutex cacheMutex;  // Allows multiple readers, single writer
@@ -30,6 +31,398 @@ namespace ult {
     // For improving the speed of hexing consecutively with the same file and asciiPattern.
     std::unordered_map<std::string, std::string> hexSumCache;
     
+    namespace {
+        /**
+         * @brief Offsets recorded by findHexDataOffsets and prefetchHexDataOffsets for one file.
+         *
+         * Keys are the decoded pattern bytes; offsets are kept sorted. Entries are backed by
+         * an on-disk index under HEX_INDEX_CACHE_PATH so they survive restarts.
+         */
+        struct HexScanCacheEntry {
+            long long fileSize = 0;
+            long long fileTime = 0;
+            uint64_t lastUse = 0;
+            std::unordered_map<std::string, std::vector<size_t>> offsets;
+        };
+
+        constexpr size_t HEX_SCAN_CACHE_FILES = 4;
+        std::mutex hexScanCacheMutex;
+        std::unordered_map<std::string, HexScanCacheEntry> hexScanCache;
+        uint64_t hexScanCacheClock = 0;
+
+        // Results of extractVersionFromBinary, keyed by path and scan region
+        struct VersionCacheEntry {
+            long long fileSize = 0;
+            long long fileTime = 0;
+            std::string version;
+        };
+
+        constexpr size_t VERSION_CACHE_ENTRIES = 16;
+        std::mutex versionCacheMutex;
+        std::unordered_map<std::string, VersionCacheEntry> versionCache;
+
+        bool statHexFile(const std::string& filePath, long long& fileSize, long long& fileTime) {
+            struct stat fileStat;
+            if (stat(filePath.c_str(), &fileStat) != 0) return false;
+            fileSize = static_cast<long long>(fileStat.st_size);
+            fileTime = static_cast<long long>(fileStat.st_mtime);
+            return true;
+        }
+
+        // Reads up to `length` bytes at `offset`; returns the number read
+        size_t readHexFileRange(const std::string& filePath, size_t offset, size_t length, std::vector<unsigned char>& buffer) {
+            buffer.resize(length);
+        #if !USING_FSTREAM_DIRECTIVE
+            FILE* file = fopen(filePath.c_str(), "rb");
+            if (!file) return 0;
+            size_t bytesRead = 0;
+            if (fseek(file, static_cast<long>(offset), SEEK_SET) == 0) {
+                bytesRead = fread(buffer.data(), 1, length, file);
+            }
+            fclose(file);
+        #else
+            std::ifstream file(filePath, std::ios::binary);
+            if (!file.is_open()) return 0;
+            file.seekg(static_cast<std::streamoff>(offset));
+            file.read(reinterpret_cast<char*>(buffer.data()), length);
+            const size_t bytesRead = static_cast<size_t>(file.gcount());
+        #endif
+            buffer.resize(bytesRead);
+            return bytesRead;
+        }
+
+        constexpr uint32_t HEX_INDEX_MAGIC = 0x58484855; // "UHHX"
+        constexpr uint32_t HEX_INDEX_VERSION = 1;
+        constexpr size_t HEX_INDEX_MAX_OFFSETS = 4096;  // Patterns with more hits stay in memory only
+
+        /**
+         * @brief Header of an on-disk offset index under HEX_INDEX_CACHE_PATH.
+         *
+         * The index is valid for a file whose size and mtime match. It is followed by the
+         * file path and, per pattern, its bytes, an offset count and the 64-bit offsets.
+         */
+        struct HexIndexHeader {
+            uint32_t magic = HEX_INDEX_MAGIC;
+            uint32_t version = HEX_INDEX_VERSION;
+            uint32_t patternCount = 0;
+            uint32_t reserved = 0;
+            uint64_t sourceSize = 0;
+            int64_t sourceTime = 0;
+        };
+
+        constexpr uint32_t HEX_JOURNAL_MAGIC = 0x4A484855; // "UHHJ"
+        constexpr uint32_t HEX_JOURNAL_VERSION = 1;
+
+        /**
+         * @brief Header of an edit journal under HEX_JOURNAL_PATH.
+         *
+         * Followed, per written span, by its 64-bit offset and length and the bytes the span
+         * held before the batch (cut at originalSize for spans that grew the file).
+         */
+        struct HexJournalHeader {
+            uint32_t magic = HEX_JOURNAL_MAGIC;
+            uint32_t version = HEX_JOURNAL_VERSION;
+            uint64_t spanCount = 0;
+            uint64_t originalSize = 0;
+            uint64_t patchedSize = 0;
+        };
+
+        // Per-file name under a cache directory, from a 64-bit FNV-1a hash of the path
+        std::string getHexCacheFileName(const std::string& filePath) {
+            uint64_t hash = 0xcbf29ce484222325ULL;
+            for (unsigned char c : filePath) {
+                hash ^= c;
+                hash *= 0x100000001b3ULL;
+            }
+            char name[32];
+            snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(hash));
+            return name;
+        }
+
+        std::string getHexIndexPath(const std::string& filePath) {
+            return HEX_INDEX_CACHE_PATH + getHexCacheFileName(filePath);
+        }
+
+        std::string getHexJournalPath(const std::string& filePath) {
+            return HEX_JOURNAL_PATH + getHexCacheFileName(filePath);
+        }
+
+        /**
+         * @brief Replaces `path` (inside `directory`) with `contents` in one write through a temporary file.
+         */
+        bool writeHexCacheFile(const std::string& directory, const std::string& path, const std::string& contents) {
+            createDirectory(directory);
+            const std::string tempPath = path + ".tmp";
+        #if !USING_FSTREAM_DIRECTIVE
+            FILE* file = fopen(tempPath.c_str(), "wb");
+            if (!file) return false;
+            const bool written = fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+            const bool closed = fclose(file) == 0;
+        #else
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file) return false;
+            file.write(contents.data(), contents.size());
+            const bool written = file.good();
+            file.close();
+            const bool closed = !file.fail();
+        #endif
+            if (!written || !closed) {
+                std::remove(tempPath.c_str());
+                return false;
+            }
+
+            // POSIX rename replaces atomically; sdmc needs the target removed first
+            if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+                std::remove(path.c_str());
+                if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+                    std::remove(tempPath.c_str());
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Bounds-checked cursor over an index buffer
+        struct HexIndexReader {
+            const unsigned char* pos;
+            const unsigned char* end;
+
+            template <typename T>
+            bool read(T& value) {
+                if (static_cast<size_t>(end - pos) < sizeof(value)) return false;
+                std::memcpy(&value, pos, sizeof(value));
+                pos += sizeof(value);
+                return true;
+            }
+
+            bool readBytes(std::string& value) {
+                uint32_t length;
+                if (!read(length) || static_cast<size_t>(end - pos) < length) return false;
+                value.assign(reinterpret_cast<const char*>(pos), length);
+                pos += length;
+                return true;
+            }
+        };
+
+        /**
+         * @brief Loads the on-disk index of `filePath` into `entry` if it matches the file's
+         * current size and mtime. A stale index is deleted.
+         */
+        bool loadHexIndex(const std::string& filePath, HexScanCacheEntry& entry) {
+            const std::string indexPath = getHexIndexPath(filePath);
+            std::vector<unsigned char> buffer;
+            if (readHexFileRange(indexPath, 0, sizeof(HexIndexHeader), buffer) != sizeof(HexIndexHeader)) {
+                return false;
+            }
+
+            HexIndexHeader header;
+            std::memcpy(&header, buffer.data(), sizeof(header));
+            if (header.magic != HEX_INDEX_MAGIC || header.version != HEX_INDEX_VERSION ||
+                static_cast<long long>(header.sourceSize) != entry.fileSize || header.sourceTime != entry.fileTime) {
+                std::remove(indexPath.c_str());
+                return false;
+            }
+
+            struct stat indexStat;
+            if (stat(indexPath.c_str(), &indexStat) != 0) return false;
+            readHexFileRange(indexPath, 0, static_cast<size_t>(indexStat.st_size), buffer);
+
+            HexIndexReader reader{buffer.data() + sizeof(header), buffer.data() + buffer.size()};
+            std::string storedPath, pattern;
+            if (!reader.readBytes(storedPath) || storedPath != filePath) return false;
+
+            std::unordered_map<std::string, std::vector<size_t>> offsets;
+            uint32_t count;
+            uint64_t offset;
+            for (uint32_t i = 0; i < header.patternCount; ++i) {
+                if (!reader.readBytes(pattern) || pattern.empty() || !reader.read(count)) return false;
+                std::vector<size_t>& patternOffsets = offsets[pattern];
+                patternOffsets.reserve(count);
+                for (uint32_t j = 0; j < count; ++j) {
+                    if (!reader.read(offset)) return false;
+                    patternOffsets.push_back(static_cast<size_t>(offset));
+                }
+            }
+            if (reader.pos != reader.end) return false;
+
+            entry.offsets = std::move(offsets);
+            return true;
+        }
+
+        /**
+         * @brief Writes the persistable part of `entry` as the on-disk index of `filePath`.
+         * A racy entry is not written and removes any earlier index.
+         */
+        void saveHexIndex(const std::string& filePath, const HexScanCacheEntry& entry) {
+            const std::string indexPath = getHexIndexPath(filePath);
+            if (isRacyFileTime(entry.fileTime)) {
+                std::remove(indexPath.c_str());
+                return;
+            }
+
+            HexIndexHeader header;
+            header.sourceSize = static_cast<uint64_t>(entry.fileSize);
+            header.sourceTime = entry.fileTime;
+
+            std::string out(sizeof(header), '\0');
+            auto appendU32 = [&out](uint32_t value) {
+                out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+            };
+            appendU32(static_cast<uint32_t>(filePath.size()));
+            out.append(filePath);
+            uint64_t offset;
+            for (const auto& [pattern, offsets] : entry.offsets) {
+                if (offsets.size() > HEX_INDEX_MAX_OFFSETS) continue;
+                ++header.patternCount;
+                appendU32(static_cast<uint32_t>(pattern.size()));
+                out.append(pattern);
+                appendU32(static_cast<uint32_t>(offsets.size()));
+                for (size_t value : offsets) {
+                    offset = value;
+                    out.append(reinterpret_cast<const char*>(&offset), sizeof(offset));
+                }
+            }
+            std::memcpy(out.data(), &header, sizeof(header));
+
+            writeHexCacheFile(HEX_INDEX_CACHE_PATH, indexPath, out);
+        }
+
+        /**
+         * @brief Returns the cache entry for `filePath`, loading its on-disk index on first use.
+         *
+         * The entry is (re)created whenever the file's size or mtime changed, so an entry
+         * without a pattern means that pattern is not known yet. Caller holds hexScanCacheMutex.
+         */
+        HexScanCacheEntry* getHexScanCacheEntry(const std::string& filePath) {
+            long long fileSize = 0, fileTime = 0;
+            if (!statHexFile(filePath, fileSize, fileTime)) {
+                hexScanCache.erase(filePath);
+                return nullptr;
+            }
+
+            auto fileIt = hexScanCache.find(filePath);
+            if (fileIt != hexScanCache.end()) {
+                if (fileIt->second.fileSize == fileSize && fileIt->second.fileTime == fileTime) {
+                    fileIt->second.lastUse = ++hexScanCacheClock;
+                    return &fileIt->second;
+                }
+                hexScanCache.erase(fileIt);
+            }
+
+            // Make room by dropping the least recently used file
+            if (hexScanCache.size() >= HEX_SCAN_CACHE_FILES) {
+                auto oldest = hexScanCache.begin();
+                for (auto it = std::next(oldest); it != hexScanCache.end(); ++it) {
+                    if (it->second.lastUse < oldest->second.lastUse) oldest = it;
+                }
+                hexScanCache.erase(oldest);
+            }
+            HexScanCacheEntry& entry = hexScanCache[filePath];
+            entry.fileSize = fileSize;
+            entry.fileTime = fileTime;
+            entry.lastUse = ++hexScanCacheClock;
+            loadHexIndex(filePath, entry);
+            return &entry;
+        }
+
+        bool lookupHexScanCache(const std::string& filePath, const std::vector<unsigned char>& pattern, std::vector<size_t>& offsets) {
+            std::lock_guard<std::mutex> lock(hexScanCacheMutex);
+            const HexScanCacheEntry* entry = getHexScanCacheEntry(filePath);
+            if (!entry) return false;
+
+            auto patternIt = entry->offsets.find(std::string(pattern.begin(), pattern.end()));
+            if (patternIt == entry->offsets.end()) return false;
+
+            offsets = patternIt->second;
+            return true;
+        }
+
+        /**
+         * @brief Records the offsets of several patterns found by a scan that started when the
+         * file had size `fileSize` and mtime `fileTime`, and persists them.
+         */
+        void storeHexScanResults(const std::string& filePath, long long fileSize, long long fileTime,
+                                 const std::vector<std::vector<unsigned char>>& patterns, std::vector<std::vector<size_t>>& found) {
+            if (isRacyFileTime(fileTime)) return;
+
+            std::lock_guard<std::mutex> lock(hexScanCacheMutex);
+            HexScanCacheEntry* entry = getHexScanCacheEntry(filePath);
+            if (!entry || entry->fileSize != fileSize || entry->fileTime != fileTime) return;
+
+            for (size_t i = 0; i < patterns.size(); ++i) {
+                if (!patterns[i].empty()) {
+                    entry->offsets[std::string(patterns[i].begin(), patterns[i].end())] = std::move(found[i]);
+                }
+            }
+            saveHexIndex(filePath, *entry);
+        }
+
+        void invalidateHexScanCache(const std::string& filePath) {
+            std::lock_guard<std::mutex> lock(hexScanCacheMutex);
+            hexScanCache.erase(filePath);
+            std::remove(getHexIndexPath(filePath).c_str());
+        }
+
+        /**
+         * @brief Brings cached offsets up to date after `editLength` bytes were written at `editOffset`.
+         *
+         * Only matches starting within (editOffset - patternLength, editOffset + editLength) can
+         * change, so just that window is re-read and re-matched.
+         */
+        void refreshHexScanCache(const std::string& filePath, size_t editOffset, size_t editLength) {
+            std::lock_guard<std::mutex> lock(hexScanCacheMutex);
+            auto fileIt = hexScanCache.find(filePath);
+            if (fileIt == hexScanCache.end()) return;
+            HexScanCacheEntry& entry = fileIt->second;
+
+            size_t maxLength = 1;
+            for (const auto& cached : entry.offsets) {
+                maxLength = std::max(maxLength, cached.first.size());
+            }
+
+            const size_t windowStart = (editOffset >= maxLength - 1) ? editOffset - (maxLength - 1) : 0;
+            std::vector<unsigned char> window;
+            readHexFileRange(filePath, windowStart, editOffset + editLength + maxLength - 1 - windowStart, window);
+
+            if (!statHexFile(filePath, entry.fileSize, entry.fileTime)) {
+                hexScanCache.erase(fileIt);
+                return;
+            }
+
+            size_t patternLength, first, last;
+            for (auto& cached : entry.offsets) {
+                const std::string& pattern = cached.first;
+                std::vector<size_t>& offsets = cached.second;
+                patternLength = pattern.size();
+
+                first = (editOffset >= patternLength - 1) ? editOffset - (patternLength - 1) : 0;
+                last = editOffset + editLength;  // Exclusive
+
+                auto lower = std::lower_bound(offsets.begin(), offsets.end(), first);
+                auto upper = std::lower_bound(lower, offsets.end(), last);
+                std::vector<size_t> found;
+                for (size_t start = first; start < last && start + patternLength <= windowStart + window.size(); ++start) {
+                    if (std::memcmp(window.data() + (start - windowStart), pattern.data(), patternLength) == 0) {
+                        found.push_back(start);
+                    }
+                }
+                offsets.insert(offsets.erase(lower, upper), found.begin(), found.end());
+            }
+            saveHexIndex(filePath, entry);
+        }
+
+        // A handful of writes is patched into the scan cache; large batches just drop it
+        void updateHexScanCache(const std::string& filePath, const std::vector<std::pair<size_t, size_t>>& writtenRanges) {
+            if (writtenRanges.size() <= 16) {
+                for (const auto& range : writtenRanges) {
+                    refreshHexScanCache(filePath, range.first, range.second);
+                }
+            } else {
+                invalidateHexScanCache(filePath);
+            }
+        }
+    }
+    
     
     /**
      * @brief Thread-safe cache management functions
@@ -38,6 +431,12 @@ namespace ult {
         std::lock_guard<std::shared_mutex> writeLock(cacheMutex);
         //hexSumCache.clear();
         hexSumCache = {};
+
+        std::lock_guard<std::mutex> scanLock(hexScanCacheMutex);
+        hexScanCache = {};
+
+        std::lock_guard<std::mutex> versionLock(versionCacheMutex);
+        versionCache = {};
     }
 
     size_t getHexSumCacheSize() {
@@ -203,315 +602,1142 @@ namespace ult {
         
         return hexToReversedHex(decimalToHex(decimalStr, byteGroupSize));
     }
-    
-    
+    
+    
+    namespace {
+    #if defined(__ARM_NEON) || defined(__ARM_NEON__)
+        #define HEX_SEARCH_SIMD 1
+        // 16-byte compare helpers; NEON has no movemask, so each lane yields 4 mask bits
+        using HexVector = uint8x16_t;
+        constexpr unsigned HEX_LANE_BITS = 4;
+
+        inline HexVector loadHexVector(const unsigned char* p) { return vld1q_u8(p); }
+        inline HexVector splatHexVector(unsigned char b) { return vdupq_n_u8(b); }
+
+        // Bit set for every lane where a == x and b == y
+        inline uint64_t hexMatchMask(HexVector a, HexVector b, HexVector x, HexVector y) {
+            const uint8x16_t eq = vandq_u8(vceqq_u8(a, x), vceqq_u8(b, y));
+            const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+            return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x8888888888888888ull;
+        }
+
+        inline HexVector andHexVector(HexVector a, HexVector b) { return vandq_u8(a, b); }
+
+        // True when (a & m) == v in all 16 lanes
+        inline bool hexMaskedEqual(HexVector a, HexVector m, HexVector v) {
+            const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(vceqq_u8(vandq_u8(a, m), v)), 4);
+            return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) == ~0ull;
+        }
+    #elif defined(__SSE2__) || defined(_M_X64)
+        #define HEX_SEARCH_SIMD 1
+        using HexVector = __m128i;
+        constexpr unsigned HEX_LANE_BITS = 1;
+
+        inline HexVector loadHexVector(const unsigned char* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+        inline HexVector splatHexVector(unsigned char b) { return _mm_set1_epi8(static_cast<char>(b)); }
+
+        inline uint64_t hexMatchMask(HexVector a, HexVector b, HexVector x, HexVector y) {
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, x), _mm_cmpeq_epi8(b, y))));
+        }
+
+        inline HexVector andHexVector(HexVector a, HexVector b) { return _mm_and_si128(a, b); }
+
+        inline bool hexMaskedEqual(HexVector a, HexVector m, HexVector v) {
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(a, m), v)) == 0xFFFF;
+        }
+    #else
+        #define HEX_SEARCH_SIMD 0
+    #endif
+
+        // Below this length the pair filter beats Horspool even on all-0x00/0xFF patterns
+        constexpr size_t HORSPOOL_MIN_LENGTH = HEX_SEARCH_SIMD ? 32 : 16;
+
+        // Rough rank of how rarely a byte shows up in executables and data files; higher is rarer
+        inline int byteRarity(unsigned char b) {
+            if (b == 0x00) return 0;
+            if (b == 0xFF) return 1;
+            if (b < 0x10 || b == ' ' || (b >= 'a' && b <= 'z')) return 2;
+            if (b < 0x80) return 3;
+            return 4;
+        }
+
+        /**
+         * @brief Reads a file in HEX_BUFFER_SIZE chunks and hands each to onChunk(data, length, base).
+         *
+         * The last `overlap` bytes of each chunk are carried to the front of the next one, so
+         * a caller looking for N-byte runs passes N - 1 and never misses one spanning a boundary.
+         * `base` is the file offset of data[0]; onChunk returns false to stop early. Only the
+         * `limit` bytes starting at `start` are read. Mapped files are handed over in larger
+         * windows straight from the mapping (see MappedFile).
+         */
+        template <typename Callback>
+        bool forEachFileChunk(const std::string& filePath, size_t overlap, Callback&& onChunk,
+                              size_t start = 0, size_t limit = SIZE_MAX) {
+            MappedFile file(filePath);
+            return file.forEachRange(HEX_BUFFER_SIZE, overlap, onChunk, start, limit);
+        }
+
+        constexpr size_t HEX_PARALLEL_MIN_SEGMENT = 4 << 20;  // Smaller files are scanned on the calling thread
+        constexpr size_t HEX_PARALLEL_SEGMENTS_PER_THREAD = 4;
+
+        // Number of workers a scan of `fileSize` bytes gets; 1 means scan serially
+        size_t getHexScanThreads(size_t fileSize) {
+            if (HEX_SCAN_THREADS <= 1) return 1;
+            return std::min(HEX_SCAN_THREADS, fileSize / HEX_PARALLEL_MIN_SEGMENT);
+        }
+
+        /**
+         * @brief Splits [0, fileSize) into segments scanned by `threads` workers and delivers them in order.
+         *
+         * Workers take segments in file order and run scan(start, end, results, cancel), which
+         * fills `results` with what it finds in [start, end) and should return early once
+         * `cancel` is set. The calling thread hands each segment's results to deliver(results)
+         * as soon as it and all earlier segments are done; deliver returns false to stop, which
+         * cancels the remaining work.
+         *
+         * @return False if any segment could not be read.
+         */
+        template <typename Result, typename Scan, typename Deliver>
+        bool scanHexSegments(size_t fileSize, size_t threads, Scan&& scan, Deliver&& deliver) {
+            const size_t wanted = threads * HEX_PARALLEL_SEGMENTS_PER_THREAD;
+            const size_t segmentSize = std::max(HEX_PARALLEL_MIN_SEGMENT, (fileSize + wanted - 1) / wanted);
+            const size_t segmentCount = (fileSize + segmentSize - 1) / segmentSize;
+
+            std::vector<std::vector<Result>> results(segmentCount);
+            std::vector<char> done(segmentCount, 0);
+            std::mutex doneMutex;
+            std::condition_variable doneSignal;
+            std::atomic<size_t> nextSegment{0};
+            std::atomic<bool> cancel{false};
+            std::atomic<bool> failed{false};
+
+            auto worker = [&]() {
+                size_t i;
+                while (!cancel.load(std::memory_order_relaxed) &&
+                       (i = nextSegment.fetch_add(1, std::memory_order_relaxed)) < segmentCount) {
+                    const size_t start = i * segmentSize;
+                    if (!scan(start, std::min(start + segmentSize, fileSize), results[i], cancel)) {
+                        failed.store(true, std::memory_order_relaxed);
+                    }
+                    {
+                        std::lock_guard<std::mutex> lock(doneMutex);
+                        done[i] = 1;
+                    }
+                    doneSignal.notify_all();
+                }
+            };
+
+            std::vector<std::thread> workers;
+            workers.reserve(threads);
+            for (size_t t = 0; t < threads; ++t) {
+                workers.emplace_back(worker);
+            }
+
+            for (size_t i = 0; i < segmentCount; ++i) {
+                {
+                    std::unique_lock<std::mutex> lock(doneMutex);
+                    doneSignal.wait(lock, [&]() { return done[i] != 0; });
+                }
+                if (failed.load(std::memory_order_relaxed) || !deliver(results[i])) break;
+                results[i] = {};
+            }
+
+            cancel.store(true, std::memory_order_relaxed);
+            for (auto& thread : workers) {
+                thread.join();
+            }
+            return !failed.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Calls onMatch(offset) for every match of `searcher` (a HexSearcher or
+         * HexMaskedSearcher) in the file. onMatch returns false to stop early.
+         *
+         * Large files are split across HEX_SCAN_THREADS workers; onMatch still runs on the
+         * calling thread with offsets in ascending order. A nonzero `maxMatches` promises that
+         * onMatch stops by then, so each worker stops its segment after that many matches.
+         */
+        template <typename Searcher, typename Callback>
+        bool forEachHexMatch(const std::string& filePath, const Searcher& searcher, Callback&& onMatch, size_t maxMatches = 0) {
+            if (searcher.size() == 0) return false;
+
+            const size_t overlap = searcher.size() - 1;
+            long long fileSize = 0, fileTime = 0;
+            const size_t threads = statHexFile(filePath, fileSize, fileTime) ? getHexScanThreads(static_cast<size_t>(fileSize)) : 1;
+
+            if (threads <= 1) {
+                return forEachFileChunk(filePath, overlap, [&](const unsigned char* data, size_t length, size_t base) {
+                    size_t pos = 0;
+                    while ((pos = searcher.find(data, length, pos)) != std::string::npos) {
+                        if (!onMatch(base + pos)) return false;
+                        ++pos;
+                    }
+                    return true;
+                });
+            }
+
+            auto scan = [&](size_t start, size_t end, std::vector<size_t>& found, const std::atomic<bool>& cancel) {
+                // Read past the end so matches starting just before it are complete
+                return forEachFileChunk(filePath, overlap, [&](const unsigned char* data, size_t length, size_t base) {
+                    size_t pos = 0;
+                    while ((pos = searcher.find(data, length, pos)) != std::string::npos && base + pos < end) {
+                        found.push_back(base + pos);
+                        if (found.size() == maxMatches) return false;
+                        ++pos;
+                    }
+                    return !cancel.load(std::memory_order_relaxed);
+                }, start, end - start + overlap);
+            };
+            return scanHexSegments<size_t>(static_cast<size_t>(fileSize), threads, scan, [&](const std::vector<size_t>& found) {
+                for (size_t offset : found) {
+                    if (!onMatch(offset)) return false;
+                }
+                return true;
+            });
+        }
+    }
+
+    HexSearcher::HexSearcher(std::vector<unsigned char> bytes) : pattern(std::move(bytes)) {
+        const size_t length = pattern.size();
+        if (length == 0) return;
+        if (length == 1) {
+            mode = Strategy::SingleByte;
+            return;
+        }
+
+        // Rarest byte first, then the rarest position holding a different value if there is one
+        for (size_t i = 1; i < length; ++i) {
+            if (byteRarity(pattern[i]) > byteRarity(pattern[rareIndex])) rareIndex = i;
+        }
+        pairIndex = (rareIndex == 0) ? 1 : 0;
+        for (size_t i = 0; i < length; ++i) {
+            if (i == rareIndex) continue;
+            const bool distinct = pattern[i] != pattern[rareIndex];
+            const bool pairDistinct = pattern[pairIndex] != pattern[rareIndex];
+            if ((distinct && !pairDistinct) ||
+                (distinct == pairDistinct && byteRarity(pattern[i]) > byteRarity(pattern[pairIndex]))) {
+                pairIndex = i;
+            }
+        }
+
+        // Long patterns made only of 0x00/0xFF bytes defeat a byte filter; skip ahead instead
+        if (byteRarity(pattern[rareIndex]) <= 1 && length >= HORSPOOL_MIN_LENGTH) {
+            mode = Strategy::Horspool;
+            skip.assign(256, static_cast<uint32_t>(length));
+            for (size_t i = 0; i + 1 < length; ++i) {
+                skip[pattern[i]] = static_cast<uint32_t>(length - 1 - i);
+            }
+            return;
+        }
+        mode = Strategy::RareBytes;
+    }
+
+    size_t HexSearcher::find(const unsigned char* data, size_t length, size_t from) const {
+        const size_t patternLen = pattern.size();
+        if (patternLen == 0 || length < patternLen || from > length - patternLen) {
+            return std::string::npos;
+        }
+
+        switch (mode) {
+            case Strategy::SingleByte: {
+                const void* hit = std::memchr(data + from, pattern[0], length - from);
+                return hit ? static_cast<const unsigned char*>(hit) - data : std::string::npos;
+            }
+            case Strategy::Horspool:
+                return findHorspool(data, length, from);
+            case Strategy::RareBytes:
+                return findRareBytes(data, length, from);
+            default:
+                return std::string::npos;
+        }
+    }
+
+    size_t HexSearcher::findRareBytes(const unsigned char* data, size_t length, size_t from) const {
+        const size_t patternLen = pattern.size();
+        const size_t last = length - patternLen;  // Last position a match can start at
+        const unsigned char* const patternPtr = pattern.data();
+        const unsigned char rareByte = pattern[rareIndex];
+        const unsigned char pairByte = pattern[pairIndex];
+        size_t pos = from;
+        const unsigned char* hit;
+
+    #if HEX_SEARCH_SIMD
+        size_t misses = 0;
+        bool useVector = false;
+    #endif
+
+        // memchr on the rarest byte is fastest while that byte really is rare
+        while (pos <= last) {
+            hit = static_cast<const unsigned char*>(std::memchr(data + pos + rareIndex, rareByte, last - pos + 1));
+            if (!hit) return std::string::npos;
+            pos = (hit - data) - rareIndex;
+            if (data[pos + pairIndex] == pairByte && std::memcmp(data + pos, patternPtr, patternLen) == 0) {
+                return pos;
+            }
+            ++pos;
+        #if HEX_SEARCH_SIMD
+            // Candidates closer than 64 bytes apart on average: filter on both bytes instead
+            if (++misses >= 16 && pos - from < misses * 64) {
+                useVector = true;
+                break;
+            }
+        #endif
+        }
+
+    #if HEX_SEARCH_SIMD
+        if (!useVector) return std::string::npos;
+
+        // Block at pos covers candidates pos..pos+15; every load stays below data + length
+        const HexVector rareVector = splatHexVector(rareByte);
+        const HexVector pairVector = splatHexVector(pairByte);
+        uint64_t mask;
+        size_t candidate;
+        for (; pos + 16 <= last + 1; pos += 16) {
+            mask = hexMatchMask(loadHexVector(data + pos + rareIndex), loadHexVector(data + pos + pairIndex),
+                                rareVector, pairVector);
+            while (mask) {
+                candidate = pos + static_cast<size_t>(__builtin_ctzll(mask)) / HEX_LANE_BITS;
+                if (std::memcmp(data + candidate, patternPtr, patternLen) == 0) return candidate;
+                mask &= mask - 1;
+            }
+        }
+
+        for (; pos <= last; ++pos) {
+            if (data[pos + rareIndex] == rareByte && data[pos + pairIndex] == pairByte &&
+                std::memcmp(data + pos, patternPtr, patternLen) == 0) {
+                return pos;
+            }
+        }
+    #endif
+        return std::string::npos;
+    }
+
+    size_t HexSearcher::findHorspool(const unsigned char* data, size_t length, size_t from) const {
+        const size_t patternLen = pattern.size();
+        const size_t last = length - patternLen;
+        const unsigned char* const patternPtr = pattern.data();
+        const unsigned char lastByte = pattern[patternLen - 1];
+        size_t pos = from;
+        unsigned char c;
+
+        while (pos <= last) {
+            c = data[pos + patternLen - 1];
+            if (c == lastByte && std::memcmp(data + pos, patternPtr, patternLen - 1) == 0) {
+                return pos;
+            }
+            pos += skip[c];
+        }
+        return std::string::npos;
+    }
+
+    bool hexToBytes(const std::string& hexData, std::vector<unsigned char>& bytes) {
+        const size_t hexLen = hexData.length();
+        if (hexLen == 0 || hexLen % 2 != 0) {
+            bytes.clear();
+            return false;
+        }
+
+        bytes.resize(hexLen / 2);
+        const unsigned char* hexPtr = reinterpret_cast<const unsigned char*>(hexData.data());
+        for (size_t i = 0; i < hexLen; i += 2) {
+            bytes[i / 2] = (hexTable[hexPtr[i]] << 4) | hexTable[hexPtr[i + 1]];
+        }
+        return true;
+    }
+
+    HexMaskedSearcher::HexMaskedSearcher(const std::string& hexPattern) {
+        const size_t hexLen = hexPattern.length();
+        if (hexLen == 0 || hexLen % 2 != 0) return;
+
+        value.resize(hexLen / 2);
+        mask.resize(hexLen / 2);
+        const unsigned char* hexPtr = reinterpret_cast<const unsigned char*>(hexPattern.data());
+        unsigned char high, low;
+        for (size_t i = 0; i < hexLen; i += 2) {
+            high = hexPtr[i];
+            low = hexPtr[i + 1];
+            mask[i / 2] = static_cast<unsigned char>((high == '?' ? 0x00 : 0xF0) | (low == '?' ? 0x00 : 0x0F));
+            value[i / 2] = static_cast<unsigned char>(((hexTable[high] << 4) | hexTable[low]) & mask[i / 2]);
+        }
+
+        // Fully fixed bytes beat half-fixed ones; among those, rarer values are more selective
+        auto selectivity = [this](size_t i) {
+            if (mask[i] == 0xFF) return 16 + byteRarity(value[i]);
+            return mask[i] == 0x00 ? 0 : 8;
+        };
+        const size_t length = value.size();
+        for (size_t i = 1; i < length; ++i) {
+            if (selectivity(i) > selectivity(rareIndex)) rareIndex = i;
+        }
+        anyFixed = mask[rareIndex] != 0x00;
+
+        pairIndex = rareIndex;
+        for (size_t i = 0; i < length; ++i) {
+            if (i == rareIndex) continue;
+            if (pairIndex == rareIndex || selectivity(i) > selectivity(pairIndex)) pairIndex = i;
+        }
+    }
+
+    bool HexMaskedSearcher::matches(const unsigned char* data) const {
+        const size_t length = value.size();
+        const unsigned char* const valuePtr = value.data();
+        const unsigned char* const maskPtr = mask.data();
+        size_t i = 0;
+    #if HEX_SEARCH_SIMD
+        for (; i + 16 <= length; i += 16) {
+            if (!hexMaskedEqual(loadHexVector(data + i), loadHexVector(maskPtr + i), loadHexVector(valuePtr + i))) {
+                return false;
+            }
+        }
+    #endif
+        for (; i < length; ++i) {
+            if ((data[i] & maskPtr[i]) != valuePtr[i]) return false;
+        }
+        return true;
+    }
+
+    size_t HexMaskedSearcher::find(const unsigned char* data, size_t length, size_t from) const {
+        const size_t patternLen = value.size();
+        if (patternLen == 0 || length < patternLen || from > length - patternLen) {
+            return std::string::npos;
+        }
+        if (!anyFixed) return from;
+
+        const size_t last = length - patternLen;
+        const unsigned char rareValue = value[rareIndex], rareMask = mask[rareIndex];
+        const unsigned char pairValue = value[pairIndex], pairMask = mask[pairIndex];
+        size_t pos = from;
+
+    #if HEX_SEARCH_SIMD
+        // A fully fixed anchor can use memchr while it stays rare, as in HexSearcher
+        if (rareMask == 0xFF) {
+            const unsigned char* hit;
+            size_t misses = 0;
+            while (pos <= last) {
+                hit = static_cast<const unsigned char*>(std::memchr(data + pos + rareIndex, rareValue, last - pos + 1));
+                if (!hit) return std::string::npos;
+                pos = (hit - data) - rareIndex;
+                if ((data[pos + pairIndex] & pairMask) == pairValue && matches(data + pos)) return pos;
+                ++pos;
+                if (++misses >= 16 && pos - from < misses * 64) break;
+            }
+        }
+
+        const HexVector rareVector = splatHexVector(rareValue), rareMaskVector = splatHexVector(rareMask);
+        const HexVector pairVector = splatHexVector(pairValue), pairMaskVector = splatHexVector(pairMask);
+        uint64_t candidates;
+        size_t candidate;
+        for (; pos + 16 <= last + 1; pos += 16) {
+            candidates = hexMatchMask(andHexVector(loadHexVector(data + pos + rareIndex), rareMaskVector),
+                                      andHexVector(loadHexVector(data + pos + pairIndex), pairMaskVector),
+                                      rareVector, pairVector);
+            while (candidates) {
+                candidate = pos + static_cast<size_t>(__builtin_ctzll(candidates)) / HEX_LANE_BITS;
+                if (matches(data + candidate)) return candidate;
+                candidates &= candidates - 1;
+            }
+        }
+    #endif
+
+        for (; pos <= last; ++pos) {
+            if ((data[pos + rareIndex] & rareMask) == rareValue && (data[pos + pairIndex] & pairMask) == pairValue &&
+                matches(data + pos)) {
+                return pos;
+            }
+        }
+        return std::string::npos;
+    }
+
+    HexPatternSet::HexPatternSet(const std::vector<std::vector<unsigned char>>& patterns) {
+        patternLengths.reserve(patterns.size());
+        for (const auto& pattern : patterns) {
+            patternLengths.push_back(pattern.size());
+            for (unsigned char b : pattern) {
+                if (byteClass[b] == 0) byteClass[b] = static_cast<uint16_t>(classCount++);
+            }
+        }
+
+        // Trie; 0 doubles as "no edge" because nothing transitions back into the root while building
+        next.assign(classCount, 0);
+        std::vector<std::vector<uint32_t>> stateOutputs(1);
+        uint32_t current, target;
+        for (size_t index = 0; index < patterns.size(); ++index) {
+            if (patterns[index].empty()) continue;
+            current = 0;
+            for (unsigned char b : patterns[index]) {
+                target = next[current * classCount + byteClass[b]];
+                if (target == 0) {
+                    target = static_cast<uint32_t>(stateOutputs.size());
+                    next[current * classCount + byteClass[b]] = target;
+                    next.resize(next.size() + classCount, 0);
+                    stateOutputs.emplace_back();
+                }
+                current = target;
+            }
+            stateOutputs[current].push_back(static_cast<uint32_t>(index));
+        }
+
+        // Breadth-first pass turning the trie into a full DFA and merging suffix outputs
+        std::vector<uint32_t> fail(stateOutputs.size(), 0);
+        std::vector<uint32_t> queue;
+        queue.reserve(stateOutputs.size());
+        for (size_t c = 0; c < classCount; ++c) {
+            if (next[c] != 0) queue.push_back(next[c]);
+        }
+        for (size_t head = 0; head < queue.size(); ++head) {
+            current = queue[head];
+            const std::vector<uint32_t>& inherited = stateOutputs[fail[current]];
+            stateOutputs[current].insert(stateOutputs[current].end(), inherited.begin(), inherited.end());
+
+            for (size_t c = 0; c < classCount; ++c) {
+                target = next[current * classCount + c];
+                if (target != 0) {
+                    fail[target] = next[fail[current] * classCount + c];
+                    queue.push_back(target);
+                } else {
+                    next[current * classCount + c] = next[fail[current] * classCount + c];
+                }
+            }
+        }
+
+        outputStart.reserve(stateOutputs.size() + 1);
+        for (const auto& stateOutput : stateOutputs) {
+            outputStart.push_back(static_cast<uint32_t>(outputs.size()));
+            outputs.insert(outputs.end(), stateOutput.begin(), stateOutput.end());
+        }
+        outputStart.push_back(static_cast<uint32_t>(outputs.size()));
+
+        // Store row offsets instead of state ids and flag states that report matches
+        for (uint32_t& entry : next) {
+            const bool reports = !stateOutputs[entry].empty();
+            entry = static_cast<uint32_t>(entry * classCount) | (reports ? HAS_OUTPUT : 0);
+        }
+        // Skipping ahead at the root only pays off when no pattern starts with a common byte
+        skipAtRoot = true;
+        for (size_t b = 0; b < 256; ++b) {
+            leavesRoot[b] = next[byteClass[b]] != 0;
+            if (leavesRoot[b] && byteRarity(static_cast<unsigned char>(b)) < 2) skipAtRoot = false;
+        }
+    }
+
+    bool HexPatternSet::scan(const unsigned char* data, size_t length, size_t base,
+                             const std::function<bool(size_t, size_t)>& onMatch) {
+        const uint32_t* const table = next.data();
+        const uint32_t classes = static_cast<uint32_t>(classCount);
+        uint32_t row = state * classes;
+        uint32_t entry;
+
+        // Reports the matches of the state at `row`, whose last byte is data[i]
+        auto report = [&](size_t i) {
+            const uint32_t current = row / classes;
+            for (uint32_t first = outputStart[current], last = outputStart[current + 1]; first < last; ++first) {
+                if (!onMatch(outputs[first], base + i + 1 - patternLengths[outputs[first]])) {
+                    state = current;
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        // Kept as two loops: a root check in the plain loop costs more than it saves
+        if (skipAtRoot) {
+            for (size_t i = 0; i < length; ++i) {
+                if (row == 0) {
+                    while (i < length && !leavesRoot[data[i]]) ++i;
+                    if (i == length) break;
+                }
+                entry = table[row + byteClass[data[i]]];
+                row = entry & ~HAS_OUTPUT;
+                if ((entry & HAS_OUTPUT) && !report(i)) return false;
+            }
+        } else {
+            for (size_t i = 0; i < length; ++i) {
+                entry = table[row + byteClass[data[i]]];
+                row = entry & ~HAS_OUTPUT;
+                if ((entry & HAS_OUTPUT) && !report(i)) return false;
+            }
+        }
+
+        state = row / classes;
+        return true;
+    }
+    
+    /**
+     * @brief Calls onOffset for each match of a hexadecimal pattern in a file, in ascending order.
+     *
+     * Offsets come from the scan cache or on-disk index when the pattern is known for the
+     * file's current size and mtime. Otherwise the file is scanned, and a scan that runs to
+     * the end of the file records its offsets for later calls.
+     *
+     * @return False if the pattern is invalid or the file cannot be read.
+     */
+    bool forEachHexDataOffset(const std::string& filePath, const std::string& hexData, const std::function<bool(uint64_t)>& onOffset,
+                              size_t maxMatches) {
+        if (isMaskedHexPattern(hexData)) {
+            const HexMaskedSearcher searcher(hexData);
+            return forEachHexMatch(filePath, searcher, [&onOffset](size_t offset) {
+                return onOffset(offset);
+            }, maxMatches);
+        }
+
+        std::vector<unsigned char> binaryData;
+        if (!hexToBytes(hexData, binaryData)) {
+            return false;
+        }
+
+        std::vector<size_t> found;
+        if (lookupHexScanCache(filePath, binaryData, found)) {
+            for (size_t offset : found) {
+                if (!onOffset(offset)) break;
+            }
+            return true;
+        }
+
+        long long fileSize = 0, fileTime = 0;
+        bool indexable = statHexFile(filePath, fileSize, fileTime);
+        bool stopped = false;
+
+        const HexSearcher searcher(binaryData);
+        const bool scanned = forEachHexMatch(filePath, searcher, [&](size_t offset) {
+            // Past the index limit the offsets are of no further use, so stop keeping them
+            if (indexable) {
+                if (found.size() < HEX_INDEX_MAX_OFFSETS) {
+                    found.push_back(offset);
+                } else {
+                    indexable = false;
+                    found = {};
+                }
+            }
+            if (!onOffset(offset)) {
+                stopped = true;
+                return false;
+            }
+            return true;
+        }, maxMatches);
+
+        // Remember a complete result so later calls and later launches skip the scan
+        if (scanned && indexable && !stopped) {
+            std::vector<std::vector<size_t>> results(1, std::move(found));
+            storeHexScanResults(filePath, fileSize, fileTime, {std::move(binaryData)}, results);
+        }
+        return scanned;
+    }
+
+    std::vector<uint64_t> findHexDataOffsetValues(const std::string& filePath, const std::string& hexData, size_t maxCount) {
+        std::vector<uint64_t> offsets;
+        forEachHexDataOffset(filePath, hexData, [&offsets, maxCount](uint64_t offset) {
+            offsets.push_back(offset);
+            return maxCount == 0 || offsets.size() < maxCount;
+        }, maxCount);
+        return offsets;
+    }
+
+    bool findNthHexDataOffset(const std::string& filePath, const std::string& hexData, size_t occurrence, uint64_t& offset) {
+        size_t seen = 0;
+        bool found = false;
+        forEachHexDataOffset(filePath, hexData, [&](uint64_t match) {
+            if (seen++ < occurrence) return true;
+            offset = match;
+            found = true;
+            return false;
+        }, occurrence + 1);
+        return found;
+    }
+
+    /**
+     * @brief Finds the offsets of hexadecimal data in a file.
+     *
+     * This function searches for occurrences of hexadecimal data in a binary file
+     * and returns the file offsets where the data is found. Overlapping matches and
+     * matches spanning read chunks are reported.
+     *
+     * @param filePath The path to the binary file.
+     * @param hexData The hexadecimal data to search for.
+     * @return A vector of strings containing the file offsets where the data is found.
+     */
+    std::vector<std::string> findHexDataOffsets(const std::string& filePath, const std::string& hexData) {
+        std::vector<std::string> offsets;
+        forEachHexDataOffset(filePath, hexData, [&offsets](uint64_t offset) {
+            offsets.emplace_back(ult::to_string(offset));
+            return true;
+        });
+        return offsets;
+    }
+
+    std::vector<std::string> findHexDataOffsets(const std::string& filePath, const HexMaskedSearcher& searcher) {
+        std::vector<std::string> offsets;
+        forEachHexMatch(filePath, searcher, [&offsets](size_t offset) {
+            offsets.emplace_back(ult::to_string(offset));
+            return true;
+        });
+        return offsets;
+    }
+
+    namespace {
+        // One streaming pass over the file; offsets per pattern index in ascending order
+        std::vector<std::vector<size_t>> scanHexPatterns(const std::string& filePath, const std::vector<std::vector<unsigned char>>& patterns) {
+            std::vector<std::vector<size_t>> results(patterns.size());
+            HexPatternSet patternSet(patterns);
+            if (patternSet.stateCount() <= 1) return results;
+
+            long long fileSize = 0, fileTime = 0;
+            const size_t threads = statHexFile(filePath, fileSize, fileTime) ? getHexScanThreads(static_cast<size_t>(fileSize)) : 1;
+
+            if (threads <= 1) {
+                const std::function<bool(size_t, size_t)> onMatch = [&results](size_t index, size_t offset) {
+                    results[index].push_back(offset);
+                    return true;
+                };
+                forEachFileChunk(filePath, 0, [&](const unsigned char* data, size_t length, size_t base) {
+                    return patternSet.scan(data, length, base, onMatch);
+                });
+                return results;
+            }
+
+            size_t maxLength = 1;
+            for (const auto& pattern : patterns) {
+                maxLength = std::max(maxLength, pattern.size());
+            }
+
+            // Each segment restarts the automaton far enough back to see matches starting at its first byte,
+            // and reads past its end so matches starting just before it are complete
+            auto scan = [&](size_t start, size_t end, std::vector<std::pair<size_t, size_t>>& found, const std::atomic<bool>& cancel) {
+                HexPatternSet segmentSet = patternSet;
+                const size_t lead = std::min(start, maxLength - 1);
+                const std::function<bool(size_t, size_t)> onMatch = [&found, start, end](size_t index, size_t offset) {
+                    if (offset >= start && offset < end) found.emplace_back(index, offset);
+                    return true;
+                };
+                return forEachFileChunk(filePath, 0, [&](const unsigned char* data, size_t length, size_t base) {
+                    return segmentSet.scan(data, length, base, onMatch) && !cancel.load(std::memory_order_relaxed);
+                }, start - lead, end - start + lead + maxLength - 1);
+            };
+            scanHexSegments<std::pair<size_t, size_t>>(static_cast<size_t>(fileSize), threads, scan,
+                                                       [&results](const std::vector<std::pair<size_t, size_t>>& found) {
+                for (const auto& [index, offset] : found) {
+                    results[index].push_back(offset);
+                }
+                return true;
+            });
+            return results;
+        }
+    }
+
+    std::vector<std::vector<std::string>> findHexDataOffsets(const std::string& filePath, const std::vector<std::string>& hexPatterns) {
+        std::vector<std::vector<unsigned char>> patterns(hexPatterns.size());
+        for (size_t i = 0; i < hexPatterns.size(); ++i) {
+            if (!isMaskedHexPattern(hexPatterns[i])) hexToBytes(hexPatterns[i], patterns[i]);
+        }
+
+        const std::vector<std::vector<size_t>> found = scanHexPatterns(filePath, patterns);
+        std::vector<std::vector<std::string>> results(found.size());
+        for (size_t i = 0; i < found.size(); ++i) {
+            if (isMaskedHexPattern(hexPatterns[i])) {
+                results[i] = findHexDataOffsets(filePath, HexMaskedSearcher(hexPatterns[i]));
+                continue;
+            }
+            results[i].reserve(found[i].size());
+            for (size_t offset : found[i]) {
+                results[i].emplace_back(ult::to_string(offset));
+            }
+        }
+        return results;
+    }
+
+    void prefetchHexDataOffsets(const std::string& filePath, const std::vector<std::string>& hexPatterns) {
+        long long fileSize = 0, fileTime = 0;
+        if (!statHexFile(filePath, fileSize, fileTime)) return;
+
+        std::vector<std::vector<unsigned char>> patterns(hexPatterns.size());
+        for (size_t i = 0; i < hexPatterns.size(); ++i) {
+            if (!isMaskedHexPattern(hexPatterns[i])) hexToBytes(hexPatterns[i], patterns[i]);
+        }
+        std::vector<std::vector<size_t>> found = scanHexPatterns(filePath, patterns);
+        storeHexScanResults(filePath, fileSize, fileTime, patterns, found);
+    }
+
+    void clearHexOffsetIndex() {
+        {
+            std::lock_guard<std::mutex> lock(hexScanCacheMutex);
+            hexScanCache = {};
+        }
+
+        // The index directory is flat, so its files are removed directly instead of through a tree walk
+        if (DIR* dir = opendir(HEX_INDEX_CACHE_PATH.c_str())) {
+            std::string indexPath;
+            dirent* entry;
+            while ((entry = readdir(dir)) != nullptr) {
+                if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+                indexPath = HEX_INDEX_CACHE_PATH + entry->d_name;
+                std::remove(indexPath.c_str());
+            }
+            closedir(dir);
+        }
+        rmdir(HEX_INDEX_CACHE_PATH.c_str());
+    }
+
     
     /**
-     * @brief Finds the offsets of hexadecimal data in a file.
+     * @brief Applies a batch of edits to a file through one handle.
      *
-     * This function searches for occurrences of hexadecimal data in a binary file
-     * and returns the file offsets where the data is found.
+     * Edits are ordered by offset (ties keep their list order, so later edits win) and
+     * edits lying within HEX_BUFFER_SIZE of each other are merged into a single write. An edit is rejected
+     * if its byte list is empty or its offset is not inside the file.
+     *
+     * With `journal` set, the bytes every write will cover are read first and saved as the file's edit
+     * journal in a single write before any data is touched; the spans are then built from those
+     * saved bytes, so journaling adds no I/O per edit. If a journaled batch fails part way, the spans already
+     * written are restored and every edit is reported as rejected.
      *
      * @param filePath The path to the binary file.
-     * @param hexData The hexadecimal data to search for.
-     * @return A vector of strings containing the file offsets where the data is found.
+     * @param edits The edits to apply.
+     * @param journal Whether to record the batch for revertHexEdits.
+     * @return Counts of applied and rejected edits and of writes issued.
      */
-    std::vector<std::string> findHexDataOffsets(const std::string& filePath, const std::string& hexData) {
-        std::vector<std::string> offsets;
-    
+    HexEditResult applyHexEdits(const std::string& filePath, std::vector<HexEdit> edits, bool journal) {
+        HexEditResult result;
+
+        // Lock file writes to prevent concurrent modifications to the same file
+        std::lock_guard<std::mutex> fileWriteLock(fileWriteMutex);
+
+        std::stable_sort(edits.begin(), edits.end(), [](const HexEdit& a, const HexEdit& b) {
+            return a.offset < b.offset;
+        });
+
     #if !USING_FSTREAM_DIRECTIVE
-        FILE* file = fopen(filePath.c_str(), "rb");
+        FILE* file = fopen(filePath.c_str(), "rb+");
         if (!file) {
-            return offsets;
+            #if USING_LOGGING_DIRECTIVE
+            if (!disableLogging)
+                logMessage("Failed to open the file.");
+            #endif
+            result.rejected = edits.size();
+            return result;
         }
-    
         fseek(file, 0, SEEK_END);
-        const size_t fileSize = ftell(file);
-        fseek(file, 0, SEEK_SET);
-    
-        std::vector<unsigned char> binaryData;
-        if (hexData.length() % 2 != 0) {
-            fclose(file);
-            return offsets;
-        }
-        
-        
-        const size_t hexLen = hexData.length();
-        binaryData.resize(hexLen / 2);
-        const unsigned char* hexPtr = reinterpret_cast<const unsigned char*>(hexData.c_str());
-        
-        // Unrolled hex conversion loop
-        size_t i = 0;
-        for (; i + 4 <= hexLen; i += 4) {
-            binaryData[i/2] = (hexTable[hexPtr[i]] << 4) | hexTable[hexPtr[i + 1]];
-            binaryData[i/2 + 1] = (hexTable[hexPtr[i + 2]] << 4) | hexTable[hexPtr[i + 3]];
+        const size_t fileSize = static_cast<size_t>(ftell(file));
+
+        auto readAt = [&file](size_t offset, void* data, size_t length) {
+            return fseek(file, static_cast<long>(offset), SEEK_SET) == 0 && fread(data, 1, length, file) == length;
+        };
+        auto writeAt = [&file](size_t offset, const void* data, size_t length) {
+            return fseek(file, static_cast<long>(offset), SEEK_SET) == 0 && fwrite(data, 1, length, file) == length;
+        };
+    #else
+        std::fstream file(filePath, std::ios::binary | std::ios::in | std::ios::out);
+        if (!file.is_open()) {
+            #if USING_LOGGING_DIRECTIVE
+            if (!disableLogging)
+                logMessage("Failed to open the file.");
+            #endif
+            result.rejected = edits.size();
+            return result;
         }
-        // Handle remaining bytes
-        for (; i < hexLen; i += 2) {
-            binaryData[i/2] = (hexTable[hexPtr[i]] << 4) | hexTable[hexPtr[i + 1]];
+        file.seekg(0, std::ios::end);
+        const size_t fileSize = static_cast<size_t>(file.tellg());
+
+        auto readAt = [&file](size_t offset, void* data, size_t length) {
+            file.seekg(static_cast<std::streamoff>(offset));
+            file.read(static_cast<char*>(data), length);
+            const bool ok = file.good();
+            file.clear();
+            return ok;
+        };
+        auto writeAt = [&file](size_t offset, const void* data, size_t length) {
+            file.seekp(static_cast<std::streamoff>(offset));
+            file.write(static_cast<const char*>(data), length);
+            const bool ok = file.good();
+            file.clear();
+            return ok;
+        };
+    #endif
+
+        // Nearby edits are written as one span; bytes between them are read back first.
+        // A gap smaller than a buffer costs less to re-write than another seek and write.
+        const size_t mergeGap = HEX_BUFFER_SIZE;
+        const size_t spanLimit = HEX_BUFFER_SIZE * 16;
+
+        struct EditSpan {
+            size_t start, end;
+            size_t firstEdit, lastEdit;  // Range in `accepted`
+            bool hasGaps;
+            size_t saved;  // Position of the original bytes in the journal
+        };
+        std::vector<const HexEdit*> accepted;
+        std::vector<EditSpan> spans;
+
+        size_t editEnd;
+        for (const HexEdit& edit : edits) {
+            if (edit.bytes.empty() || edit.offset >= fileSize) {
+                ++result.rejected;
+                continue;
+            }
+
+            editEnd = edit.offset + edit.bytes.size();
+            if (!spans.empty() && edit.offset <= spans.back().end + mergeGap &&
+                (edit.offset <= spans.back().end || std::max(spans.back().end, editEnd) - spans.back().start <= spanLimit)) {
+                EditSpan& span = spans.back();
+                span.hasGaps = span.hasGaps || edit.offset > span.end;
+                span.end = std::max(span.end, editEnd);
+            } else {
+                spans.push_back({edit.offset, editEnd, accepted.size(), accepted.size(), false, 0});
+            }
+            accepted.push_back(&edit);
+            spans.back().lastEdit = accepted.size();
         }
-    
-        // Optimized search variables
-        const unsigned char* patternPtr = binaryData.data();
-        const size_t patternLen = binaryData.size();
-        const unsigned char firstByte = patternPtr[0];
-        
-        std::vector<unsigned char> buffer(HEX_BUFFER_SIZE);
-        size_t bytesRead = 0;
-        size_t offset = 0;
-        
 
-        while ((bytesRead = fread(buffer.data(), 1, HEX_BUFFER_SIZE, file)) > 0) {
-            const unsigned char* bufPtr = buffer.data();
-            
-            // Optimized search with first-byte filtering and loop unrolling
-            i = 0;
-            const size_t searchEnd = bytesRead;
-            
-            // Process 4 bytes at a time for better cache usage
-            for (; i + 4 <= searchEnd; i += 4) {
-                // Check 4 positions at once
-                if (bufPtr[i] == firstByte) {
-                    if (offset + i + patternLen <= fileSize && 
-                        memcmp(bufPtr + i, patternPtr, patternLen) == 0) {
-                        offsets.emplace_back(ult::to_string(offset + i));
-                    }
-                }
-                if (bufPtr[i + 1] == firstByte) {
-                    if (offset + i + 1 + patternLen <= fileSize && 
-                        memcmp(bufPtr + i + 1, patternPtr, patternLen) == 0) {
-                        offsets.emplace_back(ult::to_string(offset + i + 1));
-                    }
-                }
-                if (bufPtr[i + 2] == firstByte) {
-                    if (offset + i + 2 + patternLen <= fileSize && 
-                        memcmp(bufPtr + i + 2, patternPtr, patternLen) == 0) {
-                        offsets.emplace_back(ult::to_string(offset + i + 2));
-                    }
-                }
-                if (bufPtr[i + 3] == firstByte) {
-                    if (offset + i + 3 + patternLen <= fileSize && 
-                        memcmp(bufPtr + i + 3, patternPtr, patternLen) == 0) {
-                        offsets.emplace_back(ult::to_string(offset + i + 3));
-                    }
-                }
+        // The journal holds the pre-batch bytes of every span and is written once, ahead of the data
+        std::string saved;
+        const std::string journalPath = journal ? getHexJournalPath(filePath) : std::string();
+        bool journalReady = !journal || spans.empty();
+        if (!journalReady) {
+            HexJournalHeader header;
+            header.spanCount = spans.size();
+            header.originalSize = fileSize;
+            header.patchedSize = std::max(fileSize, spans.back().end);
+
+            size_t journalSize = sizeof(header);
+            for (const EditSpan& span : spans) {
+                journalSize += 2 * sizeof(uint64_t) + (std::min(span.end, fileSize) - span.start);
             }
-            
-            // Handle remaining bytes
-            for (; i < searchEnd; ++i) {
-                if (bufPtr[i] == firstByte) {
-                    if (offset + i + patternLen <= fileSize && 
-                        memcmp(bufPtr + i, patternPtr, patternLen) == 0) {
-                        offsets.emplace_back(ult::to_string(offset + i));
-                    }
+            saved.resize(journalSize);
+            std::memcpy(saved.data(), &header, sizeof(header));
+
+            size_t pos = sizeof(header);
+            uint64_t field;
+            journalReady = true;
+            for (EditSpan& span : spans) {
+                const size_t existing = std::min(span.end, fileSize) - span.start;
+                field = span.start;
+                std::memcpy(saved.data() + pos, &field, sizeof(field));
+                field = existing;
+                std::memcpy(saved.data() + pos + sizeof(field), &field, sizeof(field));
+                span.saved = pos + 2 * sizeof(field);
+                if (!readAt(span.start, saved.data() + span.saved, existing)) {
+                    journalReady = false;
+                    break;
                 }
+                pos = span.saved + existing;
             }
-            
-            offset += bytesRead;
-        }
-    
-        fclose(file);
-        
-    #else
-        std::ifstream file(filePath, std::ios::binary);
-        if (!file.is_open()) {
-            return offsets;
+            journalReady = journalReady && writeHexCacheFile(HEX_JOURNAL_PATH, journalPath, saved);
         }
-    
-        file.seekg(0, std::ios::end);
-        const size_t fileSize = file.tellg();
-        file.seekg(0, std::ios::beg);
-    
-        std::vector<unsigned char> binaryData;
-        if (hexData.length() % 2 != 0) {
+        if (!journalReady) {
+            #if USING_LOGGING_DIRECTIVE
+            if (!disableLogging)
+                logMessage("Failed to write the edit journal.");
+            #endif
+        #if !USING_FSTREAM_DIRECTIVE
+            fclose(file);
+        #else
             file.close();
-            return offsets;
-        }
-        
-        
-        const size_t hexLen = hexData.length();
-        binaryData.resize(hexLen / 2);
-        const unsigned char* hexPtr = reinterpret_cast<const unsigned char*>(hexData.c_str());
-        
-        size_t i = 0;
-        for (; i + 4 <= hexLen; i += 4) {
-            binaryData[i/2] = (hexTable[hexPtr[i]] << 4) | hexTable[hexPtr[i + 1]];
-            binaryData[i/2 + 1] = (hexTable[hexPtr[i + 2]] << 4) | hexTable[hexPtr[i + 3]];
+        #endif
+            result.rejected += accepted.size();
+            return result;
         }
-        for (; i < hexLen; i += 2) {
-            binaryData[i/2] = (hexTable[hexPtr[i]] << 4) | hexTable[hexPtr[i + 1]];
-        }
-    
-        const unsigned char* patternPtr = binaryData.data();
-        const size_t patternLen = binaryData.size();
-        const unsigned char firstByte = patternPtr[0];
-        
-        std::vector<unsigned char> buffer(HEX_BUFFER_SIZE);
-        size_t bytesRead = 0;
-        size_t offset = 0;
-    
-        while (file.read(reinterpret_cast<char*>(buffer.data()), HEX_BUFFER_SIZE) || file.gcount() > 0) {
-            bytesRead = file.gcount();
-            const unsigned char* bufPtr = buffer.data();
-            
-            // Same optimized search as FILE* version
-            i = 0;
-            const size_t searchEnd = bytesRead;
-            
-            for (; i + 4 <= searchEnd; i += 4) {
-                if (bufPtr[i] == firstByte) {
-                    if (offset + i + patternLen <= fileSize && 
-                        memcmp(bufPtr + i, patternPtr, patternLen) == 0) {
-                        offsets.emplace_back(ult::to_string(offset + i));
-                    }
-                }
-                if (bufPtr[i + 1] == firstByte) {
-                    if (offset + i + 1 + patternLen <= fileSize && 
-                        memcmp(bufPtr + i + 1, patternPtr, patternLen) == 0) {
-                        offsets.emplace_back(ult::to_string(offset + i + 1));
-                    }
-                }
-                if (bufPtr[i + 2] == firstByte) {
-                    if (offset + i + 2 + patternLen <= fileSize && 
-                        memcmp(bufPtr + i + 2, patternPtr, patternLen) == 0) {
-                        offsets.emplace_back(ult::to_string(offset + i + 2));
-                    }
-                }
-                if (bufPtr[i + 3] == firstByte) {
-                    if (offset + i + 3 + patternLen <= fileSize && 
-                        memcmp(bufPtr + i + 3, patternPtr, patternLen) == 0) {
-                        offsets.emplace_back(ult::to_string(offset + i + 3));
-                    }
-                }
+
+        std::vector<unsigned char> buffer;
+        std::vector<std::pair<size_t, size_t>> writtenRanges;
+        bool failed = false;
+        size_t spanIndex = 0;
+        for (; spanIndex < spans.size(); ++spanIndex) {
+            const EditSpan& span = spans[spanIndex];
+            const size_t existing = std::min(span.end, fileSize) - span.start;
+            buffer.assign(span.end - span.start, 0);
+            bool written = true;
+            if (journal) {
+                std::memcpy(buffer.data(), saved.data() + span.saved, existing);
+            } else if (span.hasGaps) {
+                written = readAt(span.start, buffer.data(), existing);
             }
-            
-            for (; i < searchEnd; ++i) {
-                if (bufPtr[i] == firstByte) {
-                    if (offset + i + patternLen <= fileSize && 
-                        memcmp(bufPtr + i, patternPtr, patternLen) == 0) {
-                        offsets.emplace_back(ult::to_string(offset + i));
-                    }
+            for (size_t i = span.firstEdit; i < span.lastEdit; ++i) {
+                std::memcpy(buffer.data() + (accepted[i]->offset - span.start), accepted[i]->bytes.data(), accepted[i]->bytes.size());
+            }
+            written = written && writeAt(span.start, buffer.data(), buffer.size());
+
+            if (written) {
+                result.applied += span.lastEdit - span.firstEdit;
+                ++result.writes;
+                writtenRanges.emplace_back(span.start, buffer.size());
+            } else {
+                #if USING_LOGGING_DIRECTIVE
+                if (!disableLogging)
+                    logMessage("Failed to write data to the file.");
+                #endif
+                result.rejected += span.lastEdit - span.firstEdit;
+                if (journal) {
+                    failed = true;
+                    break;
                 }
             }
-            
-            offset += bytesRead;
         }
-    
+
+        // A journaled batch is all or nothing: put back every span up to and including the failed one
+        if (failed) {
+            for (size_t i = 0; i <= spanIndex; ++i) {
+                writeAt(spans[i].start, saved.data() + spans[i].saved, std::min(spans[i].end, fileSize) - spans[i].start);
+            }
+            result.rejected = edits.size();
+            result.applied = 0;
+            result.writes = 0;
+        #if !USING_FSTREAM_DIRECTIVE
+            fflush(file);
+            (void)ftruncate(fileno(file), static_cast<off_t>(fileSize));
+        #endif
+        }
+
+    #if !USING_FSTREAM_DIRECTIVE
+        fclose(file);
+    #else
         file.close();
+        if (failed) {
+            (void)truncate(filePath.c_str(), static_cast<off_t>(fileSize));
+        }
     #endif
-    
-        return offsets;
+
+        if (failed) {
+            std::remove(journalPath.c_str());
+            invalidateHexScanCache(filePath);
+        } else {
+            updateHexScanCache(filePath, writtenRanges);
+        }
+        return result;
     }
 
-    
-    
     /**
-     * @brief Edits hexadecimal data in a file at a specified offset.
+     * @brief Restores the bytes recorded by the last journaled applyHexEdits batch on a file.
      *
-     * This function opens a binary file, seeks to a specified offset, and replaces
-     * the data at that offset with the provided hexadecimal data.
+     * The whole journal is validated first, then every span is written back through one handle and
+     * a file grown by the batch is cut back to its original size. The journal is removed afterwards.
+     * A journal whose patched size no longer matches the file is discarded without touching the file.
      *
      * @param filePath The path to the binary file.
-     * @param offsetStr The offset in the file to perform the edit.
-     * @param hexData The hexadecimal data to replace at the offset.
+     * @return True if the file was restored.
      */
-    void hexEditByOffset(const std::string& filePath, const std::string& offsetStr, const std::string& hexData) {
-        // Lock file writes to prevent concurrent modifications to the same file
+    bool revertHexEdits(const std::string& filePath) {
         std::lock_guard<std::mutex> fileWriteLock(fileWriteMutex);
 
-        const std::streampos offset = std::stoll(offsetStr);
-    
-    #if !USING_FSTREAM_DIRECTIVE
-        // Open the file for both reading and writing in binary mode
-        FILE* file = fopen(filePath.c_str(), "rb+");
-        if (!file) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Failed to open the file.");
-            #endif
-            return;
+        const std::string journalPath = getHexJournalPath(filePath);
+        struct stat journalStat;
+        if (stat(journalPath.c_str(), &journalStat) != 0) return false;
+
+        std::vector<unsigned char> saved;
+        HexJournalHeader header;
+        if (readHexFileRange(journalPath, 0, static_cast<size_t>(journalStat.st_size), saved) < sizeof(header)) {
+            std::remove(journalPath.c_str());
+            return false;
         }
-    
-        // Retrieve the file size
-        fseek(file, 0, SEEK_END);
-        const std::streampos fileSize = ftell(file);
-        fseek(file, 0, SEEK_SET);
-    
-        if (offset >= fileSize) {
+        std::memcpy(&header, saved.data(), sizeof(header));
+
+        struct SavedSpan {
+            uint64_t offset;
+            const unsigned char* bytes;
+            uint64_t length;
+        };
+        std::vector<SavedSpan> spans;
+        bool valid = header.magic == HEX_JOURNAL_MAGIC && header.version == HEX_JOURNAL_VERSION &&
+                     header.originalSize <= header.patchedSize;
+        HexIndexReader reader{saved.data() + sizeof(header), saved.data() + saved.size()};
+        SavedSpan span;
+        for (uint64_t i = 0; valid && i < header.spanCount; ++i) {
+            valid = reader.read(span.offset) && reader.read(span.length) &&
+                    static_cast<uint64_t>(reader.end - reader.pos) >= span.length &&
+                    span.offset + span.length <= header.originalSize;
+            if (valid) {
+                span.bytes = reader.pos;
+                reader.pos += span.length;
+                spans.push_back(span);
+            }
+        }
+        valid = valid && reader.pos == reader.end;
+
+        long long fileSize = 0, fileTime = 0;
+        if (!valid || !statHexFile(filePath, fileSize, fileTime) || static_cast<uint64_t>(fileSize) != header.patchedSize) {
             #if USING_LOGGING_DIRECTIVE
             if (!disableLogging)
-                logMessage("Offset exceeds file size.");
+                logMessage("Edit journal does not match " + filePath);
             #endif
-            fclose(file);
-            return;
+            std::remove(journalPath.c_str());
+            return false;
         }
-    
-        // Convert the hex string to binary data
-        std::vector<unsigned char> binaryData(hexData.length() / 2);
-        std::string byteString;
-        for (size_t i = 0, j = 0; i < hexData.length(); i += 2, ++j) {
-            byteString = hexData.substr(i, 2);
-            binaryData[j] = static_cast<unsigned char>(ult::stoi(byteString, nullptr, 16));
+
+        bool restored = true;
+        std::vector<std::pair<size_t, size_t>> writtenRanges;
+        writtenRanges.reserve(spans.size());
+    #if !USING_FSTREAM_DIRECTIVE
+        FILE* file = fopen(filePath.c_str(), "rb+");
+        if (!file) return false;
+        for (const SavedSpan& entry : spans) {
+            restored = fseek(file, static_cast<long>(entry.offset), SEEK_SET) == 0 &&
+                       fwrite(entry.bytes, 1, entry.length, file) == entry.length;
+            if (!restored) break;
+            writtenRanges.emplace_back(entry.offset, entry.length);
         }
-    
-        // Move to the specified offset and write the binary data directly to the file
-        fseek(file, offset, SEEK_SET);
-        const size_t bytesWritten = fwrite(binaryData.data(), sizeof(unsigned char), binaryData.size(), file);
-        if (bytesWritten != binaryData.size()) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Failed to write data to the file.");
-            #endif
-            fclose(file);
-            return;
+        if (restored && header.originalSize < header.patchedSize) {
+            fflush(file);
+            restored = ftruncate(fileno(file), static_cast<off_t>(header.originalSize)) == 0;
         }
-    
-        fclose(file);
+        restored = (fclose(file) == 0) && restored;
     #else
-        // Open the file for both reading and writing in binary mode
         std::fstream file(filePath, std::ios::binary | std::ios::in | std::ios::out);
-        if (!file.is_open()) {
+        if (!file.is_open()) return false;
+        for (const SavedSpan& entry : spans) {
+            file.seekp(static_cast<std::streamoff>(entry.offset));
+            file.write(reinterpret_cast<const char*>(entry.bytes), entry.length);
+            restored = file.good();
+            if (!restored) break;
+            writtenRanges.emplace_back(entry.offset, entry.length);
+        }
+        file.close();
+        if (restored && header.originalSize < header.patchedSize) {
+            restored = truncate(filePath.c_str(), static_cast<off_t>(header.originalSize)) == 0;
+        }
+    #endif
+
+        if (!restored) {
             #if USING_LOGGING_DIRECTIVE
             if (!disableLogging)
-                logMessage("Failed to open the file.");
+                logMessage("Failed to revert edits on " + filePath);
             #endif
-            return;
+            invalidateHexScanCache(filePath);
+            return false;
         }
-    
-        // Retrieve the file size
-        file.seekg(0, std::ios::end);
-        const std::streampos fileSize = file.tellg();
-        file.seekg(0, std::ios::beg);
-    
-        if (offset >= fileSize) {
+
+        std::remove(journalPath.c_str());
+        if (header.originalSize < header.patchedSize) {
+            invalidateHexScanCache(filePath);
+        } else {
+            updateHexScanCache(filePath, writtenRanges);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Edits hexadecimal data in a file at a specified offset.
+     *
+     * This function opens a binary file, seeks to a specified offset, and replaces
+     * the data at that offset with the provided hexadecimal data.
+     *
+     * @param filePath The path to the binary file.
+     * @param offsetStr The offset in the file to perform the edit.
+     * @param hexData The hexadecimal data to replace at the offset.
+     */
+    void hexEditByOffset(const std::string& filePath, const std::string& offsetStr, const std::string& hexData) {
+        HexEdit edit;
+        edit.offset = static_cast<size_t>(std::stoll(offsetStr));
+        if (!hexToBytes(hexData, edit.bytes)) {
             #if USING_LOGGING_DIRECTIVE
             if (!disableLogging)
-                logMessage("Offset exceeds file size.");
+                logMessage("Invalid hex data: " + hexData);
             #endif
             return;
         }
-    
-        // Convert the hex string to binary data
-        std::vector<unsigned char> binaryData(hexData.length() / 2);
-        std::string byteString;
-        for (size_t i = 0, j = 0; i < hexData.length(); i += 2, ++j) {
-            byteString = hexData.substr(i, 2);
-            binaryData[j] = static_cast<unsigned char>(ult::stoi(byteString, nullptr, 16));
-        }
-    
-        // Move to the specified offset and write the binary data directly to the file
-        file.seekp(offset);
-        file.write(reinterpret_cast<const char*>(binaryData.data()), binaryData.size());
-        if (!file) {
+
+        if (applyHexEdits(filePath, {std::move(edit)}).applied == 0) {
             #if USING_LOGGING_DIRECTIVE
             if (!disableLogging)
-                logMessage("Failed to write data to the file.");
+                logMessage("Offset exceeds file size.");
             #endif
-            return;
         }
-    
-        file.close();
-    #endif
     }
     
     
@@ -533,14 +1759,14 @@ namespace ult {
         // Create a cache key based on filePath and customAsciiPattern
         const std::string cacheKey = filePath + '?' + customAsciiPattern + '?' + ult::to_string(occurrence);
         
-        int hexSum = -1;
+        long long hexSum = -1;
         
         // Thread-safe cache access
         {
             std::shared_lock<std::shared_mutex> readLock(cacheMutex);
             const auto cachedResult = hexSumCache.find(cacheKey);
             if (cachedResult != hexSumCache.end()) {
-                hexSum = ult::stoi(cachedResult->second);
+                hexSum = std::stoll(cachedResult->second);
             }
         }
         
@@ -555,16 +1781,15 @@ namespace ult {
             }
             
             
-            // Find hex data offsets in the file
-            const std::vector<std::string> offsets = findHexDataOffsets(filePath, customHexPattern);
-            
-            if (!offsets.empty()) {
-                hexSum = ult::stoi(offsets[occurrence]);
+            // Find the wanted occurrence; the scan stops there
+            uint64_t offset;
+            if (findNthHexDataOffset(filePath, customHexPattern, occurrence, offset)) {
+                hexSum = static_cast<long long>(offset);
                 
                 // Thread-safe cache write
                 {
                     std::lock_guard<std::shared_mutex> writeLock(cacheMutex);
-                    hexSumCache[cacheKey] = ult::to_string(hexSum);
+                    hexSumCache[cacheKey] = std::to_string(hexSum);
                 }
             } else {
                 #if USING_LOGGING_DIRECTIVE
@@ -579,7 +1804,7 @@ namespace ult {
         if (hexSum != -1) {
             // Calculate the total offset to seek in the file
             //int sum = hexSum + ult::stoi(offsetStr);
-            hexEditByOffset(filePath, ult::to_string(hexSum + ult::stoi(offsetStr)), hexDataReplacement);
+            hexEditByOffset(filePath, std::to_string(hexSum + std::stoll(offsetStr)), hexDataReplacement);
         } else {
             #if USING_LOGGING_DIRECTIVE
             if (!disableLogging)
@@ -600,23 +1825,31 @@ namespace ult {
      * @param occurrence The occurrence/index of the data to replace (default is "0" to replace all occurrences).
      */
     void hexEditFindReplace(const std::string& filePath, const std::string& hexDataToReplace, const std::string& hexDataReplacement, size_t occurrence) {
-        const std::vector<std::string> offsetStrs = findHexDataOffsets(filePath, hexDataToReplace);
-        if (!offsetStrs.empty()) {
+        // A specific occurrence only needs the scan to run that far
+        const std::vector<uint64_t> offsets = findHexDataOffsetValues(filePath, hexDataToReplace, occurrence);
+        if (!offsets.empty()) {
+            std::vector<unsigned char> replacement;
+            if (!hexToBytes(hexDataReplacement, replacement)) {
+                #if USING_LOGGING_DIRECTIVE
+                if (!disableLogging)
+                    logMessage("Invalid hex data: " + hexDataReplacement);
+                #endif
+                return;
+            }
+
             if (occurrence == 0) {
-                // Replace all occurrences
-                for (const std::string& offsetStr : offsetStrs) {
-                    //logMessage("offsetStr: "+offsetStr);
-                    //logMessage("hexDataReplacement: "+hexDataReplacement);
-                    hexEditByOffset(filePath, offsetStr, hexDataReplacement);
+                // Replace all occurrences in one pass over the file
+                std::vector<HexEdit> edits(offsets.size());
+                for (size_t i = 0; i < offsets.size(); ++i) {
+                    edits[i].offset = static_cast<size_t>(offsets[i]);
+                    edits[i].bytes = replacement;
                 }
+                applyHexEdits(filePath, std::move(edits));
             } else {
                 // Convert the occurrence string to an integer
-                if (occurrence > 0 && occurrence <= offsetStrs.size()) {
+                if (occurrence > 0 && occurrence <= offsets.size()) {
                     // Replace the specified occurrence/index
-                    //std::string offsetStr = offsetStrs[occurrence - 1];
-                    //logMessage("offsetStr: "+offsetStr);
-                    //logMessage("hexDataReplacement: "+hexDataReplacement);
-                    hexEditByOffset(filePath, offsetStrs[occurrence - 1], hexDataReplacement);
+                    applyHexEdits(filePath, {HexEdit{static_cast<size_t>(offsets[occurrence - 1]), std::move(replacement)}});
                 } else {
                     // Invalid occurrence/index specified
                     #if USING_LOGGING_DIRECTIVE
@@ -643,28 +1876,28 @@ namespace ult {
     std::string parseHexDataAtCustomOffset(const std::string& filePath, const std::string& customAsciiPattern, 
                                          const std::string& offsetStr, size_t length, size_t occurrence) {
         const std::string cacheKey = filePath + '?' + customAsciiPattern + '?' + ult::to_string(occurrence);
-        int hexSum = -1;
+        long long hexSum = -1;
 
         // Thread-safe cache read
         {
             std::shared_lock<std::shared_mutex> readLock(cacheMutex);
             const auto cachedResult = hexSumCache.find(cacheKey);
             if (cachedResult != hexSumCache.end()) {
-                hexSum = ult::stoi(cachedResult->second);
+                hexSum = std::stoll(cachedResult->second);
             }
         }
 
         if (hexSum == -1) {
             const std::string customHexPattern = asciiToHex(customAsciiPattern);
-            const std::vector<std::string> offsets = findHexDataOffsets(filePath, customHexPattern);
+            uint64_t offset;
 
-            if (!offsets.empty() && offsets.size() > occurrence) {
-                hexSum = ult::stoi(offsets[occurrence]);
+            if (findNthHexDataOffset(filePath, customHexPattern, occurrence, offset)) {
+                hexSum = static_cast<long long>(offset);
                 
                 // Thread-safe cache write
                 {
                     std::lock_guard<std::shared_mutex> writeLock(cacheMutex);
-                    hexSumCache[cacheKey] = ult::to_string(hexSum);
+                    hexSumCache[cacheKey] = std::to_string(hexSum);
                 }
             } else {
                 #if USING_LOGGING_DIRECTIVE
@@ -817,65 +2050,88 @@ namespace ult {
     
     
         
+    namespace {
+        constexpr size_t VERSION_TOKEN_LENGTH = 6;  // "v#.#.#"
+
+        inline bool isVersionDigit(char c) {
+            return static_cast<unsigned char>(c - '0') < 10;
+        }
+
+        // Position of the first "v#.#.#" token fully inside data[0, length), or npos
+        size_t findVersionToken(const char* data, size_t length) {
+            if (length < VERSION_TOKEN_LENGTH) return std::string::npos;
+
+            const char* const last = data + length - VERSION_TOKEN_LENGTH;
+            const char* pos = data;
+            while (pos <= last) {
+                pos = static_cast<const char*>(std::memchr(pos, 'v', static_cast<size_t>(last - pos) + 1));
+                if (!pos) break;
+                if (isVersionDigit(pos[1]) && pos[2] == '.' && isVersionDigit(pos[3]) &&
+                    pos[4] == '.' && isVersionDigit(pos[5])) {
+                    return static_cast<size_t>(pos - data);
+                }
+                ++pos;
+            }
+            return std::string::npos;
+        }
+    }
+
     /**
      * @brief Extracts the version string from a binary file.
      *
-     * This function reads a binary file and searches for a version pattern
-     * in the format "v#.#.#" (e.g., "v1.2.3").
+     * This function streams a binary file in HEX_BUFFER_SIZE chunks and returns the first
+     * version pattern in the format "v#.#.#" (e.g., "v1.2.3"). Head and Tail limit the
+     * scan to the first or last `regionBytes` of the file. Results, including misses, are
+     * cached per path and region until the file's size or mtime changes.
      *
      * @param filePath The path to the binary file.
+     * @param region The part of the file to scan.
+     * @param regionBytes The size of the Head or Tail region.
      * @return The version string if found; otherwise, an empty string.
      */
-    std::string extractVersionFromBinary(const std::string &filePath) {
-    #if !USING_FSTREAM_DIRECTIVE
-        // Step 1: Open the binary file
-        FILE* file = fopen(filePath.c_str(), "rb");
-        if (!file) {
+    std::string extractVersionFromBinary(const std::string &filePath, VersionScanRegion region, size_t regionBytes) {
+        long long fileSize = 0, fileTime = 0;
+        if (!statHexFile(filePath, fileSize, fileTime)) {
             return ""; // Return empty string if file cannot be opened
         }
-    
-        // Get the file size
-        fseek(file, 0, SEEK_END);
-        const std::streamsize size = ftell(file);
-        fseek(file, 0, SEEK_SET);
-    
-        // Read the entire file into a buffer
-        std::vector<uint8_t> buffer(size);
-        const size_t bytesRead = fread(buffer.data(), sizeof(uint8_t), size, file);
-        fclose(file); // Close the file after reading
-        
-        if (bytesRead != static_cast<size_t>(size)) {
-            return ""; // Return empty string if reading fails
-        }
-    #else
-        // Step 1: Read the entire binary file into a vector
-        std::ifstream file(filePath, std::ios::binary | std::ios::ate);
-        if (!file.is_open()) {
-            return ""; // Return empty string if file cannot be opened
+
+        size_t start = 0;
+        size_t limit = SIZE_MAX;
+        if (region == VersionScanRegion::Head) {
+            limit = regionBytes;
+        } else if (region == VersionScanRegion::Tail) {
+            limit = regionBytes;
+            if (static_cast<unsigned long long>(fileSize) > regionBytes) {
+                start = static_cast<size_t>(fileSize) - regionBytes;
+            }
         }
-    
-        const std::streamsize size = file.tellg();
-        file.seekg(0, std::ios::beg);
-    
-        std::vector<uint8_t> buffer(size);
-        if (!file.read(reinterpret_cast<char*>(buffer.data()), size)) {
-            return ""; // Return empty string if reading fails
+
+        const std::string cacheKey = filePath + '?' + ult::to_string(static_cast<int>(region)) + '?' + std::to_string(regionBytes);
+        {
+            std::lock_guard<std::mutex> lock(versionCacheMutex);
+            const auto cached = versionCache.find(cacheKey);
+            if (cached != versionCache.end() && cached->second.fileSize == fileSize && cached->second.fileTime == fileTime) {
+                return cached->second.version;
+            }
         }
-    #endif
-    
-        // Step 2: Search for the pattern "v#.#.#"
-        const char* data = reinterpret_cast<const char*>(buffer.data());
-        for (std::streamsize i = 0; i < size; ++i) {
-            if (data[i] == 'v' && i + 5 < size && 
-                std::isdigit(data[i + 1]) && data[i + 2] == '.' && 
-                std::isdigit(data[i + 3]) && data[i + 4] == '.' && 
-                std::isdigit(data[i + 5])) {
-    
-                // Extract the version string
-                return std::string(data + i, 6); // Return the version string
+
+        std::string version;
+        const bool scanned = forEachFileChunk(filePath, VERSION_TOKEN_LENGTH - 1, [&version](const unsigned char* data, size_t length, size_t) {
+            const char* chars = reinterpret_cast<const char*>(data);
+            const size_t pos = findVersionToken(chars, length);
+            if (pos == std::string::npos) return true;
+            version.assign(chars + pos, VERSION_TOKEN_LENGTH);
+            return false;
+        }, start, limit);
+
+        // A file modified within the mtime resolution may still change under the same size and mtime
+        if (scanned && !isRacyFileTime(fileTime)) {
+            std::lock_guard<std::mutex> lock(versionCacheMutex);
+            if (versionCache.find(cacheKey) == versionCache.end() && versionCache.size() >= VERSION_CACHE_ENTRIES) {
+                versionCache.erase(versionCache.begin());
             }
+            versionCache[cacheKey] = {fileSize, fileTime, version};
         }
-    
-        return "";  // Return empty string if no match is found
+        return version;
     }
 }
@@ -22,1577 +22,1540 @@
 namespace ult {
     // Thread safety infrastructure
     namespace {
-        std::unordered_map<std::string, std::shared_ptr<std::shared_mutex>> fileMutexMap;
-        std::mutex mapMutex;
+        constexpr size_t FILE_LOCK_SHARDS = 16;
+        constexpr size_t FILE_LOCK_SHARD_CAPACITY = 16; // Entries kept per shard before idle ones are swept
         
-        std::shared_ptr<std::shared_mutex> getFileMutex(const std::string& filePath) {
-            std::lock_guard<std::mutex> lock(mapMutex);
-            auto it = fileMutexMap.find(filePath);
-            if (it == fileMutexMap.end()) {
-                auto mutex = std::make_shared<std::shared_mutex>();
-                fileMutexMap[filePath] = mutex;
-                return mutex;
-            }
-            return it->second;
-        }
-    }
-
-    /**
-     * @brief Clears unused file mutexes from memory.
-     * WARNING: Only call this when you're certain NO threads are accessing INI files!
-     * Best used during application shutdown or maintenance periods.
-     */
-    void clearIniMutexCache() {
-        std::lock_guard<std::mutex> lock(mapMutex);
-        fileMutexMap.clear();
-    }
-
-
-    /**
-     * @brief Retrieves the package header information from an INI file.
-     *
-     * This function parses an INI file and extracts the package header information.
-     *
-     * @param filePath The path to the INI file.
-     * @return The package header structure.
-     */
-    PackageHeader getPackageHeaderFromIni(const std::string& filePath) {
-        auto fileMutex = getFileMutex(filePath);
-        std::shared_lock<std::shared_mutex> lock(*fileMutex);
-
-        PackageHeader packageHeader;
-        
-    #if !USING_FSTREAM_DIRECTIVE
-        FILE* file = fopen(filePath.c_str(), "r");
-        if (!file) {
-            return packageHeader;
-        }
-        
-        char buffer[1024];
-        std::string line;
-    #else
-        std::ifstream file(filePath);
-        if (!file) {
-            return packageHeader;
-        }
+        struct FileLockEntry {
+            std::shared_mutex mutex;
+            std::atomic<size_t> refs{0}; // Raised under the shard mutex, dropped lock-free
+        };
         
-        std::string line;
-    #endif
-    
-        // Create field map once outside the loop
-        const std::map<std::string_view, std::string*> fieldMap = {
-            {";title=", &packageHeader.title},
-            {";display_title=", &packageHeader.display_title},
-            {";version=", &packageHeader.version},
-            {";creator=", &packageHeader.creator},
-            {";about=", &packageHeader.about},
-            {";credits=", &packageHeader.credits},
-            {";color=", &packageHeader.color},
-            {";show_version=", &packageHeader.show_version},
-            {";show_widget=", &packageHeader.show_widget}
+        /**
+         * @brief One stripe of the per-file lock table.
+         *
+         * Idle entries are kept so hot files do not churn, and swept once the shard
+         * grows past FILE_LOCK_SHARD_CAPACITY. Counters are guarded by the shard mutex.
+         */
+        struct FileLockShard {
+            std::mutex mutex;
+            std::unordered_map<std::string, FileLockEntry> entries;
+            size_t acquisitions = 0;
+            size_t contended = 0;
+            size_t shared = 0;
+            size_t evictions = 0;
         };
         
-        int fieldsFound = 0;
-        const int totalFields = fieldMap.size();
+        FileLockShard fileLockShards[FILE_LOCK_SHARDS];
         
-        size_t startPos, endPos, first, last;
-        std::string value;
-    
-    #if !USING_FSTREAM_DIRECTIVE
-        size_t len;
-        while (fgets(buffer, sizeof(buffer), file) && fieldsFound < totalFields) {
-            // Reuse line string capacity instead of creating new string
-            line.assign(buffer);
-            
-            // Remove newlines efficiently
-            len = line.length();
-            if (len > 0 && line[len-1] == '\n') {
-                line.pop_back();
-                --len;
-                if (len > 0 && line[len-1] == '\r') {
-                    line.pop_back();
+        // Erases idle entries from a shard whose mutex is already held
+        void sweepFileLockShard(FileLockShard& shard) {
+            for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+                if (it->second.refs.load(std::memory_order_acquire) == 0) {
+                    it = shard.entries.erase(it);
+                    ++shard.evictions;
+                } else {
+                    ++it;
                 }
             }
-    #else
-        while (getline(file, line) && fieldsFound < totalFields) {
-            // Remove carriage return if present
-            if (!line.empty() && line.back() == '\r') {
-                line.pop_back();
+        }
+        
+        /**
+         * @brief Holds a reference to one file's mutex; the entry cannot be evicted while held.
+         */
+        class FileMutexHandle {
+        public:
+            explicit FileMutexHandle(FileLockEntry& entry) : entry(&entry) {}
+            FileMutexHandle(FileMutexHandle&& other) noexcept : entry(other.entry) {
+                other.entry = nullptr;
             }
-    #endif
+            FileMutexHandle(const FileMutexHandle&) = delete;
+            FileMutexHandle& operator=(const FileMutexHandle&) = delete;
+            FileMutexHandle& operator=(FileMutexHandle&&) = delete;
             
-            // Skip empty lines and non-comment lines
-            if (line.empty() || line[0] != ';') {
-                line.clear(); // Clear to reuse capacity
-                continue;
+            ~FileMutexHandle() {
+                if (entry) {
+                    entry->refs.fetch_sub(1, std::memory_order_release);
+                }
             }
             
-            // Process each prefix in the map
-            for (const auto& [prefix, field] : fieldMap) {
-                if (line.compare(0, prefix.length(), prefix) == 0) {
-                    startPos = prefix.length();
-                    endPos = line.find_first_of(";\r\n", startPos);
-                    if (endPos == std::string::npos) {
-                        endPos = line.length();
-                    }
-                    
-                    // Extract value directly, reusing value string capacity
-                    value.assign(line, startPos, endPos - startPos);
-                    
-                    // Trim whitespace efficiently
-                    first = value.find_first_not_of(" \t");
-                    if (first == std::string::npos) {
-                        value.clear();
-                    } else {
-                        last = value.find_last_not_of(" \t");
-                        if (first != 0 || last != value.length() - 1) {
-                            value.assign(value, first, last - first + 1);
-                        }
-                    }
-                    
-                    // Remove quotes efficiently
-                    if (value.length() >= 2 && 
-                        ((value.front() == '"' && value.back() == '"') ||
-                         (value.front() == '\'' && value.back() == '\''))) {
-                        value.assign(value, 1, value.length() - 2);
-                    }
-                    
-                    *field = std::move(value);
-                    fieldsFound++;
-                    
-                    // Clear strings to reuse capacity
-                    value.clear();
-                    break;
+            std::shared_mutex& operator*() const { return entry->mutex; }
+            
+        private:
+            FileLockEntry* entry;
+        };
+        
+        FileMutexHandle getFileMutex(const std::string& filePath) {
+            FileLockShard& shard = fileLockShards[std::hash<std::string>{}(filePath) % FILE_LOCK_SHARDS];
+            
+            std::unique_lock<std::mutex> lock(shard.mutex, std::try_to_lock);
+            if (!lock.owns_lock()) {
+                lock.lock();
+                ++shard.contended;
+            }
+            ++shard.acquisitions;
+            
+            auto it = shard.entries.find(filePath);
+            if (it == shard.entries.end()) {
+                if (shard.entries.size() >= FILE_LOCK_SHARD_CAPACITY) {
+                    sweepFileLockShard(shard);
                 }
+                it = shard.entries.try_emplace(filePath).first;
+            } else if (it->second.refs.load(std::memory_order_relaxed) > 0) {
+                ++shard.shared;
             }
             
-            // Clear line to reuse capacity
-            line.clear();
+            it->second.refs.fetch_add(1, std::memory_order_relaxed);
+            return FileMutexHandle(it->second);
         }
-    
-    #if !USING_FSTREAM_DIRECTIVE
-        fclose(file);
-    #endif
-    
-        return packageHeader;
     }
 
-    
-    
     /**
-     * @brief Splits a string into a vector of substrings using a specified delimiter.
-     *
-     * This function splits a given string into multiple substrings based on the specified delimiter.
-     *
-     * @param str The input string to be split.
-     * @param delim The delimiter character used for splitting.
-     * @return A vector of substrings obtained by splitting the input string.
+     * @brief Drops every idle entry from the per-file lock table.
+     * The table bounds itself; this only releases the retained idle entries early.
      */
-    std::vector<std::string> split(const std::string& str, char delim) {
-        std::vector<std::string> out;
-        
-        if (str.empty()) return out;
-        
-        //out.reserve(std::count(str.begin(), str.end(), delim) + 1);
-        
-        const char* data = str.data();
-        const char* end = data + str.size();
-        const char* start = data;
-        
-        while (const char* pos = static_cast<const char*>(std::memchr(start, delim, end - start))) {
-            out.emplace_back(start, pos);
-            start = pos + 1;
+    void clearIniMutexCache() {
+        for (FileLockShard& shard : fileLockShards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            sweepFileLockShard(shard);
         }
-        out.emplace_back(start, end);
-        
-        return out;
     }
     
+    IniLockStats getIniLockStats() {
+        IniLockStats stats;
+        for (FileLockShard& shard : fileLockShards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            stats.acquisitions += shard.acquisitions;
+            stats.shardContended += shard.contended;
+            stats.shared += shard.shared;
+            stats.evictions += shard.evictions;
+            stats.entries += shard.entries.size();
+        }
+        return stats;
+    }
     
-    /**
-     * @brief Parses an INI-formatted string into a map of sections and key-value pairs.
-     *
-     * This function parses an INI-formatted string and organizes the data into a map,
-     * where sections are keys and key-value pairs are stored within each section.
-     *
-     * @param str The INI-formatted string to parse.
-     * @return A map representing the parsed INI data.
-     */
-    std::map<std::string, std::map<std::string, std::string>> parseIni(const std::string &str) {
-        std::map<std::string, std::map<std::string, std::string>> iniData;
-        std::string lastHeader;
-        lastHeader.reserve(64);
-        
-        const char* lineStart = str.c_str();
-        const char* lineEnd;
-        const char* strEnd = lineStart + str.size();
-        
-        auto isWhitespace = [](char c) {
-            return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
-        };
+    void resetIniLockStats() {
+        for (FileLockShard& shard : fileLockShards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.acquisitions = 0;
+            shard.contended = 0;
+            shard.shared = 0;
+            shard.evictions = 0;
+        }
+    }
+    
+    namespace {
+        std::atomic<size_t> iniFileReads{0};
+        std::atomic<size_t> iniBytesRead{0};
+        std::atomic<size_t> iniFileWrites{0};
+        std::atomic<size_t> iniBytesWritten{0};
         
-        while (lineStart < strEnd) {
-            // Find line end
-            lineEnd = lineStart;
-            while (lineEnd < strEnd && *lineEnd != '\n') {
-                lineEnd++;
-            }
-            
-            // Trim whitespace from start
-            while (lineStart < lineEnd && isWhitespace(*lineStart)) {
-                lineStart++;
-            }
-            
-            // Trim whitespace from end
-            while (lineEnd > lineStart && isWhitespace(*(lineEnd-1))) {
-                lineEnd--;
-            }
-            
-            size_t lineLen = lineEnd - lineStart;
-            
-            // Skip empty lines and comments
-            if (lineLen > 0 && *lineStart != '#') {
-                if (*lineStart == '[' && *(lineEnd-1) == ']') {
-                    // Section header
-                    lastHeader.assign(lineStart + 1, lineEnd - 1);
-                    iniData[lastHeader]; // Ensure section exists
-                } else if (!lastHeader.empty()) {
-                    // Key=value pair
-                    const char* eqPos = lineStart;
-                    while (eqPos < lineEnd && *eqPos != '=') {
-                        eqPos++;
-                    }
-                    
-                    if (eqPos < lineEnd) {
-                        // Trim key
-                        const char* keyStart = lineStart;
-                        const char* keyEnd = eqPos;
-                        while (keyStart < keyEnd && isWhitespace(*keyStart)) keyStart++;
-                        while (keyEnd > keyStart && isWhitespace(*(keyEnd-1))) keyEnd--;
-                        
-                        // Trim value
-                        const char* valStart = eqPos + 1;
-                        const char* valEnd = lineEnd;
-                        while (valStart < valEnd && isWhitespace(*valStart)) valStart++;
-                        while (valEnd > valStart && isWhitespace(*(valEnd-1))) valEnd--;
-                        
-                        iniData[lastHeader].emplace(
-                            std::string(keyStart, keyEnd),
-                            std::string(valStart, valEnd)
-                        );
-                    }
-                }
-            }
-            
-            // Move to next line
-            lineStart = lineEnd;
-            if (lineStart < strEnd && *lineStart == '\n') {
-                lineStart++;
-            }
+        // Every INI read and write path reports here so callers can measure I/O per operation
+        inline void recordIniRead(size_t bytes, size_t files = 0) {
+            iniFileReads.fetch_add(files, std::memory_order_relaxed);
+            iniBytesRead.fetch_add(bytes, std::memory_order_relaxed);
         }
         
-        return iniData;
+        inline void recordIniWrite(size_t bytes, size_t files = 0) {
+            iniFileWrites.fetch_add(files, std::memory_order_relaxed);
+            iniBytesWritten.fetch_add(bytes, std::memory_order_relaxed);
+        }
     }
     
+    IniIoStats getIniIoStats() {
+        IniIoStats stats;
+        stats.fileReads = iniFileReads.load(std::memory_order_relaxed);
+        stats.bytesRead = iniBytesRead.load(std::memory_order_relaxed);
+        stats.fileWrites = iniFileWrites.load(std::memory_order_relaxed);
+        stats.bytesWritten = iniBytesWritten.load(std::memory_order_relaxed);
+        return stats;
+    }
     
+    void resetIniIoStats() {
+        iniFileReads.store(0, std::memory_order_relaxed);
+        iniBytesRead.store(0, std::memory_order_relaxed);
+        iniFileWrites.store(0, std::memory_order_relaxed);
+        iniBytesWritten.store(0, std::memory_order_relaxed);
+    }
+
+
     /**
-     * @brief Parses an INI file and returns its content as a map of sections and key-value pairs.
-     *
-     * This function reads the contents of an INI file located at the specified path,
-     * parses it into a map structure, where section names are keys and key-value pairs
-     * are stored within each section.
+     * @brief Collects the spans produced by an INI tokenizer and packs them into a FlatIniData.
      *
-     * @param configIniPath The path to the INI file to be parsed.
-     * @return A map representing the parsed INI data.
+     * Tokenizers hand over pointers into the arena; finish() sorts sections and pairs,
+     * merges duplicate sections and keeps the first occurrence of every key.
      */
-    std::map<std::string, std::map<std::string, std::string>> getParsedDataFromIniFile(const std::string& configIniPath) {
-        auto fileMutex = getFileMutex(configIniPath);
-        std::shared_lock<std::shared_mutex> lock(*fileMutex);
-    
-        std::map<std::string, std::map<std::string, std::string>> parsedData;
-    
-    #if !USING_FSTREAM_DIRECTIVE
-        FILE* file = fopen(configIniPath.c_str(), "r");
-        if (!file) {
-            return parsedData;
+    struct FlatIniBuilder {
+        using Span = FlatIniData::Span;
+
+        struct RawPair {
+            FlatIniData::Span section;
+            FlatIniData::Span key;
+            FlatIniData::Span value;
+        };
+
+        FlatIniData& target;
+        std::vector<FlatIniData::Span> rawSections;
+        std::vector<RawPair> rawPairs;
+
+        FlatIniBuilder(FlatIniData& target, std::string contents) : target(target) {
+            target = FlatIniData();
+            target.arena = std::move(contents);
         }
-        
-        char buffer[1024];
-        std::string key, value;
-        key.reserve(64);
-        value.reserve(256);
-        
-        std::map<std::string, std::string>* currentSectionMap = nullptr;
-        
-        while (fgets(buffer, sizeof(buffer), file)) {
-            size_t len = strlen(buffer);
-            
-            // Strip trailing newline/carriage return
-            if (len > 0 && buffer[len-1] == '\n') {
-                if (--len > 0 && buffer[len-1] == '\r') --len;
-            }
-            
-            if (len == 0) continue;
-            
-            // Trim whitespace
-            const char* start = buffer;
-            const char* end = buffer + len;
-            
-            while (start < end && (*start == ' ' || *start == '\t')) ++start;
-            while (end > start && (end[-1] == ' ' || end[-1] == '\t')) --end;
-            
-            if (start >= end) continue;
-            
-            // Section header
-            if (*start == '[' && end[-1] == ']') {
-                if (end - start > 2) {
-                    currentSectionMap = &parsedData[std::string(start + 1, end - 1)];
-                }
-            } else if (currentSectionMap) {
-                // Find '=' delimiter
-                const char* eq = start;
-                while (eq < end && *eq != '=') ++eq;
-                
-                if (eq < end) {
-                    // Trim key
-                    const char* key_end = eq;
-                    while (key_end > start && (key_end[-1] == ' ' || key_end[-1] == '\t')) --key_end;
-                    
-                    if (key_end > start) {
-                        // Trim value
-                        const char* val_start = eq + 1;
-                        while (val_start < end && (*val_start == ' ' || *val_start == '\t')) ++val_start;
-                        
-                        currentSectionMap->emplace(
-                            std::piecewise_construct,
-                            std::forward_as_tuple(start, key_end),
-                            std::forward_as_tuple(val_start, end)
-                        );
-                    }
-                }
-            }
+
+        const char* begin() const { return target.arena.data(); }
+        const char* end() const { return target.arena.data() + target.arena.size(); }
+
+        FlatIniData::Span span(const char* begin, const char* end) const {
+            return FlatIniData::Span{
+                static_cast<uint32_t>(begin - target.arena.data()),
+                static_cast<uint32_t>(end - begin)
+            };
         }
-    
-        fclose(file);
-    #else
-        std::ifstream configFile(configIniPath);
-        if (!configFile) {
-            return parsedData;
+
+        // Records a header in file order without opening a section
+        void addHeader(const char* begin, const char* end) {
+            target.headers.push_back(span(begin, end));
         }
-        
-        std::string line;
-        line.reserve(256);
-        
-        std::map<std::string, std::string>* currentSectionMap = nullptr;
-    
-        while (getline(configFile, line)) {
-            // Strip carriage return
-            if (!line.empty() && line.back() == '\r') {
-                line.pop_back();
-            }
-            
-            if (line.empty()) continue;
-            
-            // Trim using pointers for speed
-            const char* start = line.c_str();
-            const char* end = start + line.length();
-            
-            while (start < end && (*start == ' ' || *start == '\t')) ++start;
-            while (end > start && (end[-1] == ' ' || end[-1] == '\t')) --end;
-            
-            if (start >= end) continue;
-            
-            // Section header
-            if (*start == '[' && end[-1] == ']') {
-                if (end - start > 2) {
-                    currentSectionMap = &parsedData[std::string(start + 1, end - 1)];
-                }
-            } else if (currentSectionMap) {
-                // Find '=' delimiter
-                const char* eq = start;
-                while (eq < end && *eq != '=') ++eq;
-                
-                if (eq < end) {
-                    // Trim key
-                    const char* key_end = eq;
-                    while (key_end > start && (key_end[-1] == ' ' || key_end[-1] == '\t')) --key_end;
-                    
-                    if (key_end > start) {
-                        // Trim value
-                        const char* val_start = eq + 1;
-                        while (val_start < end && (*val_start == ' ' || *val_start == '\t')) ++val_start;
-                        
-                        currentSectionMap->emplace(
-                            std::piecewise_construct,
-                            std::forward_as_tuple(start, key_end),
-                            std::forward_as_tuple(val_start, end)
-                        );
-                    }
+
+        FlatIniData::Span addSection(const char* begin, const char* end) {
+            rawSections.push_back(span(begin, end));
+            return rawSections.back();
+        }
+
+        void addPair(const FlatIniData::Span& section, const char* keyBegin, const char* keyEnd, const char* valueBegin, const char* valueEnd) {
+            rawPairs.push_back(RawPair{section, span(keyBegin, keyEnd), span(valueBegin, valueEnd)});
+        }
+
+        void finish() {
+            const auto less = [this](const FlatIniData::Span& a, const FlatIniData::Span& b) {
+                return target.view(a) < target.view(b);
+            };
+            const auto equal = [this](const FlatIniData::Span& a, const FlatIniData::Span& b) {
+                return target.view(a) == target.view(b);
+            };
+
+            std::sort(rawSections.begin(), rawSections.end(), less);
+            rawSections.erase(std::unique(rawSections.begin(), rawSections.end(), equal), rawSections.end());
+
+            // Stable so that the first occurrence of a duplicate key survives unique()
+            std::stable_sort(rawPairs.begin(), rawPairs.end(), [&](const RawPair& a, const RawPair& b) {
+                const int cmp = target.view(a.section).compare(target.view(b.section));
+                return cmp < 0 || (cmp == 0 && less(a.key, b.key));
+            });
+            rawPairs.erase(std::unique(rawPairs.begin(), rawPairs.end(), [&](const RawPair& a, const RawPair& b) {
+                return equal(a.section, b.section) && equal(a.key, b.key);
+            }), rawPairs.end());
+
+            target.sections.clear();
+            target.sections.reserve(rawSections.size());
+            target.pairs.clear();
+            target.pairs.reserve(rawPairs.size());
+
+            size_t pairIndex = 0;
+            for (const FlatIniData::Span& name : rawSections) {
+                FlatIniData::Section section;
+                section.name = name;
+                section.firstPair = static_cast<uint32_t>(target.pairs.size());
+                while (pairIndex < rawPairs.size() && equal(rawPairs[pairIndex].section, name)) {
+                    target.pairs.push_back(FlatIniData::Pair{rawPairs[pairIndex].key, rawPairs[pairIndex].value});
+                    ++pairIndex;
                 }
+                section.pairCount = static_cast<uint32_t>(target.pairs.size()) - section.firstPair;
+                target.sections.push_back(section);
             }
+
+            target.headers.shrink_to_fit();
         }
-        
-        configFile.close();
-    #endif
-    
-        return parsedData;
+    };
+
+    const FlatIniData::Section* FlatIniData::findSection(std::string_view sectionName) const {
+        const auto it = std::lower_bound(sections.begin(), sections.end(), sectionName,
+            [this](const Section& section, std::string_view name) {
+                return view(section.name) < name;
+            });
+        if (it == sections.end() || view(it->name) != sectionName) {
+            return nullptr;
+        }
+        return &*it;
     }
-    
-        
-    
-    /**
-     * @brief Parses an INI file and retrieves key-value pairs from a specific section.
-     *
-     * This function reads the contents of an INI file located at the specified path,
-     * and returns the key-value pairs within a specific section.
-     *
-     * @param configIniPath The path to the INI file to be parsed.
-     * @param sectionName The name of the section to retrieve key-value pairs from.
-     * @return A map representing the key-value pairs in the specified section.
-     */
-    std::map<std::string, std::string> getKeyValuePairsFromSection(const std::string& configIniPath, const std::string& sectionName) {
-        auto fileMutex = getFileMutex(configIniPath);
-        std::shared_lock<std::shared_mutex> lock(*fileMutex);
-    
-        std::map<std::string, std::string> sectionData;
-    
-    #if !USING_FSTREAM_DIRECTIVE
-        FILE* file = fopen(configIniPath.c_str(), "r");
-        if (!file) {
-            return sectionData;
+
+    bool FlatIniData::hasSection(std::string_view sectionName) const {
+        return findSection(sectionName) != nullptr;
+    }
+
+    bool FlatIniData::find(std::string_view sectionName, std::string_view key, std::string_view& value) const {
+        const Section* section = findSection(sectionName);
+        if (!section) {
+            return false;
         }
-        
-        char buffer[1024];
-        std::string line;
-        line.reserve(256);
-        
-        std::string key, value;
-        key.reserve(64);
-        value.reserve(128);
-        
-        bool inTargetSection = false;
-        size_t len, delimiterPos;
-    
-        while (fgets(buffer, sizeof(buffer), file)) {
-            // Remove newline characters
-            len = strlen(buffer);
-            if (len > 0 && buffer[len-1] == '\n') {
-                buffer[--len] = '\0';
-                if (len > 0 && buffer[len-1] == '\r') {
-                    buffer[--len] = '\0';
-                }
+
+        const auto first = pairs.begin() + section->firstPair;
+        const auto last = first + section->pairCount;
+        const auto it = std::lower_bound(first, last, key, [this](const Pair& pair, std::string_view name) {
+            return view(pair.key) < name;
+        });
+        if (it == last || view(it->key) != key) {
+            return false;
+        }
+
+        value = view(it->value);
+        return true;
+    }
+
+    std::string FlatIniData::get(std::string_view sectionName, std::string_view key) const {
+        std::string_view value;
+        return find(sectionName, key, value) ? std::string(value) : std::string();
+    }
+
+    size_t FlatIniData::memoryUsage() const {
+        return sizeof(FlatIniData) + arena.capacity() +
+               sections.capacity() * sizeof(Section) +
+               pairs.capacity() * sizeof(Pair) +
+               headers.capacity() * sizeof(Span);
+    }
+
+    std::map<std::string, std::map<std::string, std::string>> FlatIniData::toMap() const {
+        std::map<std::string, std::map<std::string, std::string>> result;
+        for (const Section& section : sections) {
+            auto& sectionMap = result.emplace_hint(result.end(), view(section.name), std::map<std::string, std::string>{})->second;
+            for (uint32_t i = section.firstPair, end = section.firstPair + section.pairCount; i < end; ++i) {
+                sectionMap.emplace_hint(sectionMap.end(), view(pairs[i].key), view(pairs[i].value));
             }
-            
-            line.assign(buffer);
-            trim(line);
-            
-            if (line.empty()) continue;
-            
-            if (line[0] == '[' && line.back() == ']') {
-                // Compare section directly without extraction
-                inTargetSection = (line.size() - 2 == sectionName.size() && 
-                                 line.compare(1, line.size() - 2, sectionName) == 0);
-                
-                if (!inTargetSection && !sectionData.empty()) {
-                    break;
-                }
-            } else if (inTargetSection) {
-                delimiterPos = line.find('=');
-                if (delimiterPos != std::string::npos) {
-                    key.assign(line, 0, delimiterPos);
-                    trim(key);
-                    value.assign(line, delimiterPos + 1, std::string::npos);
-                    trim(value);
-                    sectionData[std::move(key)] = std::move(value);
+        }
+        return result;
+    }
+
+    std::map<std::string, std::string> FlatIniData::sectionToMap(std::string_view sectionName) const {
+        std::map<std::string, std::string> result;
+        forEachPair(sectionName, [&result](std::string_view key, std::string_view value) {
+            result.emplace_hint(result.end(), key, value);
+        });
+        return result;
+    }
+
+
+    size_t INI_CACHE_BUDGET = 65536;
+    size_t INI_PATCH_MIN_SIZE = 4096;
+    // INI document cache infrastructure
+    namespace {
+        // Parsed view of a whole INI file, validated against the file's size and mtime
+        struct IniDocument {
+            long long fileSize = 0;
+            long long fileTime = 0;
+            size_t footprint = 0;
+            FlatIniData data;
+        };
+
+        struct IniCacheEntry {
+            std::shared_ptr<const IniDocument> document;
+            uint64_t lastUse = 0;
+        };
+
+        std::unordered_map<std::string, IniCacheEntry> iniCache;
+        std::mutex iniCacheMutex;
+        size_t iniCacheBytes = 0;
+        uint64_t iniCacheClock = 0;
+
+        std::atomic<size_t> iniCacheHits{0};
+        std::atomic<size_t> iniCacheMisses{0};
+        std::atomic<size_t> iniCacheEvictions{0};
+
+        /**
+         * @brief Builds the section/key index of an INI document from raw file bytes.
+         *
+         * Lines are trimmed of spaces and tabs, empty "[]" headers do not open a section,
+         * and the first occurrence of a key within a section wins.
+         */
+        void indexIniDocument(std::string contents, IniDocument& document) {
+            FlatIniBuilder builder(document.data, std::move(contents));
+
+            const char* lineStart = builder.begin();
+            const char* const dataEnd = builder.end();
+            const char* lineEnd;
+            const char* start;
+            const char* end;
+
+            FlatIniBuilder::Span currentSection;
+            bool inSection = false;
+
+            while (lineStart < dataEnd) {
+                lineEnd = static_cast<const char*>(std::memchr(lineStart, '\n', dataEnd - lineStart));
+                if (!lineEnd) lineEnd = dataEnd;
+
+                start = lineStart;
+                end = lineEnd;
+                lineStart = (lineEnd < dataEnd) ? lineEnd + 1 : dataEnd;
+
+                while (start < end && (*start == ' ' || *start == '\t')) ++start;
+                while (end > start && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) --end;
+
+                if (start >= end) continue;
+
+                // Section header
+                if (*start == '[' && end[-1] == ']') {
+                    builder.addHeader(start + 1, end - 1);
+                    if (end - start > 2) {
+                        currentSection = builder.addSection(start + 1, end - 1);
+                        inSection = true;
+                    }
+                } else if (inSection) {
+                    // Find '=' delimiter
+                    const char* eq = static_cast<const char*>(std::memchr(start, '=', end - start));
+                    if (!eq) continue;
+
+                    // Trim key
+                    const char* keyEnd = eq;
+                    while (keyEnd > start && (keyEnd[-1] == ' ' || keyEnd[-1] == '\t')) --keyEnd;
+                    if (keyEnd == start) continue;
+
+                    // Trim value
+                    const char* valStart = eq + 1;
+                    while (valStart < end && (*valStart == ' ' || *valStart == '\t')) ++valStart;
+
+                    builder.addPair(currentSection, start, keyEnd, valStart, end);
                 }
             }
+
+            builder.finish();
+            document.footprint = sizeof(IniDocument) + document.data.memoryUsage() - sizeof(FlatIniData);
         }
-        
-        fclose(file);
-    #else
-        std::ifstream configFile(configIniPath);
-        if (!configFile) {
-            return sectionData;
+
+        /**
+         * @brief Reads and indexes an INI file in a single bulk read.
+         */
+        std::shared_ptr<IniDocument> loadIniDocument(const std::string& filePath, const struct stat& fileStat) {
+            auto document = std::make_shared<IniDocument>();
+            document->fileSize = static_cast<long long>(fileStat.st_size);
+            document->fileTime = static_cast<long long>(fileStat.st_mtime);
+
+            std::string contents(static_cast<size_t>(fileStat.st_size), '\0');
+
+        #if !USING_FSTREAM_DIRECTIVE
+            FILE* file = fopen(filePath.c_str(), "rb");
+            if (!file) {
+                return nullptr;
+            }
+            const size_t bytesRead = fread(contents.data(), 1, contents.size(), file);
+            fclose(file);
+        #else
+            std::ifstream file(filePath, std::ios::binary);
+            if (!file) {
+                return nullptr;
+            }
+            file.read(contents.data(), contents.size());
+            const size_t bytesRead = static_cast<size_t>(file.gcount());
+            file.close();
+        #endif
+            contents.resize(bytesRead);
+            recordIniRead(bytesRead, 1);
+
+            indexIniDocument(std::move(contents), *document);
+            return document;
         }
-    
-        std::string line;
-        line.reserve(256);
-        
-        std::string key, value;
-        key.reserve(64);
-        value.reserve(128);
-        
-        bool inTargetSection = false;
-        size_t delimiterPos;
-    
-        while (getline(configFile, line)) {
-            if (!line.empty() && line.back() == '\r') {
-                line.pop_back();
-            }
-            
-            trim(line);
-            
-            if (line.empty()) continue;
-            
-            if (line[0] == '[' && line.back() == ']') {
-                inTargetSection = (line.size() - 2 == sectionName.size() && 
-                                 line.compare(1, line.size() - 2, sectionName) == 0);
-                
-                if (!inTargetSection && !sectionData.empty()) {
-                    break;
-                }
-            } else if (inTargetSection) {
-                delimiterPos = line.find('=');
-                if (delimiterPos != std::string::npos) {
-                    key.assign(line, 0, delimiterPos);
-                    trim(key);
-                    value.assign(line, delimiterPos + 1, std::string::npos);
-                    trim(value);
-                    sectionData[std::move(key)] = std::move(value);
+
+        // Drops least recently used entries until `incoming` more bytes fit the budget.
+        // Caller must hold iniCacheMutex.
+        void evictIniCacheFor(size_t incoming) {
+            while (!iniCache.empty() && iniCacheBytes + incoming > INI_CACHE_BUDGET) {
+                auto oldest = iniCache.begin();
+                for (auto it = std::next(oldest); it != iniCache.end(); ++it) {
+                    if (it->second.lastUse < oldest->second.lastUse) oldest = it;
                 }
+                iniCacheBytes -= oldest->second.document->footprint;
+                iniCache.erase(oldest);
+                iniCacheEvictions.fetch_add(1, std::memory_order_relaxed);
             }
         }
-    #endif
-    
-        return sectionData;
-    }
-    
-    
-    
-    /**
-     * @brief Parses sections from an INI file and returns them as a list of strings.
-     *
-     * This function reads an INI file and extracts the section names from it.
-     *
-     * @param filePath The path to the INI file.
-     * @return A vector of section names.
-     */
-    std::vector<std::string> parseSectionsFromIni(const std::string& filePath) {
-        auto fileMutex = getFileMutex(filePath);
-        std::shared_lock<std::shared_mutex> lock(*fileMutex);
 
-        std::vector<std::string> sections;
-    
-    #if !USING_FSTREAM_DIRECTIVE
-        FILE* file = fopen(filePath.c_str(), "r");
-        if (!file) {
-            return sections;
-        }
-    
-        char buffer[1024];
-        std::string line;
-        //line.reserve(1024); // Add reservation for efficiency
-        
-        size_t len;
-        std::string sectionName;
-        while (fgets(buffer, sizeof(buffer), file)) {
-            // CRITICAL FIX: Remove newlines from fgets
-            len = strlen(buffer);
-            if (len > 0 && buffer[len-1] == '\n') {
-                buffer[len-1] = '\0';
-                if (len > 1 && buffer[len-2] == '\r') {
-                    buffer[len-2] = '\0';
+        /**
+         * @brief Returns the cached index for an INI file, (re)loading it when stale.
+         *
+         * Caller must hold the file's shared or unique lock so that mutators in this
+         * file cannot race the reload. Returns nullptr if the file cannot be read.
+         *
+         * When `uncacheable` is given, a file too large for INI_CACHE_BUDGET is not read at
+         * all: nullptr is returned with `*uncacheable` set so the caller can stream it instead.
+         * Files modified within the racy window are loaded but never cached.
+         */
+        std::shared_ptr<const IniDocument> acquireIniDocument(const std::string& filePath, bool* uncacheable = nullptr) {
+            if (uncacheable) *uncacheable = false;
+
+            struct stat fileStat;
+            if (stat(filePath.c_str(), &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) {
+                invalidateIniCache(filePath);
+                return nullptr;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(iniCacheMutex);
+                auto it = iniCache.find(filePath);
+                if (it != iniCache.end()) {
+                    const auto& document = it->second.document;
+                    if (document->fileSize == static_cast<long long>(fileStat.st_size) &&
+                        document->fileTime == static_cast<long long>(fileStat.st_mtime)) {
+                        it->second.lastUse = ++iniCacheClock;
+                        iniCacheHits.fetch_add(1, std::memory_order_relaxed);
+                        return document;
+                    }
+                    iniCacheBytes -= document->footprint;
+                    iniCache.erase(it);
                 }
             }
-            
-            line.assign(buffer); // More efficient than string constructor
-            trim(line);
-            
-            // Check if the line contains a section header
-            if (!line.empty() && line.front() == '[' && line.back() == ']') {
-                sectionName.assign(line, 1, line.size() - 2); // More efficient
-                sections.push_back(std::move(sectionName)); // Move for efficiency
+
+            iniCacheMisses.fetch_add(1, std::memory_order_relaxed);
+            if (uncacheable && static_cast<size_t>(fileStat.st_size) > INI_CACHE_BUDGET) {
+                *uncacheable = true; // The indexed form can only be larger than the file
+                return nullptr;
             }
 
-            // Clear strings to reuse capacity
-            line.clear();
-            sectionName.clear();
-        }
-    
-        fclose(file);
-    #else
-        std::ifstream file(filePath);
-        if (!file) {
-            return sections;
-        }
-    
-        std::string line;
-        //line.reserve(1024); // Add reservation for efficiency
-        
-        std::string sectionName;
-        while (std::getline(file, line)) {
-            // Remove carriage return if present
-            if (!line.empty() && line.back() == '\r') {
-                line.pop_back();
+            std::shared_ptr<const IniDocument> document = loadIniDocument(filePath, fileStat);
+            if (!document || document->footprint > INI_CACHE_BUDGET ||
+                isRacyFileTime(document->fileTime)) {
+                return document; // Too large to keep, or may still change unseen; serve it uncached
             }
-            
-            trim(line);
-            
-            // Check if the line contains a section header
-            if (!line.empty() && line.front() == '[' && line.back() == ']') {
-                sectionName.assign(line, 1, line.size() - 2);
-                sections.push_back(std::move(sectionName));
+
+            std::lock_guard<std::mutex> lock(iniCacheMutex);
+            auto it = iniCache.find(filePath);
+            if (it != iniCache.end()) {
+                iniCacheBytes -= it->second.document->footprint;
+                iniCache.erase(it);
             }
-            // Clear strings to reuse capacity
-            line.clear();
-            sectionName.clear();
+            evictIniCacheFor(document->footprint);
+            iniCache.emplace(filePath, IniCacheEntry{document, ++iniCacheClock});
+            iniCacheBytes += document->footprint;
+            return document;
         }
-        
-        file.close(); // Add explicit close
-    #endif
-    
-        return sections;
-    }
-    
-    
-    
-    /**
-     * @brief Parses a specific value from a section and key in an INI file.
-     *
-     * @param filePath The path to the INI file.
-     * @param sectionName The name of the section containing the desired key.
-     * @param keyName The name of the key whose value is to be retrieved.
-     * @return The value as a string, or an empty string if the key or section isn't found.
-     */
-    std::string parseValueFromIniSection(const std::string& filePath, const std::string& sectionName, const std::string& keyName) {
-        auto fileMutex = getFileMutex(filePath);
-        std::shared_lock<std::shared_mutex> lock(*fileMutex);
-    
-        std::string value;
-    
-    #if !USING_FSTREAM_DIRECTIVE
-        FILE* file = fopen(filePath.c_str(), "r");
-        if (!file) {
-            return value;
+
+        // A section header line and where its body starts
+        struct IniSectionHeader {
+            std::string name;       // Text between the brackets of the whitespace-trimmed line
+            uint64_t lineStart = 0; // Offset of the header line
+            uint64_t bodyStart = 0; // Offset just past the header line
+            bool strict = false;    // '[' in column 0, ']' last (before an optional '\r'), non-empty name
+        };
+
+        // Every section header of an INI file, validated against the file's size and mtime
+        struct IniSectionIndex {
+            long long fileSize = 0;
+            long long fileTime = 0;
+            std::vector<IniSectionHeader> headers;
+        };
+
+        struct SectionIndexEntry {
+            std::shared_ptr<const IniSectionIndex> index;
+            uint64_t lastUse = 0;
+        };
+
+        constexpr size_t SECTION_INDEX_CAPACITY = 16;
+        constexpr size_t SECTION_INDEX_CHUNK = 16384;
+
+        std::unordered_map<std::string, SectionIndexEntry> sectionIndexCache;
+        std::mutex sectionIndexMutex;
+        uint64_t sectionIndexClock = 0;
+
+        void indexSectionHeaderLine(const char* lineBegin, const char* lineEnd, uint64_t lineStart, uint64_t bodyStart, IniSectionIndex& index) {
+            const char* start = lineBegin;
+            const char* end = lineEnd;
+            while (start < end && std::isspace(static_cast<unsigned char>(*start))) ++start;
+            while (end > start && std::isspace(static_cast<unsigned char>(end[-1]))) --end;
+            if (end - start < 2 || *start != '[' || end[-1] != ']') return;
+
+            const char* rawEnd = lineEnd;
+            if (rawEnd > lineBegin && rawEnd[-1] == '\r') --rawEnd;
+
+            IniSectionHeader header;
+            header.name.assign(start + 1, end - 1);
+            header.lineStart = lineStart;
+            header.bodyStart = bodyStart;
+            header.strict = (start == lineBegin && end == rawEnd && end - start > 2);
+            index.headers.push_back(std::move(header));
         }
-    
-        char buffer[1024];
-        bool inTargetSection = false;
-        
-        while (fgets(buffer, sizeof(buffer), file)) {
-            size_t len = strlen(buffer);
-            
-            // Strip trailing newline/carriage return
-            if (len > 0 && buffer[len-1] == '\n') {
-                if (--len > 0 && buffer[len-1] == '\r') --len;
-            }
-            
-            if (len == 0) continue;
-            
-            // Trim whitespace
-            const char* start = buffer;
-            const char* end = buffer + len;
-            
-            while (start < end && (*start == ' ' || *start == '\t')) ++start;
-            while (end > start && (end[-1] == ' ' || end[-1] == '\t')) --end;
-            
-            if (start >= end) continue;
-            
-            // Section header
-            if (*start == '[' && end[-1] == ']') {
-                if (end - start > 2) {
-                    // Compare directly without constructing string
-                    const size_t sectionLen = end - start - 2;
-                    inTargetSection = (sectionLen == sectionName.length() && 
-                                       std::memcmp(start + 1, sectionName.data(), sectionLen) == 0);
-                    
-                    // Early exit: left target section without finding key
-                    if (!inTargetSection && value.empty() && sectionLen > 0) {
-                        // We passed a different section; if we already processed target, we're done
-                        // This is implicit - if inTargetSection was true before and now false, we already found it or it doesn't exist
-                        continue;
-                    }
+
+        /**
+         * @brief Scans an INI file in fixed-size chunks and records every section header.
+         */
+        std::shared_ptr<IniSectionIndex> buildSectionIndex(const std::string& filePath, const struct stat& fileStat) {
+        #if !USING_FSTREAM_DIRECTIVE
+            FILE* file = fopen(filePath.c_str(), "rb");
+            if (!file) return nullptr;
+        #else
+            std::ifstream file(filePath, std::ios::binary);
+            if (!file) return nullptr;
+        #endif
+
+            recordIniRead(0, 1);
+
+            auto index = std::make_shared<IniSectionIndex>();
+            index->fileSize = static_cast<long long>(fileStat.st_size);
+            index->fileTime = static_cast<long long>(fileStat.st_mtime);
+
+            std::vector<char> buffer(SECTION_INDEX_CHUNK);
+            size_t carry = 0;
+            uint64_t bufferOffset = 0;  // File offset of buffer[0]
+
+            while (true) {
+            #if !USING_FSTREAM_DIRECTIVE
+                const size_t bytesRead = fread(buffer.data() + carry, 1, buffer.size() - carry, file);
+            #else
+                file.read(buffer.data() + carry, buffer.size() - carry);
+                const size_t bytesRead = static_cast<size_t>(file.gcount());
+            #endif
+                recordIniRead(bytesRead);
+                const size_t available = carry + bytesRead;
+                const char* const data = buffer.data();
+                const char* lineBegin = data;
+                const char* const dataEnd = data + available;
+                const char* lineEnd;
+
+                while ((lineEnd = static_cast<const char*>(std::memchr(lineBegin, '\n', dataEnd - lineBegin)))) {
+                    indexSectionHeaderLine(lineBegin, lineEnd, bufferOffset + (lineBegin - data),
+                                           bufferOffset + (lineEnd - data) + 1, *index);
+                    lineBegin = lineEnd + 1;
                 }
-            } else if (inTargetSection) {
-                // Find '=' delimiter
-                const char* eq = start;
-                while (eq < end && *eq != '=') ++eq;
-                
-                if (eq < end) {
-                    // Trim key
-                    const char* key_end = eq;
-                    while (key_end > start && (key_end[-1] == ' ' || key_end[-1] == '\t')) --key_end;
-                    
-                    if (key_end > start) {
-                        const size_t keyLen = key_end - start;
-                        
-                        // Compare directly without constructing string
-                        if (keyLen == keyName.length() && std::memcmp(start, keyName.data(), keyLen) == 0) {
-                            // Trim value
-                            const char* val_start = eq + 1;
-                            while (val_start < end && (*val_start == ' ' || *val_start == '\t')) ++val_start;
-                            
-                            value.assign(val_start, end);
-                            break; // Found it, exit immediately
-                        }
+
+                if (bytesRead == 0) {
+                    // Final line without a trailing newline
+                    if (lineBegin < dataEnd) {
+                        indexSectionHeaderLine(lineBegin, dataEnd, bufferOffset + (lineBegin - data),
+                                               bufferOffset + available, *index);
                     }
+                    break;
+                }
+
+                carry = static_cast<size_t>(dataEnd - lineBegin);
+                bufferOffset += static_cast<uint64_t>(lineBegin - data);
+                std::memmove(buffer.data(), lineBegin, carry);
+                if (carry == buffer.size()) {
+                    buffer.resize(buffer.size() * 2);  // Line longer than the buffer
                 }
             }
+
+        #if !USING_FSTREAM_DIRECTIVE
+            fclose(file);
+        #else
+            file.close();
+        #endif
+
+            index->headers.shrink_to_fit();
+            return index;
         }
-    
-        fclose(file);
-    #else
-        std::ifstream file(filePath);
-        if (!file) {
-            return value;
-        }
-        
-        std::string line;
-        line.reserve(256);
-        bool inTargetSection = false;
-    
-        while (std::getline(file, line)) {
-            if (!line.empty() && line.back() == '\r') {
-                line.pop_back();
+
+        /**
+         * @brief Returns the section index of an INI file, rebuilding it when stale.
+         *
+         * Caller must hold the file's shared or unique lock. Returns nullptr if the file
+         * cannot be read. An index of a file modified within the racy window is not kept.
+         */
+        std::shared_ptr<const IniSectionIndex> acquireSectionIndex(const std::string& filePath) {
+            struct stat fileStat;
+            if (stat(filePath.c_str(), &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) {
+                return nullptr;
             }
-            
-            if (line.empty()) continue;
-            
-            // Trim using pointers
-            const char* start = line.c_str();
-            const char* end = start + line.length();
-            
-            while (start < end && (*start == ' ' || *start == '\t')) ++start;
-            while (end > start && (end[-1] == ' ' || end[-1] == '\t')) --end;
-            
-            if (start >= end) continue;
-            
-            // Section header
-            if (*start == '[' && end[-1] == ']') {
-                if (end - start > 2) {
-                    size_t sectionLen = end - start - 2;
-                    inTargetSection = (sectionLen == sectionName.length() && 
-                                       std::memcmp(start + 1, sectionName.data(), sectionLen) == 0);
+
+            {
+                std::lock_guard<std::mutex> lock(sectionIndexMutex);
+                auto it = sectionIndexCache.find(filePath);
+                if (it != sectionIndexCache.end() &&
+                    it->second.index->fileSize == static_cast<long long>(fileStat.st_size) &&
+                    it->second.index->fileTime == static_cast<long long>(fileStat.st_mtime)) {
+                    it->second.lastUse = ++sectionIndexClock;
+                    return it->second.index;
                 }
-            } else if (inTargetSection) {
-                // Find '=' delimiter
-                const char* eq = start;
-                while (eq < end && *eq != '=') ++eq;
-                
-                if (eq < end) {
-                    // Trim key
-                    const char* key_end = eq;
-                    while (key_end > start && (key_end[-1] == ' ' || key_end[-1] == '\t')) --key_end;
-                    
-                    if (key_end > start) {
-                        size_t keyLen = key_end - start;
-                        
-                        // Compare directly without constructing string
-                        if (keyLen == keyName.length() && std::memcmp(start, keyName.data(), keyLen) == 0) {
-                            // Trim value
-                            const char* val_start = eq + 1;
-                            while (val_start < end && (*val_start == ' ' || *val_start == '\t')) ++val_start;
-                            
-                            value.assign(val_start, end);
-                            break; // Found it, exit immediately
+            }
+
+            std::shared_ptr<const IniSectionIndex> index = buildSectionIndex(filePath, fileStat);
+            if (!index || isRacyFileTime(index->fileTime)) return index;
+
+            std::lock_guard<std::mutex> lock(sectionIndexMutex);
+            sectionIndexCache.erase(filePath);
+            if (sectionIndexCache.size() >= SECTION_INDEX_CAPACITY) {
+                auto oldest = sectionIndexCache.begin();
+                for (auto it = std::next(oldest); it != sectionIndexCache.end(); ++it) {
+                    if (it->second.lastUse < oldest->second.lastUse) oldest = it;
+                }
+                sectionIndexCache.erase(oldest);
+            }
+            sectionIndexCache.emplace(filePath, SectionIndexEntry{index, ++sectionIndexClock});
+            return index;
+        }
+
+        /**
+         * @brief Reads the byte range [begin, end) of a file, clamped to end of file.
+         */
+        bool readIniFileRange(const std::string& filePath, uint64_t begin, uint64_t end, std::string& contents) {
+            contents.clear();
+            if (end <= begin) return true;
+
+        #if !USING_FSTREAM_DIRECTIVE
+            FILE* file = fopen(filePath.c_str(), "rb");
+            if (!file) return false;
+            if (fseek(file, static_cast<long>(begin), SEEK_SET) != 0) {
+                fclose(file);
+                return false;
+            }
+            contents.resize(static_cast<size_t>(end - begin));
+            contents.resize(fread(contents.data(), 1, contents.size(), file));
+            fclose(file);
+        #else
+            std::ifstream file(filePath, std::ios::binary);
+            if (!file) return false;
+            file.seekg(static_cast<std::streamoff>(begin));
+            contents.resize(static_cast<size_t>(end - begin));
+            file.read(contents.data(), contents.size());
+            contents.resize(static_cast<size_t>(file.gcount()));
+            file.close();
+        #endif
+            recordIniRead(contents.size(), 1);
+            return true;
+        }
+
+        constexpr size_t INI_STREAM_CHUNK = 16384;
+
+        /**
+         * @brief Answers lookups by streaming a file that is too large for the document cache.
+         *
+         * Follows the parsing rules of indexIniDocument (duplicate sections merge, the first
+         * occurrence of a key wins) and stops reading once every lookup has been found.
+         * Returns false if the file cannot be opened.
+         */
+        bool streamIniLookups(const std::string& filePath, std::vector<IniLookup>& lookups) {
+            for (IniLookup& lookup : lookups) {
+                lookup.value.clear();
+                lookup.found = false;
+                lookup.sectionFound = false;
+            }
+
+        #if !USING_FSTREAM_DIRECTIVE
+            FILE* file = fopen(filePath.c_str(), "rb");
+            if (!file) return false;
+        #else
+            std::ifstream file(filePath, std::ios::binary);
+            if (!file) return false;
+        #endif
+
+            recordIniRead(0, 1);
+
+            std::vector<char> inSection(lookups.size(), 0);  // Lookups whose section is the current one
+            bool anyInSection = false;
+            size_t remaining = lookups.size();
+
+            // Returns true once every lookup has been answered
+            const auto processLine = [&](const char* start, const char* end) {
+                while (start < end && (*start == ' ' || *start == '\t')) ++start;
+                while (end > start && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) --end;
+                if (start >= end) return false;
+
+                if (*start == '[' && end[-1] == ']') {
+                    if (end - start > 2) {
+                        const std::string_view name(start + 1, static_cast<size_t>(end - start - 2));
+                        anyInSection = false;
+                        for (size_t i = 0; i < lookups.size(); ++i) {
+                            inSection[i] = (lookups[i].section == name);
+                            if (inSection[i]) {
+                                lookups[i].sectionFound = true;
+                                anyInSection = true;
+                            }
                         }
                     }
+                    return false;
+                }
+                if (!anyInSection) return false;
+
+                const char* eq = static_cast<const char*>(std::memchr(start, '=', end - start));
+                if (!eq) return false;
+
+                const char* keyEnd = eq;
+                while (keyEnd > start && (keyEnd[-1] == ' ' || keyEnd[-1] == '\t')) --keyEnd;
+                if (keyEnd == start) return false;
+                const std::string_view key(start, static_cast<size_t>(keyEnd - start));
+
+                const char* valStart = eq + 1;
+                while (valStart < end && (*valStart == ' ' || *valStart == '\t')) ++valStart;
+
+                for (size_t i = 0; i < lookups.size(); ++i) {
+                    if (inSection[i] && !lookups[i].found && lookups[i].key == key) {
+                        lookups[i].value.assign(valStart, end);
+                        lookups[i].found = true;
+                        --remaining;
+                    }
+                }
+                return remaining == 0;
+            };
+
+            std::vector<char> buffer(INI_STREAM_CHUNK);
+            size_t carry = 0;
+            bool done = (remaining == 0);
+
+            while (!done) {
+            #if !USING_FSTREAM_DIRECTIVE
+                const size_t bytesRead = fread(buffer.data() + carry, 1, buffer.size() - carry, file);
+            #else
+                file.read(buffer.data() + carry, buffer.size() - carry);
+                const size_t bytesRead = static_cast<size_t>(file.gcount());
+            #endif
+                recordIniRead(bytesRead);
+                const char* const data = buffer.data();
+                const char* const dataEnd = data + carry + bytesRead;
+                const char* lineBegin = data;
+                const char* lineEnd;
+
+                while (!done && (lineEnd = static_cast<const char*>(std::memchr(lineBegin, '\n', dataEnd - lineBegin)))) {
+                    done = processLine(lineBegin, lineEnd);
+                    lineBegin = lineEnd + 1;
+                }
+
+                if (done) break;
+                if (bytesRead == 0) {
+                    // Final line without a trailing newline
+                    if (lineBegin < dataEnd) processLine(lineBegin, dataEnd);
+                    break;
+                }
+
+                carry = static_cast<size_t>(dataEnd - lineBegin);
+                std::memmove(buffer.data(), lineBegin, carry);
+                if (carry == buffer.size()) {
+                    buffer.resize(buffer.size() * 2);  // Line longer than the buffer
                 }
             }
+
+        #if !USING_FSTREAM_DIRECTIVE
+            fclose(file);
+        #else
+            file.close();
+        #endif
+            return true;
         }
-        
-        file.close();
-    #endif
-    
-        return value;
     }
-        
+
     /**
-     * @brief Cleans the formatting of an INI file by removing empty lines and standardizing section formatting.
+     * @brief Drops the cached document and section index of a single INI file.
      *
-     * This function takes an INI file located at the specified path, removes empty lines,
-     * and standardizes the formatting of sections by ensuring that there is a newline
-     * between each section's closing ']' and the next section's opening '['.
+     * All INI mutators in this file call this after rewriting a file. Writers outside
+     * of ini_funcs are picked up by the size/mtime check on the next lookup.
      *
-     * @param filePath The path to the INI file to be cleaned.
+     * @param filePath The path to the INI file.
      */
-    void cleanIniFormatting(const std::string& filePath) {
-        auto fileMutex = getFileMutex(filePath);
-        std::unique_lock<std::shared_mutex> lock(*fileMutex);
-
-        const std::string tempPath = filePath + ".tmp";
-    
-    #if !USING_FSTREAM_DIRECTIVE
-        FILE* inputFile = fopen(filePath.c_str(), "r");
-        if (!inputFile) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Failed to open the input file: " + filePath);
-            #endif
-            return;
-        }
-    
-        FILE* outputFile = fopen(tempPath.c_str(), "w");
-        if (!outputFile) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Failed to create the output file: " + tempPath);
-            #endif
-            fclose(inputFile);
-            return;
-        }
-    
-        // Declare all variables outside the loop
-        char line[1024];
-        std::string lineStr;
-        //lineStr.reserve(1024);
-        
-        bool isNewSection = false;
-        bool isSection = false;
-        size_t len = 0;
-        
-        while (fgets(line, sizeof(line), inputFile)) {
-            // Efficient newline removal
-            len = strlen(line);
-            if (len > 0 && line[len-1] == '\n') {
-                line[len-1] = '\0';
-                if (len > 1 && line[len-2] == '\r') {
-                    line[len-2] = '\0';
-                }
-            }
-            
-            lineStr.assign(line);
-            trim(lineStr);
-    
-            if (!lineStr.empty()) {
-                isSection = (lineStr[0] == '[' && lineStr.back() == ']');
-                
-                if (isSection) {
-                    if (isNewSection) {
-                        fputc('\n', outputFile);
-                    }
-                    isNewSection = true;
-                }
-                
-                fputs(lineStr.c_str(), outputFile);
-                fputc('\n', outputFile);
+    void invalidateIniCache(const std::string& filePath) {
+        {
+            std::lock_guard<std::mutex> lock(iniCacheMutex);
+            auto it = iniCache.find(filePath);
+            if (it != iniCache.end()) {
+                iniCacheBytes -= it->second.document->footprint;
+                iniCache.erase(it);
             }
-            // Clear string to reuse capacity
-            lineStr.clear();
         }
-    
-        fclose(inputFile);
-        fclose(outputFile);
-    #else
-        std::ifstream inputFile(filePath);
-        if (!inputFile) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Failed to open the input file: " + filePath);
-            #endif
-            return;
-        }
-    
-        std::ofstream outputFile(tempPath);
-        if (!outputFile) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Failed to create the output file: " + tempPath);
-            #endif
-            return;
+        
+        std::lock_guard<std::mutex> lock(sectionIndexMutex);
+        sectionIndexCache.erase(filePath);
+    }
+
+    /**
+     * @brief Drops every cached INI document and section index and releases their memory.
+     */
+    void clearIniCache() {
+        {
+            std::lock_guard<std::mutex> lock(iniCacheMutex);
+            iniCache = {};
+            iniCacheBytes = 0;
         }
-    
-        // Declare all variables outside the loop
-        std::string line;
-        //line.reserve(1024);
         
-        bool isNewSection = false;
-        bool isSection = false;
-    
-        while (std::getline(inputFile, line)) {
-            // Remove carriage return if present
-            if (!line.empty() && line.back() == '\r') {
-                line.pop_back();
-            }
-            
-            trim(line);
-            
-            if (!line.empty()) {
-                isSection = (line[0] == '[' && line.back() == ']');
-                
-                if (isSection) {
-                    if (isNewSection) {
-                        outputFile << '\n';
-                    }
-                    isNewSection = true;
-                }
-                
-                outputFile << line << '\n';
+        std::lock_guard<std::mutex> lock(sectionIndexMutex);
+        sectionIndexCache = {};
+    }
+
+    /**
+     * @brief Returns a snapshot of the INI document cache counters.
+     */
+    IniCacheStats getIniCacheStats() {
+        IniCacheStats stats;
+        stats.hits = iniCacheHits.load(std::memory_order_relaxed);
+        stats.misses = iniCacheMisses.load(std::memory_order_relaxed);
+        stats.evictions = iniCacheEvictions.load(std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(iniCacheMutex);
+        stats.entries = iniCache.size();
+        stats.bytes = iniCacheBytes;
+        return stats;
+    }
+
+    /**
+     * @brief Resets the INI document cache hit/miss/eviction counters.
+     */
+    void resetIniCacheStats() {
+        iniCacheHits.store(0, std::memory_order_relaxed);
+        iniCacheMisses.store(0, std::memory_order_relaxed);
+        iniCacheEvictions.store(0, std::memory_order_relaxed);
+    }
+
+
+    size_t PACKAGE_SCAN_THREADS = 2;
+
+    // Package header scanning infrastructure
+    namespace {
+        constexpr size_t PACKAGE_HEADER_CHUNK = 4096;
+        constexpr uint32_t PACKAGE_HEADER_ALL_FIELDS = (1u << 9) - 1;
+
+        struct PackageHeaderCacheEntry {
+            long long fileSize = 0;
+            long long fileTime = 0;
+            PackageHeader header;
+        };
+
+        std::unordered_map<std::string, PackageHeaderCacheEntry> packageHeaderCache;
+        std::mutex packageHeaderCacheMutex;
+
+        /**
+         * @brief Maps a ";name=" comment prefix to its PackageHeader field.
+         *
+         * Dispatches on the first letter and the prefix length instead of comparing
+         * against every known prefix.
+         *
+         * @return The field, or nullptr if the line is not a header field; `prefixLength`
+         * and `fieldBit` describe the match.
+         */
+        std::string* matchPackageHeaderField(const char* line, size_t length, PackageHeader& header, size_t& prefixLength, uint32_t& fieldBit) {
+            if (length < 2) return nullptr;
+
+            const char* eq = static_cast<const char*>(std::memchr(line + 1, '=', length - 1));
+            if (!eq) return nullptr;
+
+            const std::string_view name(line + 1, eq - line - 1);
+            std::string* field = nullptr;
+
+            switch (name.size()) {
+                case 5:
+                    if (name == "title") { field = &header.title; fieldBit = 1u << 0; }
+                    else if (name == "about") { field = &header.about; fieldBit = 1u << 4; }
+                    else if (name == "color") { field = &header.color; fieldBit = 1u << 6; }
+                    break;
+                case 7:
+                    if (name == "version") { field = &header.version; fieldBit = 1u << 2; }
+                    else if (name == "creator") { field = &header.creator; fieldBit = 1u << 3; }
+                    else if (name == "credits") { field = &header.credits; fieldBit = 1u << 5; }
+                    break;
+                case 11:
+                    if (name == "show_widget") { field = &header.show_widget; fieldBit = 1u << 8; }
+                    break;
+                case 12:
+                    if (name == "show_version") { field = &header.show_version; fieldBit = 1u << 7; }
+                    break;
+                case 13:
+                    if (name == "display_title") { field = &header.display_title; fieldBit = 1u << 1; }
+                    break;
+                default:
+                    break;
             }
-            // Clear string to reuse capacity
-            line.clear();
+
+            if (field) prefixLength = name.size() + 2;  // ';' + name + '='
+            return field;
         }
-        
-        inputFile.close();
-        outputFile.close();
-    #endif
-    
-        // Replace the original file with the temp file with error checking
-        if (std::remove(filePath.c_str()) != 0) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Failed to delete the original file: " + filePath);
-            #endif
-            // Clean up temp file on error
-            std::remove(tempPath.c_str());
-            return;
+
+        // Stores the value after a header prefix: up to the next ';', trimmed and unquoted
+        void assignPackageHeaderValue(std::string& field, const char* start, const char* end) {
+            const char* stop = start;
+            while (stop < end && *stop != ';' && *stop != '\r') ++stop;
+            end = stop;
+
+            while (start < end && (*start == ' ' || *start == '\t')) ++start;
+            while (end > start && (end[-1] == ' ' || end[-1] == '\t')) --end;
+
+            if (end - start >= 2 &&
+                ((*start == '"' && end[-1] == '"') || (*start == '\'' && end[-1] == '\''))) {
+                ++start;
+                --end;
+            }
+
+            field.assign(start, end);
         }
-    
-        if (std::rename(tempPath.c_str(), filePath.c_str()) != 0) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Failed to rename the temporary file: " + tempPath);
+
+        /**
+         * @brief Reads the comment header of a package INI.
+         *
+         * The file is read in 4 KiB chunks and scanning stops at the first section header,
+         * at end of file, or once every field has been seen, so only the header region is
+         * ever read.
+         */
+        PackageHeader scanPackageHeader(const std::string& filePath) {
+            PackageHeader packageHeader;
+
+        #if !USING_FSTREAM_DIRECTIVE
+            FILE* file = fopen(filePath.c_str(), "rb");
+            if (!file) return packageHeader;
+        #else
+            std::ifstream file(filePath, std::ios::binary);
+            if (!file) return packageHeader;
+        #endif
+
+            recordIniRead(0, 1);
+
+            char buffer[PACKAGE_HEADER_CHUNK];
+            std::string carry;  // Partial line spanning two chunks
+            uint32_t fieldsFound = 0;
+            bool done = false;
+            size_t prefixLength;
+            uint32_t fieldBit;
+
+            auto processLine = [&](const char* line, size_t length) {
+                if (length == 0) return;
+                if (line[0] == '[') {
+                    done = true;  // Header region ends at the first section
+                    return;
+                }
+                if (line[0] != ';') return;
+
+                if (std::string* field = matchPackageHeaderField(line, length, packageHeader, prefixLength, fieldBit)) {
+                    assignPackageHeaderValue(*field, line + prefixLength, line + length);
+                    fieldsFound |= fieldBit;
+                    done = (fieldsFound == PACKAGE_HEADER_ALL_FIELDS);
+                }
+            };
+
+            while (!done) {
+            #if !USING_FSTREAM_DIRECTIVE
+                const size_t bytesRead = fread(buffer, 1, sizeof(buffer), file);
+            #else
+                file.read(buffer, sizeof(buffer));
+                const size_t bytesRead = static_cast<size_t>(file.gcount());
             #endif
+                recordIniRead(bytesRead);
+                if (bytesRead == 0) {
+                    processLine(carry.data(), carry.size());
+                    break;
+                }
+
+                const char* lineStart = buffer;
+                const char* const bufferEnd = buffer + bytesRead;
+                const char* lineEnd;
+
+                while (!done && (lineEnd = static_cast<const char*>(std::memchr(lineStart, '\n', bufferEnd - lineStart)))) {
+                    if (!carry.empty()) {
+                        carry.append(lineStart, lineEnd);
+                        processLine(carry.data(), carry.size());
+                        carry.clear();
+                    } else {
+                        processLine(lineStart, lineEnd - lineStart);
+                    }
+                    lineStart = lineEnd + 1;
+                }
+                if (!done) carry.append(lineStart, bufferEnd);
+            }
+
+        #if !USING_FSTREAM_DIRECTIVE
+            fclose(file);
+        #else
+            file.close();
+        #endif
+
+            return packageHeader;
+        }
+
+        /**
+         * @brief Returns the header of a package INI, served from the mtime-validated cache.
+         *
+         * Headers of files modified within the racy window are returned but not cached.
+         */
+        PackageHeader loadPackageHeader(const std::string& filePath) {
+            struct stat fileStat;
+            if (stat(filePath.c_str(), &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) {
+                std::lock_guard<std::mutex> lock(packageHeaderCacheMutex);
+                packageHeaderCache.erase(filePath);
+                return PackageHeader();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(packageHeaderCacheMutex);
+                auto it = packageHeaderCache.find(filePath);
+                if (it != packageHeaderCache.end() &&
+                    it->second.fileSize == static_cast<long long>(fileStat.st_size) &&
+                    it->second.fileTime == static_cast<long long>(fileStat.st_mtime)) {
+                    return it->second.header;
+                }
+            }
+
+            PackageHeaderCacheEntry entry;
+            entry.fileSize = static_cast<long long>(fileStat.st_size);
+            entry.fileTime = static_cast<long long>(fileStat.st_mtime);
+            {
+                auto fileMutex = getFileMutex(filePath);
+                std::shared_lock<std::shared_mutex> lock(*fileMutex);
+                entry.header = scanPackageHeader(filePath);
+            }
+
+            std::lock_guard<std::mutex> lock(packageHeaderCacheMutex);
+            if (isRacyFileTime(entry.fileTime)) {
+                packageHeaderCache.erase(filePath);  // May still change under the same mtime
+                return entry.header;
+            }
+            return packageHeaderCache.insert_or_assign(filePath, std::move(entry)).first->second.header;
         }
     }
 
-    
     /**
-     * @brief Modifies or creates an INI file by adding or updating key-value pairs in the specified section.
+     * @brief Drops every cached package header.
+     */
+    void clearPackageHeaderCache() {
+        std::lock_guard<std::mutex> lock(packageHeaderCacheMutex);
+        packageHeaderCache = {};
+    }
+
+
+    /**
+     * @brief Retrieves the package header information from an INI file.
      *
-     * This function attempts to open the specified INI file for reading. If the file doesn't exist,
-     * it creates a new file and adds the specified section and key-value pair. If the file exists,
-     * it reads its contents, modifies or adds the key-value pair in the specified section, and saves
-     * the changes back to the original file.
+     * This function reads the comment header of an INI file, up to its first section,
+     * and extracts the package header information. Results are cached by mtime.
      *
-     * @param fileToEdit      The path to the INI file to be modified or created.
-     * @param desiredSection  The name of the section in which the key-value pair should be added or updated.
-     * @param desiredKey      The key for the key-value pair to be added or updated.
-     * @param desiredValue    The new value for the key-value pair.
-     * @param desiredNewKey   (Optional) If provided, the function will rename the key while preserving the original value.
-     * @param comment         An optional comment to be added (not currently implemented).
+     * @param filePath The path to the INI file.
+     * @return The package header structure.
      */
-    void setIniFile(const std::string& fileToEdit, const std::string& desiredSection, const std::string& desiredKey, const std::string& desiredValue, const std::string& desiredNewKey, const std::string& comment) {
-        auto fileMutex = getFileMutex(fileToEdit);
-        std::unique_lock<std::shared_mutex> lock(*fileMutex);
+    PackageHeader getPackageHeaderFromIni(const std::string& filePath) {
+        return loadPackageHeader(filePath);
+    }
 
-        std::ios::sync_with_stdio(false);  // Disable synchronization between C++ and C I/O.
-    
-        if (!isFile(fileToEdit)) {
-            createDirectory(getParentDirFromPath(fileToEdit));
-        }
-    
-    #if !USING_FSTREAM_DIRECTIVE
-        FILE* configFile = fopen(fileToEdit.c_str(), "r");
-        if (!configFile) {
-            configFile = fopen(fileToEdit.c_str(), "w"); // Create a new file if it doesn't exist
-            if (configFile) {
-                fprintf(configFile, "[%s]\n%s=%s\n", desiredSection.c_str(), desiredKey.c_str(), desiredValue.c_str());
-                fclose(configFile);
-            }
-            return;
+
+    /**
+     * @brief Retrieves the package headers of every package in a directory.
+     *
+     * Each subdirectory containing a PACKAGE_FILENAME is scanned across a pool of
+     * PACKAGE_SCAN_THREADS workers. Unchanged packages are served from the header cache.
+     *
+     * @param packageDirectory The directory holding one subdirectory per package.
+     * @return Pairs of package directory name and header, sorted by name.
+     */
+    std::vector<std::pair<std::string, PackageHeader>> getPackageHeadersFromDirectory(const std::string& packageDirectory) {
+        std::vector<std::pair<std::string, PackageHeader>> results;
+
+        std::string basePath = packageDirectory;
+        if (!basePath.empty() && basePath.back() != '/') basePath += '/';
+
+        std::vector<std::string> packageNames = getSubdirectories(packageDirectory);
+        std::sort(packageNames.begin(), packageNames.end());
+
+        results.reserve(packageNames.size());
+        for (auto& name : packageNames) {
+            results.emplace_back(std::move(name), PackageHeader());
         }
-    
-        StringStream buffer(""); // Use StringStream to collect results
-        char line[1024];
-        bool sectionFound = false;
-        bool keyFound = false;
-        bool firstSection = true;  // Flag to control new line before first section
-        std::string currentSection;
-        std::string lineStr;
-        std::string key;
-        
-        size_t delimiterPos;
-        size_t len;
-        const char* start;
-        const char* end;
-        
-        size_t key_start, key_end;
-        while (fgets(line, sizeof(line), configFile)) {
-            // More efficient newline removal
-            len = strlen(line);
-            if (len > 0 && line[len-1] == '\n') {
-                line[len-1] = '\0';
-                --len;
-                if (len > 0 && line[len-1] == '\r') {
-                    line[len-1] = '\0';
-                    --len;
-                }
-            }
-            
-            // Early exit for empty lines
-            if (len == 0) continue;
-            
-            // Manual trim for better performance
-            start = line;
-            while (*start == ' ' || *start == '\t') ++start;
-            
-            end = line + len - 1;
-            while (end >= start && (*end == ' ' || *end == '\t')) --end;
-            
-            // Early exit for whitespace-only lines
-            if (end < start) continue;
-            
-            // Calculate trimmed length
-            len = end - start + 1;
-            lineStr.assign(start, len);
-    
-            if (lineStr[0] == '[' && lineStr.back() == ']') {
-                if (sectionFound && !keyFound) {
-                    buffer << desiredKey << "=" << desiredValue << '\n';  // Add missing key-value pair
-                    keyFound = true;
-                }
-                if (!firstSection) {
-                    buffer << '\n';  // Add a newline before the start of a new section
-                }
-                currentSection.assign(lineStr, 1, lineStr.size() - 2);
-                sectionFound = (currentSection == desiredSection);
-                buffer << lineStr << '\n';
-                firstSection = false;
-
-                // Clear strings to reuse capacity
-                lineStr.clear();
-                currentSection.clear();
-                continue;
-            }
-    
-            if (sectionFound && !keyFound) {
-                delimiterPos = lineStr.find('=');
-                if (delimiterPos != std::string::npos) {
-                    // Extract and trim key manually for better performance
-                    key_start = 0;
-                    key_end = delimiterPos - 1;
-                    
-                    // Find start of key (skip leading whitespace)
-                    while (key_start < delimiterPos && (lineStr[key_start] == ' ' || lineStr[key_start] == '\t')) {
-                        ++key_start;
-                    }
-                    
-                    // Find end of key (skip trailing whitespace)
-                    while (key_end > key_start && (lineStr[key_end] == ' ' || lineStr[key_end] == '\t')) {
-                        --key_end;
-                    }
-                    
-                    if (key_end >= key_start) {
-                        key.assign(lineStr, key_start, key_end - key_start + 1);
-                        
-                        if (key == desiredKey) {
-                            keyFound = true;
-                            // Build the replacement line more efficiently
-                            lineStr.assign(desiredNewKey.empty() ? desiredKey : desiredNewKey);
-                            lineStr += '=';
-                            lineStr += desiredValue;
-                        }
-                    }
+
+        std::vector<char> found(results.size(), 0);
+        std::atomic<size_t> nextIndex{0};
+
+        auto worker = [&]() {
+            size_t i;
+            while ((i = nextIndex.fetch_add(1, std::memory_order_relaxed)) < results.size()) {
+                const std::string packageIniPath = basePath + results[i].first + "/" + PACKAGE_FILENAME;
+                if (isFile(packageIniPath)) {
+                    results[i].second = loadPackageHeader(packageIniPath);
+                    found[i] = 1;
                 }
             }
-    
-            buffer << lineStr << '\n';
+        };
 
-            // Clear strings to reuse capacity
-            lineStr.clear();
-            key.clear();
+        const size_t threadCount = std::min(PACKAGE_SCAN_THREADS, results.size());
+        std::vector<std::thread> workers;
+        if (threadCount > 1) {
+            workers.reserve(threadCount - 1);
+            for (size_t t = 1; t < threadCount; ++t) {
+                workers.emplace_back(worker);
+            }
         }
-    
-        if (!sectionFound && !keyFound) {
-            if (!firstSection) buffer << '\n';  // Ensure newline before adding a new section, unless it's the first section
-            buffer << '[' << desiredSection << ']' << '\n';
-            buffer << desiredKey << "=" << desiredValue << '\n';
-        } else if (!keyFound) {
-            buffer << desiredKey << "=" << desiredValue << '\n';
+        worker();  // The calling thread takes part
+        for (auto& thread : workers) {
+            thread.join();
+        }
+
+        // Keep only directories that actually hold a package
+        size_t kept = 0;
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (found[i]) {
+                if (kept != i) results[kept] = std::move(results[i]);
+                ++kept;
+            }
         }
+        results.resize(kept);
+
+        return results;
+    }
+
     
-        fclose(configFile);
     
-        // Write to the file again
-        FILE* outFile = fopen(fileToEdit.c_str(), "w");
-        if (outFile) {
-            fputs(buffer.str().c_str(), outFile);
-            fclose(outFile);
+    /**
+     * @brief Splits a string into a vector of substrings using a specified delimiter.
+     *
+     * This function splits a given string into multiple substrings based on the specified delimiter.
+     *
+     * @param str The input string to be split.
+     * @param delim The delimiter character used for splitting.
+     * @return A vector of substrings obtained by splitting the input string.
+     */
+    std::vector<std::string> split(const std::string& str, char delim) {
+        std::vector<std::string> out;
+        
+        if (str.empty()) return out;
+        
+        //out.reserve(std::count(str.begin(), str.end(), delim) + 1);
+        
+        const char* data = str.data();
+        const char* end = data + str.size();
+        const char* start = data;
+        
+        while (const char* pos = static_cast<const char*>(std::memchr(start, delim, end - start))) {
+            out.emplace_back(start, pos);
+            start = pos + 1;
         }
-    #else
-        std::ifstream configFile(fileToEdit);
-        StringStream buffer(""); // Use StringStream to collect results
+        out.emplace_back(start, end);
+        
+        return out;
+    }
     
-        if (!configFile) {
-            std::ofstream outFile(fileToEdit);
-            outFile << "[" << desiredSection << "]\n" << desiredKey << "=" << desiredValue << '\n';
-            return;
-        }
     
-        std::string line;
-        bool sectionFound = false;
-        bool keyFound = false;
-        bool firstSection = true;  // Flag to control new line before first section
-        std::string currentSection;
+    /**
+     * @brief Parses an INI-formatted string into its flat form.
+     *
+     * Lines are trimmed of whitespace and lines starting with '#' are skipped. Keys that
+     * appear before the first non-empty section header are ignored.
+     *
+     * @param contents The INI-formatted string to parse; it becomes the arena.
+     * @return The parsed INI data.
+     */
+    FlatIniData FlatIniData::parse(std::string contents) {
+        FlatIniData result;
+        FlatIniBuilder builder(result, std::move(contents));
+        
+        const char* lineStart = builder.begin();
+        const char* lineEnd;
+        const char* strEnd = builder.end();
         
-        size_t delimiterPos;
-        std::string key;
+        FlatIniBuilder::Span lastHeader;
         
-        size_t start, end, key_start, key_end;
-        while (std::getline(configFile, line)) {
-            // Remove carriage return if present (getline already removes \n)
-            if (!line.empty() && line.back() == '\r') {
-                line.pop_back();
-            }
-            
-            // Early exit for empty lines
-            if (line.empty()) continue;
-            
-            // Manual trim for better performance
-            start = 0;
-            end = line.length() - 1;
+        auto isWhitespace = [](char c) {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+        };
+        
+        while (lineStart < strEnd) {
+            // Find line end
+            lineEnd = static_cast<const char*>(std::memchr(lineStart, '\n', strEnd - lineStart));
+            if (!lineEnd) lineEnd = strEnd;
             
-            // Find start of non-whitespace
-            while (start < line.length() && (line[start] == ' ' || line[start] == '\t')) {
-                ++start;
+            // Trim whitespace from start
+            while (lineStart < lineEnd && isWhitespace(*lineStart)) {
+                lineStart++;
             }
             
-            // Early exit for whitespace-only lines
-            if (start >= line.length()) continue;
-            
-            // Find end of non-whitespace
-            while (end > start && (line[end] == ' ' || line[end] == '\t')) {
-                --end;
+            // Trim whitespace from end
+            while (lineEnd > lineStart && isWhitespace(*(lineEnd-1))) {
+                lineEnd--;
             }
             
-            // Create trimmed line if needed
-            if (start > 0 || end < line.length() - 1) {
-                line.assign(line, start, end - start + 1);
-            }
-    
-            if (line[0] == '[' && line.back() == ']') {
-                if (sectionFound && !keyFound) {
-                    buffer << desiredKey << "=" << desiredValue << '\n';  // Add missing key-value pair
-                    keyFound = true;
-                }
-                if (!firstSection) {
-                    buffer << '\n';  // Add a newline before the start of a new section
-                }
-                currentSection.assign(line, 1, line.size() - 2);
-                sectionFound = (currentSection == desiredSection);
-                buffer << line << '\n';
-                firstSection = false;
-
-                // Clear strings to reuse capacity
-                line.clear();
-                currentSection.clear();
-                continue;
-            }
-    
-            if (sectionFound && !keyFound) {
-                delimiterPos = line.find('=');
-                if (delimiterPos != std::string::npos) {
-                    // Extract and trim key manually for better performance
-                    key_start = 0;
-                    key_end = delimiterPos - 1;
-                    
-                    // Find start of key (skip leading whitespace)
-                    while (key_start < delimiterPos && (line[key_start] == ' ' || line[key_start] == '\t')) {
-                        ++key_start;
-                    }
-                    
-                    // Find end of key (skip trailing whitespace)
-                    while (key_end > key_start && (line[key_end] == ' ' || line[key_end] == '\t')) {
-                        --key_end;
-                    }
+            size_t lineLen = lineEnd - lineStart;
+            
+            // Skip empty lines and comments
+            if (lineLen > 0 && *lineStart != '#') {
+                if (*lineStart == '[' && *(lineEnd-1) == ']') {
+                    // Section header
+                    builder.addHeader(lineStart + 1, lineEnd - 1);
+                    lastHeader = builder.addSection(lineStart + 1, lineEnd - 1); // Ensure section exists
+                } else if (lastHeader.length != 0) {
+                    // Key=value pair
+                    const char* eqPos = static_cast<const char*>(std::memchr(lineStart, '=', lineLen));
                     
-                    if (key_end >= key_start) {
-                        key.assign(line, key_start, key_end - key_start + 1);
+                    if (eqPos) {
+                        // Trim key
+                        const char* keyStart = lineStart;
+                        const char* keyEnd = eqPos;
+                        while (keyStart < keyEnd && isWhitespace(*keyStart)) keyStart++;
+                        while (keyEnd > keyStart && isWhitespace(*(keyEnd-1))) keyEnd--;
                         
-                        if (key == desiredKey) {
-                            keyFound = true;
-                            // Build the replacement line more efficiently
-                            line.assign(desiredNewKey.empty() ? desiredKey : desiredNewKey);
-                            line += '=';
-                            line += desiredValue;
-                        }
+                        // Trim value
+                        const char* valStart = eqPos + 1;
+                        const char* valEnd = lineEnd;
+                        while (valStart < valEnd && isWhitespace(*valStart)) valStart++;
+                        while (valEnd > valStart && isWhitespace(*(valEnd-1))) valEnd--;
+                        
+                        builder.addPair(lastHeader, keyStart, keyEnd, valStart, valEnd);
                     }
                 }
             }
-    
-            buffer << line << '\n';
-
-            // Clear strings to reuse capacity
-            line.clear();
-            key.clear();
-        }
-    
-        if (!sectionFound && !keyFound) {
-            if (!firstSection) buffer << '\n';  // Ensure newline before adding a new section, unless it's the first section
-            buffer << '[' << desiredSection << ']' << '\n';
-            buffer << desiredKey << "=" << desiredValue << '\n';
-        } else if (!keyFound) {
-            buffer << desiredKey << "=" << desiredValue << '\n';
+            
+            // Move to next line
+            lineStart = lineEnd;
+            if (lineStart < strEnd && *lineStart == '\n') {
+                lineStart++;
+            }
         }
-    
-        configFile.close();
-    
-        std::ofstream outFile(fileToEdit);
-        outFile << buffer.str();
-        outFile.close();
-    #endif
+        
+        builder.finish();
+        return result;
     }
     
     
     /**
-     * @brief Sets the value of a key in an INI file within the specified section and cleans the formatting.
+     * @brief Parses an INI-formatted string into a map of sections and key-value pairs.
      *
-     * This function sets the value of the specified key within the given section of the INI file.
-     * If the key or section does not exist, it creates them. After updating the INI file,
-     * it cleans the formatting to ensure proper INI file structure.
+     * This function parses an INI-formatted string and organizes the data into a map,
+     * where sections are keys and key-value pairs are stored within each section.
      *
-     * @param fileToEdit      The path to the INI file to be modified or created.
-     * @param desiredSection  The name of the section in which the key-value pair should be added or updated.
-     * @param desiredKey      The key for the key-value pair to be added or updated.
-     * @param desiredValue    The new value for the key-value pair.
+     * @param str The INI-formatted string to parse.
+     * @return A map representing the parsed INI data.
      */
-    void setIniFileValue(const std::string& fileToEdit, const std::string& desiredSection, const std::string& desiredKey, const std::string& desiredValue, const std::string& comment) {
-        setIniFile(fileToEdit, desiredSection, desiredKey, desiredValue, "", comment);
-        //cleanIniFormatting(fileToEdit);
+    std::map<std::string, std::map<std::string, std::string>> parseIni(const std::string &str) {
+        return FlatIniData::parse(str).toMap();
     }
     
+    
     /**
-     * @brief Sets the key name to a new name in an INI file within the specified section and cleans the formatting.
+     * @brief Parses an INI file and returns its content as a map of sections and key-value pairs.
      *
-     * This function sets the key name to a new name within the given section of the INI file.
-     * If the key or section does not exist, it creates them. After updating the INI file,
-     * it cleans the formatting to ensure proper INI file structure.
+     * This function reads the contents of an INI file located at the specified path,
+     * parses it into a map structure, where section names are keys and key-value pairs
+     * are stored within each section. The data is served from the INI document cache.
+     *
+     * @param configIniPath The path to the INI file to be parsed.
+     * @return A map representing the parsed INI data.
+     */
+    std::map<std::string, std::map<std::string, std::string>> getParsedDataFromIniFile(const std::string& configIniPath) {
+        auto fileMutex = getFileMutex(configIniPath);
+        std::shared_lock<std::shared_mutex> lock(*fileMutex);
+    
+        const auto document = acquireIniDocument(configIniPath);
+        if (!document) {
+            return {};
+        }
+        return document->data.toMap();
+    }
+    
+    
+    /**
+     * @brief Returns the flat parsed form of an INI file without copying it.
      *
-     * @param fileToEdit      The path to the INI file to be modified or created.
-     * @param desiredSection  The name of the section in which the key-name change should occur.
-     * @param desiredKey      The key name to be changed.
-     * @param desiredNewKey   The new key name to replace the original key name.
+     * The document is shared with the INI document cache through an aliasing pointer,
+     * so holding it keeps the bytes alive even if the cache entry is evicted.
+     *
+     * @param configIniPath The path to the INI file to be parsed.
+     * @return A shared pointer to the parsed INI data.
      */
-    void setIniFileKey(const std::string& fileToEdit, const std::string& desiredSection, const std::string& desiredKey, const std::string& desiredNewKey, const std::string& comment) {
-        setIniFile(fileToEdit, desiredSection, desiredKey, "", desiredNewKey, comment);
-        //cleanIniFormatting(fileToEdit);
-    }
+    std::shared_ptr<const FlatIniData> getFlatIniDataFromIniFile(const std::string& configIniPath) {
+        auto fileMutex = getFileMutex(configIniPath);
+        std::shared_lock<std::shared_mutex> lock(*fileMutex);
     
+        const auto document = acquireIniDocument(configIniPath);
+        if (!document) {
+            return std::make_shared<const FlatIniData>();
+        }
+        return std::shared_ptr<const FlatIniData>(document, &document->data);
+    }
     
         
+    
     /**
-     * @brief Adds a new section to an INI file.
+     * @brief Parses an INI file and retrieves key-value pairs from a specific section.
      *
-     * This function adds a new section with the specified name to the INI file located at the
-     * specified path. If the section already exists, it does nothing.
+     * This function reads the contents of an INI file located at the specified path,
+     * and returns the key-value pairs within a specific section.
      *
-     * @param filePath The path to the INI file.
-     * @param sectionName The name of the section to add.
+     * @param configIniPath The path to the INI file to be parsed.
+     * @param sectionName The name of the section to retrieve key-value pairs from.
+     * @return A map representing the key-value pairs in the specified section.
      */
-    void addIniSection(const std::string& filePath, const std::string& sectionName) {
-        auto fileMutex = getFileMutex(filePath);
-        std::unique_lock<std::shared_mutex> lock(*fileMutex);
-
-    #if !USING_FSTREAM_DIRECTIVE
-        FILE* inputFile = fopen(filePath.c_str(), "r");
-        if (!inputFile) {
-            // Create new file with just the section if file doesn't exist
-            FILE* newFile = fopen(filePath.c_str(), "w");
-            if (newFile) {
-                fprintf(newFile, "[%s]\n", sectionName.c_str());
-                fclose(newFile);
-            }
-            #if USING_LOGGING_DIRECTIVE
-            else {
-                if (!disableLogging)
-                    logMessage("Error: Failed to create new INI file.");
-            }
-            #endif
-            return;
-        }
+    std::map<std::string, std::string> getKeyValuePairsFromSection(const std::string& configIniPath, const std::string& sectionName) {
+        auto fileMutex = getFileMutex(configIniPath);
+        std::shared_lock<std::shared_mutex> lock(*fileMutex);
     
-        const std::string tempPath = filePath + ".tmp";
-        FILE* tempFile = fopen(tempPath.c_str(), "w");
-        if (!tempFile) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Error: Failed to create a temporary file.");
-            #endif
-            fclose(inputFile);
-            return;
+        std::map<std::string, std::string> sectionData;
+        
+        const auto index = acquireSectionIndex(configIniPath);
+        if (!index) {
+            return sectionData;
         }
-    
-        // Pre-calculate section comparison values
-        const size_t sectionNameLen = sectionName.length();
-        const size_t fullSectionLen = sectionNameLen + 2; // [ + sectionName + ]
         
-        // Declare all variables outside the loop
-        char line[1024];
-        bool sectionExists = false;
-        size_t len = 0;
-        //const char* start;
-        const char* end;
+        const auto& headers = index->headers;
+        std::string body;
+        std::string key, value;
         
-        size_t content_len;
-
-        // First pass: check if section exists and copy all content
-        while (fgets(line, sizeof(line), inputFile)) {
-            len = strlen(line);
-            
-            // Optimize section detection without string copying
-            if (len >= fullSectionLen && line[0] == '[') {
-                // Find end of line content (excluding newlines)
-                end = line + len - 1;
-                while (end > line && (*end == '\n' || *end == '\r')) --end;
-                
-                // Check if this could be our section
-                if (end > line && *end == ']') {
-                    content_len = end - line + 1;
-                    if (content_len == fullSectionLen) {
-                        // Direct memory comparison - much faster than string creation
-                        if (memcmp(line + 1, sectionName.c_str(), sectionNameLen) == 0) {
-                            sectionExists = true;
-                            // Early optimization: write remaining file and exit loop
-                            fputs(line, tempFile);
-                            
-                            // Copy rest of file efficiently
-                            while (fgets(line, sizeof(line), inputFile)) {
-                                fputs(line, tempFile);
-                            }
-                            break;
-                        }
-                    }
-                }
+        for (size_t i = 0; i < headers.size(); ++i) {
+            if (headers[i].name != sectionName) {
+                // Stop at the first other section once the target produced pairs
+                if (!sectionData.empty()) break;
+                continue;
             }
             
-            // Always write the line as-is
-            fputs(line, tempFile);
-        }
-    
-        // If the section does not exist, add it at the end
-        if (!sectionExists) {
-            // Check if we need a newline before the new section
-            if (ftell(tempFile) > 0) {
-                fseek(tempFile, -1, SEEK_END);
-                char lastChar;
-                if (fread(&lastChar, 1, 1, tempFile) == 1 && lastChar != '\n') {
-                    fseek(tempFile, 0, SEEK_END);
-                    fputc('\n', tempFile);
-                } else {
-                    fseek(tempFile, 0, SEEK_END);
-                }
+            // Read only this section's body
+            const uint64_t spanEnd = (i + 1 < headers.size()) ? headers[i + 1].lineStart : static_cast<uint64_t>(index->fileSize);
+            if (!readIniFileRange(configIniPath, headers[i].bodyStart, spanEnd, body)) {
+                break;
             }
             
-            fprintf(tempFile, "[%s]\n", sectionName.c_str());
-        }
-    
-        fclose(inputFile);
-        fclose(tempFile);
-    
-    #else
-        std::ifstream inputFile(filePath);
-        if (!inputFile) {
-            // Create new file with just the section if file doesn't exist
-            std::ofstream newFile(filePath);
-            if (newFile) {
-                newFile << "[" << sectionName << "]\n";
-            }
-            #if USING_LOGGING_DIRECTIVE
-            else {
-                if (!disableLogging)
-                    logMessage("Error: Failed to create new INI file.");
-            }
-            #endif
-            return;
-        }
-    
-        const std::string tempPath = filePath + ".tmp";
-        std::ofstream tempFile(tempPath);
-        if (!tempFile) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Error: Failed to create a temporary file.");
-            #endif
-            return;
-        }
-    
-        // Pre-calculate section comparison values
-        const size_t sectionNameLen = sectionName.length();
-        const size_t fullSectionLen = sectionNameLen + 2; // [ + sectionName + ]
-        
-        // Declare variables outside the loop
-        std::string line;
-        bool sectionExists = false;
-        
-        size_t end_pos, content_len;
-        // Read entire file and check for section
-        while (std::getline(inputFile, line)) {
-            // Optimize section detection
-            if (line.length() >= fullSectionLen && line[0] == '[') {
-                // Find end of content (excluding carriage return)
-                end_pos = line.length() - 1;
-                if (line[end_pos] == '\r') --end_pos;
+            const char* lineStart = body.data();
+            const char* const bodyEnd = lineStart + body.size();
+            const char* lineEnd;
+            const char* eq;
+            
+            while (lineStart < bodyEnd) {
+                lineEnd = static_cast<const char*>(std::memchr(lineStart, '\n', bodyEnd - lineStart));
+                if (!lineEnd) lineEnd = bodyEnd;
                 
-                // Check if this could be our section
-                if (end_pos < line.length() && line[end_pos] == ']') {
-                    content_len = end_pos + 1;
-                    if (content_len == fullSectionLen) {
-                        // Direct comparison - much faster than string creation
-                        if (line.compare(1, sectionNameLen, sectionName) == 0) {
-                            sectionExists = true;
-                            // Early optimization: write remaining file and exit loop
-                            tempFile << line << '\n';
-                            
-                            // Copy rest of file efficiently
-                            while (std::getline(inputFile, line)) {
-                                tempFile << line << '\n';
-                                line.clear(); // Clear to reuse capacity
-                            }
-                            break;
-                        }
-                    }
+                eq = static_cast<const char*>(std::memchr(lineStart, '=', lineEnd - lineStart));
+                if (eq) {
+                    key.assign(lineStart, eq);
+                    trim(key);
+                    value.assign(eq + 1, lineEnd);
+                    trim(value);
+                    sectionData[std::move(key)] = std::move(value);
                 }
+                lineStart = lineEnd + 1;
             }
-            
-            tempFile << line << '\n';
-            line.clear(); // Clear to reuse capacity
         }
     
-        // If the section does not exist, add it
-        if (!sectionExists) {
-            tempFile << "[" << sectionName << "]\n";
-        }
+        return sectionData;
+    }
     
-        inputFile.close();
-        tempFile.close();
-    #endif
     
-        // Replace the original file with the temp file
-        if (std::remove(filePath.c_str()) != 0) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Failed to delete the original file: " + filePath);
-            #endif
-            // Clean up temp file on error
-            std::remove(tempPath.c_str());
-            return;
-        }
     
-        if (std::rename(tempPath.c_str(), filePath.c_str()) != 0) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Failed to rename the temporary file: " + tempPath);
-            #endif
+    /**
+     * @brief Parses sections from an INI file and returns them as a list of strings.
+     *
+     * This function reads an INI file and extracts the section names from it.
+     *
+     * @param filePath The path to the INI file.
+     * @return A vector of section names.
+     */
+    std::vector<std::string> parseSectionsFromIni(const std::string& filePath) {
+        auto fileMutex = getFileMutex(filePath);
+        std::shared_lock<std::shared_mutex> lock(*fileMutex);
+    
+        const auto document = acquireIniDocument(filePath);
+        if (!document) {
+            return {};
         }
+        std::vector<std::string> sections;
+        sections.reserve(document->data.headerCount());
+        document->data.forEachHeader([&sections](std::string_view name) {
+            sections.emplace_back(name);
+        });
+        return sections;
     }
     
     
+    
     /**
-     * @brief Renames a section in an INI file.
+     * @brief Looks up a value from a section and key in an INI file.
      *
-     * This function renames the section with the specified current name to the specified new name
-     * in the INI file located at the specified path. If the current section does not exist, or if the
-     * new section name already exists, it does nothing.
+     * Unlike parseValueFromIniSection, this distinguishes a missing key from a key
+     * that is present with an empty value.
      *
      * @param filePath The path to the INI file.
-     * @param currentSectionName The name of the section to rename.
-     * @param newSectionName The new name for the section.
+     * @param sectionName The name of the section containing the desired key.
+     * @param keyName The name of the key whose value is to be retrieved.
+     * @param value Receives the value when the key is found.
+     * @return True if the section and key exist, false otherwise.
      */
-    void renameIniSection(const std::string& filePath, const std::string& currentSectionName, const std::string& newSectionName) {
+    bool findIniValue(const std::string& filePath, const std::string& sectionName, const std::string& keyName, std::string& value) {
         auto fileMutex = getFileMutex(filePath);
-        std::unique_lock<std::shared_mutex> lock(*fileMutex);
-
-    #if !USING_FSTREAM_DIRECTIVE
-        FILE* configFile = fopen(filePath.c_str(), "r");
-        if (!configFile) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Failed to open the input file: " + filePath);
-            #endif
-            return;
-        }
+        std::shared_lock<std::shared_mutex> lock(*fileMutex);
     
-        const std::string tempPath = filePath + ".tmp";
-        FILE* tempFile = fopen(tempPath.c_str(), "w");
-        if (!tempFile) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Failed to create the temporary file: " + tempPath);
-            #endif
-            fclose(configFile);
-            return;
+        bool uncacheable = false;
+        const auto document = acquireIniDocument(filePath, &uncacheable);
+        if (uncacheable) {
+            std::vector<IniLookup> lookups(1);
+            lookups[0].section = sectionName;
+            lookups[0].key = keyName;
+            streamIniLookups(filePath, lookups);
+            if (lookups[0].found) value = std::move(lookups[0].value);
+            return lookups[0].found;
         }
-    
-        char line[1024];
-        std::string sectionName;
-        std::string lineStr;
-
-        while (fgets(line, sizeof(line), configFile)) {
-            lineStr = line;
-            trim(lineStr); // Modifying lineStr directly
-            sectionName.clear();
-    
-            if (!lineStr.empty() && lineStr[0] == '[' && lineStr[lineStr.length() - 2] == ']') {
-                sectionName = lineStr.substr(1, lineStr.length() - 2);
-                fprintf(tempFile, "[%s]\n", sectionName == currentSectionName ? newSectionName.c_str() : sectionName.c_str());
-            } else {
-                fprintf(tempFile, "%s\n", line);
-            }
+        if (!document) {
+            return false;
         }
-    
-        fclose(configFile);
-        fclose(tempFile);
-    #else
-        std::ifstream configFile(filePath);
-        if (!configFile) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Failed to open the input file: " + filePath);
-            #endif
-            return;
+        
+        std::string_view found;
+        if (!document->data.find(sectionName, keyName, found)) {
+            return false;
         }
+        
+        value.assign(found);
+        return true;
+    }
     
-        std::string tempPath = filePath + ".tmp";
-        std::ofstream tempFile(tempPath);
-        if (!tempFile) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Failed to create the temporary file: " + tempPath);
-            #endif
-            return;
-        }
     
-        std::string line, sectionName;
-        while (getline(configFile, line)) {
-            trim(line);
-            if (!line.empty() && line.front() == '[' && line.back() == ']') {
-                sectionName = line.substr(1, line.length() - 2);
-                tempFile << "[" << (sectionName == currentSectionName ? newSectionName : sectionName) << "]\n";
+    
+    /**
+     * @brief Looks up several values from an INI file with a single read.
+     *
+     * Every request is answered from one parse of the file (shared with the INI document
+     * cache), so asking for N keys costs the same file I/O as asking for one. Files too
+     * large for the cache are streamed instead, stopping once every key has been found.
+     *
+     * Duplicate sections merge and the first occurrence of a key wins, as with findIniValue.
+     * Readers that rely on a later duplicate overriding an earlier one should use
+     * getKeyValuePairsFromSection, where the last occurrence wins.
+     *
+     * @param filePath The path to the INI file.
+     * @param lookups The requests; `value`, `found` and `sectionFound` are filled in.
+     * @return The number of requests whose key was found.
+     */
+    size_t lookupIniValues(const std::string& filePath, std::vector<IniLookup>& lookups) {
+        auto fileMutex = getFileMutex(filePath);
+        std::shared_lock<std::shared_mutex> lock(*fileMutex);
+        
+        bool uncacheable = false;
+        const auto document = acquireIniDocument(filePath, &uncacheable);
+        
+        size_t foundCount = 0;
+        if (uncacheable) {
+            streamIniLookups(filePath, lookups);
+            for (const IniLookup& lookup : lookups) {
+                if (lookup.found) ++foundCount;
+            }
+            return foundCount;
+        }
+        
+        std::string_view found;
+        for (IniLookup& lookup : lookups) {
+            lookup.found = document && document->data.find(lookup.section, lookup.key, found);
+            lookup.sectionFound = lookup.found || (document && document->data.hasSection(lookup.section));
+            if (lookup.found) {
+                lookup.value.assign(found);
+                ++foundCount;
             } else {
-                tempFile << line << '\n';
+                lookup.value.clear();
             }
         }
+        return foundCount;
+    }
     
-        configFile.close();
-        tempFile.close();
-    #endif
-    
-        // Replace the original file with the modified temporary file
-        if (remove(filePath.c_str()) != 0) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Failed to delete the original file: " + filePath);
-            #endif
-            return;
-        }
     
-        if (rename(tempPath.c_str(), filePath.c_str()) != 0) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Failed to rename the temporary file: " + tempPath);
-            #endif
-        }
+    /**
+     * @brief Parses a specific value from a section and key in an INI file.
+     *
+     * @param filePath The path to the INI file.
+     * @param sectionName The name of the section containing the desired key.
+     * @param keyName The name of the key whose value is to be retrieved.
+     * @return The value as a string, or an empty string if the key or section isn't found.
+     */
+    std::string parseValueFromIniSection(const std::string& filePath, const std::string& sectionName, const std::string& keyName) {
+        std::string value;
+        findIniValue(filePath, sectionName, keyName, value);
+        return value;
     }
-
-    
+        
     /**
-     * @brief Removes a section from an INI file.
+     * @brief Cleans the formatting of an INI file by removing empty lines and standardizing section formatting.
      *
-     * This function removes the section with the specified name, including all its associated key-value
-     * pairs, from the INI file located at the specified path. If the section does not exist in the file,
-     * it does nothing.
+     * This function takes an INI file located at the specified path, removes empty lines,
+     * and standardizes the formatting of sections by ensuring that there is a newline
+     * between each section's closing ']' and the next section's opening '['.
      *
-     * @param filePath The path to the INI file.
-     * @param sectionName The name of the section to remove.
+     * @param filePath The path to the INI file to be cleaned.
      */
-    void removeIniSection(const std::string& filePath, const std::string& sectionName) {
+    void cleanIniFormatting(const std::string& filePath) {
         auto fileMutex = getFileMutex(filePath);
         std::unique_lock<std::shared_mutex> lock(*fileMutex);
+        invalidateIniCache(filePath);
 
+        const std::string tempPath = filePath + ".tmp";
+    
     #if !USING_FSTREAM_DIRECTIVE
-        FILE* configFile = fopen(filePath.c_str(), "r");
-        if (!configFile) {
+        FILE* inputFile = fopen(filePath.c_str(), "r");
+        if (!inputFile) {
             #if USING_LOGGING_DIRECTIVE
             if (!disableLogging)
                 logMessage("Failed to open the input file: " + filePath);
@@ -1600,86 +1563,65 @@ namespace ult {
             return;
         }
     
-        std::string tempPath = filePath + ".tmp";
-        FILE* tempFile = fopen(tempPath.c_str(), "w");
-        if (!tempFile) {
+        FILE* outputFile = fopen(tempPath.c_str(), "w");
+        if (!outputFile) {
             #if USING_LOGGING_DIRECTIVE
             if (!disableLogging)
-                logMessage("Failed to create the temporary file: " + tempPath);
+                logMessage("Failed to create the output file: " + tempPath);
             #endif
-            fclose(configFile);
+            fclose(inputFile);
             return;
         }
     
-        // Pre-calculate section comparison values
-        const size_t sectionNameLen = sectionName.length();
-        const size_t fullSectionLen = sectionNameLen + 2; // [ + sectionName + ]
-    
+        // Declare all variables outside the loop
         char line[1024];
-        std::string currentSection;
-        bool inSectionToRemove = false;
+        std::string lineStr;
+        //lineStr.reserve(1024);
         
-        size_t len;
-        const char* start;
-        const char* end;
+        bool isNewSection = false;
+        bool isSection = false;
+        size_t len = 0;
+        size_t bytesIn = 0;
+        size_t bytesOut = 0;
         
-        size_t trimmed_len;
-        while (fgets(line, sizeof(line), configFile)) {
+        while (fgets(line, sizeof(line), inputFile)) {
+            // Efficient newline removal
             len = strlen(line);
-            
-            // Early exit for empty lines
-            if (len == 0) {
-                if (!inSectionToRemove) {
-                    fprintf(tempFile, "%s", line);
-                }
-                continue;
-            }
-            
-            // Manual trim for better performance - find start of non-whitespace
-            start = line;
-            while (*start == ' ' || *start == '\t') ++start;
-            
-            // Find end of non-whitespace (working backwards from known end)
-            end = line + len - 1;
-            while (end >= start && (*end == '\n' || *end == '\r' || *end == ' ' || *end == '\t')) --end;
-            
-            // Early exit for whitespace-only lines
-            if (end < start) {
-                if (!inSectionToRemove) {
-                    fprintf(tempFile, "%s", line);
+            bytesIn += len;
+            if (len > 0 && line[len-1] == '\n') {
+                line[len-1] = '\0';
+                if (len > 1 && line[len-2] == '\r') {
+                    line[len-2] = '\0';
                 }
-                continue;
             }
             
-            // Calculate trimmed length
-            trimmed_len = end - start + 1;
-            
-            // Check if this is a section header
-            if (trimmed_len >= 3 && *start == '[' && *end == ']') {
-                // Optimize section detection with direct comparison
-                if (trimmed_len == fullSectionLen) {
-                    // Direct memory comparison - much faster than string creation
-                    if (memcmp(start + 1, sectionName.c_str(), sectionNameLen) == 0) {
-                        inSectionToRemove = true;
-                        continue; // Skip writing this section header
+            lineStr.assign(line);
+            trim(lineStr);
+    
+            if (!lineStr.empty()) {
+                isSection = (lineStr[0] == '[' && lineStr.back() == ']');
+                
+                if (isSection) {
+                    if (isNewSection) {
+                        fputc('\n', outputFile);
+                        ++bytesOut;
                     }
+                    isNewSection = true;
                 }
                 
-                // Different section - not the one to remove
-                inSectionToRemove = false;
-                fprintf(tempFile, "%s", line);
-            } else if (!inSectionToRemove) {
-                // Write the line as-is to preserve formatting
-                fprintf(tempFile, "%s", line);
+                fputs(lineStr.c_str(), outputFile);
+                fputc('\n', outputFile);
+                bytesOut += lineStr.size() + 1;
             }
-            // If inSectionToRemove is true, skip writing this line
+            // Clear string to reuse capacity
+            lineStr.clear();
         }
     
-        fclose(configFile);
-        fclose(tempFile);
+        fclose(inputFile);
+        fclose(outputFile);
     #else
-        std::ifstream configFile(filePath);
-        if (!configFile) {
+        std::ifstream inputFile(filePath);
+        if (!inputFile) {
             #if USING_LOGGING_DIRECTIVE
             if (!disableLogging)
                 logMessage("Failed to open the input file: " + filePath);
@@ -1687,263 +1629,639 @@ namespace ult {
             return;
         }
     
-        std::string tempPath = filePath + ".tmp";
-        std::ofstream tempFile(tempPath);
-        if (!tempFile) {
+        std::ofstream outputFile(tempPath);
+        if (!outputFile) {
             #if USING_LOGGING_DIRECTIVE
             if (!disableLogging)
-                logMessage("Failed to create the temporary file: " + tempPath);
+                logMessage("Failed to create the output file: " + tempPath);
             #endif
             return;
         }
     
-        // Pre-calculate section comparison values
-        const size_t sectionNameLen = sectionName.length();
-        const size_t fullSectionLen = sectionNameLen + 2; // [ + sectionName + ]
+        // Declare all variables outside the loop
+        std::string line;
+        //line.reserve(1024);
+        
+        bool isNewSection = false;
+        bool isSection = false;
+        size_t bytesIn = 0;
+        size_t bytesOut = 0;
     
-        std::string line, currentSection;
-        bool inSectionToRemove = false;
-
-        size_t start, end, trimmed_len;
-        while (getline(configFile, line)) {
-            // Early exit for empty lines
-            if (line.empty()) {
-                if (!inSectionToRemove) {
-                    tempFile << line << '\n';
-                }
-                continue;
-            }
-            
-            // Manual trim for better performance
-            start = 0;
-            end = line.length() - 1;
-            
-            // Find start of non-whitespace
-            while (start < line.length() && (line[start] == ' ' || line[start] == '\t')) {
-                ++start;
-            }
-            
-            // Find end of non-whitespace (excluding carriage return)
-            while (end > start && (line[end] == ' ' || line[end] == '\t' || line[end] == '\r')) {
-                --end;
-            }
-            
-            // Early exit for whitespace-only lines
-            if (start >= line.length() || end < start) {
-                if (!inSectionToRemove) {
-                    tempFile << line << '\n';
-                }
-                continue;
+        while (std::getline(inputFile, line)) {
+            bytesIn += line.size() + 1;
+            // Remove carriage return if present
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
             }
             
-            // Calculate trimmed length
-            trimmed_len = end - start + 1;
+            trim(line);
             
-            // Check if this is a section header
-            if (trimmed_len >= 3 && line[start] == '[' && line[end] == ']') {
-                // Optimize section detection with direct comparison
-                if (trimmed_len == fullSectionLen) {
-                    // Direct string comparison - much faster than substr + comparison
-                    if (line.compare(start + 1, sectionNameLen, sectionName) == 0) {
-                        inSectionToRemove = true;
-                        continue; // Skip writing this section header
+            if (!line.empty()) {
+                isSection = (line[0] == '[' && line.back() == ']');
+                
+                if (isSection) {
+                    if (isNewSection) {
+                        outputFile << '\n';
+                        ++bytesOut;
                     }
+                    isNewSection = true;
                 }
                 
-                // Different section - not the one to remove
-                inSectionToRemove = false;
-                tempFile << line << '\n';
-            } else if (!inSectionToRemove) {
-                tempFile << line << '\n';
+                outputFile << line << '\n';
+                bytesOut += line.size() + 1;
             }
-            // If inSectionToRemove is true, skip writing this line
+            // Clear string to reuse capacity
+            line.clear();
         }
-    
-        configFile.close();
-        tempFile.close();
+        
+        inputFile.close();
+        outputFile.close();
     #endif
+        recordIniRead(bytesIn, 1);
+        recordIniWrite(bytesOut, 1);
     
-        // Replace the original file with the temp file
-        if (remove(filePath.c_str()) != 0) {
+        // Replace the original file with the temp file with error checking
+        if (std::remove(filePath.c_str()) != 0) {
             #if USING_LOGGING_DIRECTIVE
             if (!disableLogging)
                 logMessage("Failed to delete the original file: " + filePath);
             #endif
+            // Clean up temp file on error
+            std::remove(tempPath.c_str());
             return;
         }
     
-        if (rename(tempPath.c_str(), filePath.c_str()) != 0) {
+        if (std::rename(tempPath.c_str(), filePath.c_str()) != 0) {
             #if USING_LOGGING_DIRECTIVE
             if (!disableLogging)
                 logMessage("Failed to rename the temporary file: " + tempPath);
             #endif
         }
     }
+
     
+    // INI transaction infrastructure
+    namespace {
+        enum class IniLineKind : uint8_t {
+            Other,
+            Section,
+            Pair
+        };
+
+        // One physical line of an INI file, kept verbatim so untouched lines round-trip unchanged
+        // Views point into the file contents, or into IniTransaction::commit's edited-line storage
+        struct IniLine {
+            std::string_view text;   // Raw line without the trailing '\n'
+            std::string_view name;   // Section name or key (trimmed)
+            IniLineKind kind = IniLineKind::Other;
+        };
+
+        void classifyIniLine(IniLine& line) {
+            const char* start = line.text.data();
+            const char* end = start + line.text.size();
+
+            while (start < end && (*start == ' ' || *start == '\t')) ++start;
+            while (end > start && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) --end;
+
+            line.name = {};
+            line.kind = IniLineKind::Other;
+
+            if (end - start >= 2 && *start == '[' && end[-1] == ']') {
+                line.kind = IniLineKind::Section;
+                line.name = std::string_view(start + 1, end - start - 2);
+                return;
+            }
+
+            const char* eq = static_cast<const char*>(std::memchr(start, '=', end - start));
+            if (!eq) return;
+
+            const char* keyEnd = eq;
+            while (keyEnd > start && (keyEnd[-1] == ' ' || keyEnd[-1] == '\t')) --keyEnd;
+            if (keyEnd == start) return;
+
+            line.kind = IniLineKind::Pair;
+            line.name = std::string_view(start, keyEnd - start);
+        }
+
+        IniLine makeIniLine(std::string_view text) {
+            IniLine line;
+            line.text = text;
+            classifyIniLine(line);
+            return line;
+        }
+
+        // Edited lines live in a deque so views into them survive later insertions
+        IniLine makeIniLine(std::deque<std::string>& storage, std::string text) {
+            storage.push_back(std::move(text));
+            return makeIniLine(std::string_view(storage.back()));
+        }
+
+        inline bool isBlankIniLine(const IniLine& line) {
+            return line.text.find_first_not_of(" \t\r") == std::string::npos;
+        }
+
+        // Index of the first header named `sectionName`, or npos
+        size_t findIniSectionLine(const std::vector<IniLine>& lines, const std::string& sectionName) {
+            for (size_t i = 0; i < lines.size(); ++i) {
+                if (lines[i].kind == IniLineKind::Section && lines[i].name == sectionName) return i;
+            }
+            return std::string::npos;
+        }
+
+        // One past the last line belonging to the section whose header is at `headerIndex`
+        size_t findIniSectionEnd(const std::vector<IniLine>& lines, size_t headerIndex) {
+            size_t i = headerIndex + 1;
+            while (i < lines.size() && lines[i].kind != IniLineKind::Section) ++i;
+            return i;
+        }
+
+        /**
+         * @brief Reads a whole file in one bulk read.
+         * @return False if the file does not exist or cannot be opened.
+         */
+        bool readIniFileContents(const std::string& filePath, std::string& contents) {
+        #if !USING_FSTREAM_DIRECTIVE
+            FILE* file = fopen(filePath.c_str(), "rb");
+            if (!file) return false;
+
+            fseek(file, 0, SEEK_END);
+            const long fileSize = ftell(file);
+            fseek(file, 0, SEEK_SET);
+
+            contents.resize(fileSize > 0 ? static_cast<size_t>(fileSize) : 0);
+            contents.resize(fread(contents.data(), 1, contents.size(), file));
+            fclose(file);
+        #else
+            std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+            if (!file) return false;
+
+            const std::streamsize fileSize = file.tellg();
+            file.seekg(0, std::ios::beg);
+
+            contents.resize(fileSize > 0 ? static_cast<size_t>(fileSize) : 0);
+            file.read(contents.data(), contents.size());
+            contents.resize(static_cast<size_t>(file.gcount()));
+            file.close();
+        #endif
+            recordIniRead(contents.size(), 1);
+            return true;
+        }
+
+        /**
+         * @brief Writes `contents` to `filePath` through a temp file and a rename.
+         *
+         * The temp file is fully written and closed before the original is touched, so a
+         * crash leaves either the old file or a complete "<file>.tmp" that
+         * recoverIniTempFile promotes on the next commit.
+         */
+        bool commitIniFileContents(const std::string& filePath, const std::string& contents) {
+            const std::string tempPath = filePath + ".tmp";
+
+        #if !USING_FSTREAM_DIRECTIVE
+            FILE* tempFile = fopen(tempPath.c_str(), "wb");
+            if (!tempFile) {
+                #if USING_LOGGING_DIRECTIVE
+                if (!disableLogging)
+                    logMessage("Failed to create the temporary file: " + tempPath);
+                #endif
+                return false;
+            }
+            const bool written = fwrite(contents.data(), 1, contents.size(), tempFile) == contents.size();
+            const bool closed = fclose(tempFile) == 0;
+        #else
+            std::ofstream tempFile(tempPath, std::ios::binary | std::ios::trunc);
+            if (!tempFile) {
+                #if USING_LOGGING_DIRECTIVE
+                if (!disableLogging)
+                    logMessage("Failed to create the temporary file: " + tempPath);
+                #endif
+                return false;
+            }
+            tempFile.write(contents.data(), contents.size());
+            const bool written = tempFile.good();
+            tempFile.close();
+            const bool closed = !tempFile.fail();
+        #endif
+            recordIniWrite(written ? contents.size() : 0, 1);
+
+            if (!written || !closed) {
+                #if USING_LOGGING_DIRECTIVE
+                if (!disableLogging)
+                    logMessage("Failed to write the temporary file: " + tempPath);
+                #endif
+                std::remove(tempPath.c_str());
+                return false;
+            }
+
+            // POSIX rename replaces atomically; sdmc needs the target removed first
+            if (std::rename(tempPath.c_str(), filePath.c_str()) != 0) {
+                std::remove(filePath.c_str());
+                if (std::rename(tempPath.c_str(), filePath.c_str()) != 0) {
+                    #if USING_LOGGING_DIRECTIVE
+                    if (!disableLogging)
+                        logMessage("Failed to rename the temporary file: " + tempPath);
+                    #endif
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        std::atomic<size_t> iniWriteCommits{0};
+        std::atomic<size_t> iniWritePatches{0};
+        std::atomic<size_t> iniWriteBytes{0};
+        std::atomic<size_t> iniWriteFullBytes{0};
+
+        /**
+         * @brief Rewrites only the bytes of `filePath` that differ between two versions.
+         *
+         * Equal-length versions are patched over the differing span. Otherwise everything
+         * from the first differing byte to the end is rewritten and the file is truncated
+         * when it shrank. Unlike commitIniFileContents this is not atomic, so the caller
+         * keeps `newContents` to fall back on a full commit if anything fails.
+         *
+         * @return True on success; `bytesWritten` receives the number of bytes written.
+         */
+        bool patchIniFileContents(const std::string& filePath, const std::string& oldContents, const std::string& newContents, size_t& bytesWritten) {
+            bytesWritten = 0;
+
+            const size_t common = std::min(oldContents.size(), newContents.size());
+            const size_t first = static_cast<size_t>(std::mismatch(oldContents.begin(), oldContents.begin() + common, newContents.begin()).first - oldContents.begin());
+
+            size_t last = newContents.size();
+            if (oldContents.size() == newContents.size()) {
+                if (first == newContents.size()) return true;  // Identical
+                while (last > first && oldContents[last - 1] == newContents[last - 1]) --last;
+            }
+
+        #if !USING_FSTREAM_DIRECTIVE
+            FILE* file = fopen(filePath.c_str(), "r+b");
+            if (!file) return false;
+
+            bool success = fseek(file, static_cast<long>(first), SEEK_SET) == 0 &&
+                           fwrite(newContents.data() + first, 1, last - first, file) == last - first &&
+                           fflush(file) == 0;
+            if (success && newContents.size() < oldContents.size()) {
+                success = ftruncate(fileno(file), static_cast<off_t>(newContents.size())) == 0;
+            }
+            success = (fclose(file) == 0) && success;
+        #else
+            // fstream cannot truncate; shrinking edits take the full commit path
+            if (newContents.size() < oldContents.size()) return false;
+
+            std::fstream file(filePath, std::ios::in | std::ios::out | std::ios::binary);
+            if (!file) return false;
+
+            file.seekp(static_cast<std::streamoff>(first));
+            file.write(newContents.data() + first, last - first);
+            file.flush();
+            bool success = file.good();
+            file.close();
+        #endif
+
+            if (!success) {
+                #if USING_LOGGING_DIRECTIVE
+                if (!disableLogging)
+                    logMessage("Failed to patch INI file in place: " + filePath);
+                #endif
+                return false;
+            }
+
+            bytesWritten = last - first;
+            recordIniWrite(bytesWritten, 1);
+            return true;
+        }
+
+        // Promotes a complete temp file left behind by an interrupted commit
+        void recoverIniTempFile(const std::string& filePath) {
+            const std::string tempPath = filePath + ".tmp";
+            if (!isFile(filePath) && isFile(tempPath)) {
+                std::rename(tempPath.c_str(), filePath.c_str());
+            }
+        }
+    }
+
+
+    IniTransaction::IniTransaction(const std::string& filePath) : filePath(filePath) {}
+
+    IniTransaction& IniTransaction::setValue(const std::string& sectionName, const std::string& key, const std::string& value, const std::string& newKey) {
+        edits.push_back({EditType::SetValue, sectionName, key, value, newKey});
+        return *this;
+    }
+
+    IniTransaction& IniTransaction::addSection(const std::string& sectionName) {
+        edits.push_back({EditType::AddSection, sectionName, "", "", ""});
+        return *this;
+    }
+
+    IniTransaction& IniTransaction::renameSection(const std::string& sectionName, const std::string& newSectionName) {
+        edits.push_back({EditType::RenameSection, sectionName, "", "", newSectionName});
+        return *this;
+    }
+
+    IniTransaction& IniTransaction::removeSection(const std::string& sectionName) {
+        edits.push_back({EditType::RemoveSection, sectionName, "", "", ""});
+        return *this;
+    }
+
+    IniTransaction& IniTransaction::removeKey(const std::string& sectionName, const std::string& key) {
+        edits.push_back({EditType::RemoveKey, sectionName, key, "", ""});
+        return *this;
+    }
 
     /**
-     * @brief Removes a key-value pair from an INI file.
+     * @brief Applies every queued edit with one read and at most one write of the file.
+     *
+     * Edits are applied in the order they were queued. Lines that no edit touches are
+     * written back byte-for-byte. If the edits leave the content unchanged, nothing is
+     * written. Files of at least INI_PATCH_MIN_SIZE bytes only have their changed bytes
+     * rewritten in place; smaller files, and any failed patch, go through the temp file.
+     * The queue is cleared afterwards regardless of the outcome.
+     *
+     * @return True if the file is up to date afterwards, false on an I/O error.
      */
-    void removeIniKey(const std::string& filePath, const std::string& sectionName, const std::string& keyName) {
+    bool IniTransaction::commit() {
+        if (edits.empty()) return true;
+
         auto fileMutex = getFileMutex(filePath);
         std::unique_lock<std::shared_mutex> lock(*fileMutex);
+        invalidateIniCache(filePath);
 
-    #if !USING_FSTREAM_DIRECTIVE
-        FILE* configFile = fopen(filePath.c_str(), "r");
-        if (!configFile) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Failed to open the input file: " + filePath);
-            #endif
-            return;
-        }
-    
-        std::string tempPath = filePath + ".tmp";
-        FILE* tempFile = fopen(tempPath.c_str(), "w");
-        if (!tempFile) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Failed to create the temporary file: " + tempPath);
-            #endif
-            fclose(configFile);
-            return;
+        recoverIniTempFile(filePath);
+
+        std::string contents;
+        const bool fileExists = readIniFileContents(filePath, contents);
+
+        // Split into lines
+        std::vector<IniLine> lines;
+        {
+            const char* lineStart = contents.data();
+            const char* const dataEnd = lineStart + contents.size();
+            const char* lineEnd;
+            while (lineStart < dataEnd) {
+                lineEnd = static_cast<const char*>(std::memchr(lineStart, '\n', dataEnd - lineStart));
+                if (!lineEnd) lineEnd = dataEnd;
+                lines.push_back(makeIniLine(std::string_view(lineStart, lineEnd - lineStart)));
+                lineStart = lineEnd + 1;
+            }
         }
-    
-        // Declare all variables outside the loop for efficiency
-        char line[1024];
-        std::string currentSection;
-        //currentSection.reserve(64);
-        
-        std::string lineStr;
-        //lineStr.reserve(1024);
-        
-        std::string trimmedLine;
-        //trimmedLine.reserve(1024);
-        
-        std::string lineKey;
-        //lineKey.reserve(128);
-        
-        bool inTargetSection = false;
-        size_t eqPos;
-        
-        while (fgets(line, sizeof(line), configFile)) {
-            lineStr.assign(line);
-            
-            // Create a trimmed copy for parsing
-            trimmedLine = lineStr;
-            if (!trimmedLine.empty() && trimmedLine.back() == '\n') {
-                trimmedLine.pop_back();
-                if (!trimmedLine.empty() && trimmedLine.back() == '\r') {
-                    trimmedLine.pop_back();
+
+        std::deque<std::string> editedLines;
+        bool modified = false;
+        size_t header, sectionEnd, i;
+
+        for (const Edit& edit : edits) {
+            switch (edit.type) {
+                case EditType::SetValue: {
+                    const std::string& targetKey = edit.extra.empty() ? edit.key : edit.extra;
+                    header = findIniSectionLine(lines, edit.section);
+                    if (header == std::string::npos) {
+                        if (!lines.empty() && !isBlankIniLine(lines.back())) {
+                            lines.push_back(makeIniLine(editedLines, ""));  // Blank line before a new section
+                        }
+                        lines.push_back(makeIniLine(editedLines, '[' + edit.section + ']'));
+                        lines.push_back(makeIniLine(editedLines, edit.key + '=' + edit.value));
+                        modified = true;
+                        break;
+                    }
+
+                    sectionEnd = findIniSectionEnd(lines, header);
+                    size_t lastContent = header;
+                    bool keyFound = false;
+                    for (i = header + 1; i < sectionEnd; ++i) {
+                        if (lines[i].kind == IniLineKind::Pair && lines[i].name == edit.key) {
+                            std::string replacement = targetKey + '=' + edit.value;
+                            if (lines[i].text != replacement) {
+                                lines[i] = makeIniLine(editedLines, std::move(replacement));
+                                modified = true;
+                            }
+                            keyFound = true;
+                            break;
+                        }
+                        if (!isBlankIniLine(lines[i])) lastContent = i;
+                    }
+
+                    if (!keyFound) {
+                        lines.insert(lines.begin() + lastContent + 1, makeIniLine(editedLines, edit.key + '=' + edit.value));
+                        modified = true;
+                    }
+                    break;
                 }
-            }
-            trim(trimmedLine);
-    
-            if (!trimmedLine.empty() && trimmedLine.front() == '[' && trimmedLine.back() == ']') {
-                currentSection.assign(trimmedLine, 1, trimmedLine.length() - 2);
-                inTargetSection = (currentSection == sectionName);
-                fprintf(tempFile, "%s", line); // Write original line
-            } else if (inTargetSection) {
-                // Check if line starts with the key (handle spaces around =)
-                eqPos = trimmedLine.find('=');
-                if (eqPos != std::string::npos) {
-                    lineKey.assign(trimmedLine, 0, eqPos);
-                    trim(lineKey);
-                    if (lineKey == keyName) {
-                        continue; // Skip this line
+
+                case EditType::AddSection:
+                    if (findIniSectionLine(lines, edit.section) == std::string::npos) {
+                        lines.push_back(makeIniLine(editedLines, '[' + edit.section + ']'));
+                        modified = true;
+                    }
+                    break;
+
+                case EditType::RenameSection:
+                    for (IniLine& line : lines) {
+                        if (line.kind == IniLineKind::Section && line.name == edit.section) {
+                            line = makeIniLine(editedLines, '[' + edit.extra + ']');
+                            modified = true;
+                        }
                     }
+                    break;
+
+                case EditType::RemoveSection: {
+                    bool inTargetSection = false;
+                    const size_t before = lines.size();
+                    lines.erase(std::remove_if(lines.begin(), lines.end(), [&](const IniLine& line) {
+                        if (line.kind == IniLineKind::Section) {
+                            inTargetSection = (line.name == edit.section);
+                        }
+                        return inTargetSection;
+                    }), lines.end());
+                    modified |= (lines.size() != before);
+                    break;
+                }
+
+                case EditType::RemoveKey: {
+                    bool inTargetSection = false;
+                    const size_t before = lines.size();
+                    lines.erase(std::remove_if(lines.begin(), lines.end(), [&](const IniLine& line) {
+                        if (line.kind == IniLineKind::Section) {
+                            inTargetSection = (line.name == edit.section);
+                            return false;
+                        }
+                        return inTargetSection && line.kind == IniLineKind::Pair && line.name == edit.key;
+                    }), lines.end());
+                    modified |= (lines.size() != before);
+                    break;
                 }
-                fprintf(tempFile, "%s", line);
-            } else {
-                fprintf(tempFile, "%s", line);
             }
         }
+
+        edits.clear();
+
+        if (!modified || (!fileExists && lines.empty())) {
+            return true;
+        }
+
+        if (!fileExists) {
+            createDirectory(getParentDirFromPath(filePath));
+        }
+
+        // Join lines back together
+        size_t totalSize = 0;
+        for (const IniLine& line : lines) totalSize += line.text.size() + 1;
+
+        std::string output;
+        output.reserve(totalSize);
+        for (const IniLine& line : lines) {
+            output += line.text;
+            output += '\n';
+        }
+
+        iniWriteCommits.fetch_add(1, std::memory_order_relaxed);
+        iniWriteFullBytes.fetch_add(output.size(), std::memory_order_relaxed);
+
+        // Large files are patched in place to spare the SD card a full rewrite
+        size_t bytesWritten = 0;
+        if (fileExists && contents.size() >= INI_PATCH_MIN_SIZE &&
+            patchIniFileContents(filePath, contents, output, bytesWritten)) {
+            iniWritePatches.fetch_add(1, std::memory_order_relaxed);
+            iniWriteBytes.fetch_add(bytesWritten, std::memory_order_relaxed);
+            return true;
+        }
+
+        if (!commitIniFileContents(filePath, output)) {
+            return false;
+        }
+        iniWriteBytes.fetch_add(output.size(), std::memory_order_relaxed);
+        return true;
+    }
+
+
+    /**
+     * @brief Returns the INI write counters.
+     */
+    IniWriteStats getIniWriteStats() {
+        IniWriteStats stats;
+        stats.commits = iniWriteCommits.load(std::memory_order_relaxed);
+        stats.patches = iniWritePatches.load(std::memory_order_relaxed);
+        stats.bytesWritten = iniWriteBytes.load(std::memory_order_relaxed);
+        stats.bytesFullRewrite = iniWriteFullBytes.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    /**
+     * @brief Resets the INI write counters.
+     */
+    void resetIniWriteStats() {
+        iniWriteCommits.store(0, std::memory_order_relaxed);
+        iniWritePatches.store(0, std::memory_order_relaxed);
+        iniWriteBytes.store(0, std::memory_order_relaxed);
+        iniWriteFullBytes.store(0, std::memory_order_relaxed);
+    }
+
+
+    /**
+     * @brief Modifies or creates an INI file by adding or updating key-value pairs in the specified section.
+     *
+     * This function attempts to open the specified INI file for reading. If the file doesn't exist,
+     * it creates a new file and adds the specified section and key-value pair. If the file exists,
+     * it reads its contents, modifies or adds the key-value pair in the specified section, and saves
+     * the changes back to the original file.
+     *
+     * @param fileToEdit      The path to the INI file to be modified or created.
+     * @param desiredSection  The name of the section in which the key-value pair should be added or updated.
+     * @param desiredKey      The key for the key-value pair to be added or updated.
+     * @param desiredValue    The new value for the key-value pair.
+     * @param desiredNewKey   (Optional) If provided, the function will rename the key while preserving the original value.
+     * @param comment         An optional comment to be added (not currently implemented).
+     */
+    void setIniFile(const std::string& fileToEdit, const std::string& desiredSection, const std::string& desiredKey, const std::string& desiredValue, const std::string& desiredNewKey, const std::string& comment) {
+        IniTransaction(fileToEdit).setValue(desiredSection, desiredKey, desiredValue, desiredNewKey).commit();
+    }
     
-        fclose(configFile);
-        fclose(tempFile);
-    #else
-        std::ifstream configFile(filePath);
-        if (!configFile) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Failed to open the input file: " + filePath);
-            #endif
-            return;
-        }
     
-        std::string tempPath = filePath + ".tmp";
-        std::ofstream tempFile(tempPath);
-        if (!tempFile) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Failed to create the temporary file: " + tempPath);
-            #endif
-            return;
-        }
+    /**
+     * @brief Sets the value of a key in an INI file within the specified section and cleans the formatting.
+     *
+     * This function sets the value of the specified key within the given section of the INI file.
+     * If the key or section does not exist, it creates them. After updating the INI file,
+     * it cleans the formatting to ensure proper INI file structure.
+     *
+     * @param fileToEdit      The path to the INI file to be modified or created.
+     * @param desiredSection  The name of the section in which the key-value pair should be added or updated.
+     * @param desiredKey      The key for the key-value pair to be added or updated.
+     * @param desiredValue    The new value for the key-value pair.
+     */
+    void setIniFileValue(const std::string& fileToEdit, const std::string& desiredSection, const std::string& desiredKey, const std::string& desiredValue, const std::string& comment) {
+        setIniFile(fileToEdit, desiredSection, desiredKey, desiredValue, "", comment);
+        //cleanIniFormatting(fileToEdit);
+    }
+    
+    /**
+     * @brief Sets the key name to a new name in an INI file within the specified section and cleans the formatting.
+     *
+     * This function sets the key name to a new name within the given section of the INI file.
+     * If the key or section does not exist, it creates them. After updating the INI file,
+     * it cleans the formatting to ensure proper INI file structure.
+     *
+     * @param fileToEdit      The path to the INI file to be modified or created.
+     * @param desiredSection  The name of the section in which the key-name change should occur.
+     * @param desiredKey      The key name to be changed.
+     * @param desiredNewKey   The new key name to replace the original key name.
+     */
+    void setIniFileKey(const std::string& fileToEdit, const std::string& desiredSection, const std::string& desiredKey, const std::string& desiredNewKey, const std::string& comment) {
+        setIniFile(fileToEdit, desiredSection, desiredKey, "", desiredNewKey, comment);
+        //cleanIniFormatting(fileToEdit);
+    }
+    
     
-        // Declare all variables outside the loop for efficiency
-        std::string line;
-        //line.reserve(1024);
-        
-        std::string currentSection;
-        //currentSection.reserve(64);
-        
-        std::string trimmedLine;
-        //trimmedLine.reserve(1024);
-        
-        std::string lineKey;
-        //lineKey.reserve(128);
         
-        bool inTargetSection = false;
-        size_t eqPos;
+    /**
+     * @brief Adds a new section to an INI file.
+     *
+     * This function adds a new section with the specified name to the INI file located at the
+     * specified path. If the section already exists, it does nothing.
+     *
+     * @param filePath The path to the INI file.
+     * @param sectionName The name of the section to add.
+     */
+    void addIniSection(const std::string& filePath, const std::string& sectionName) {
+        IniTransaction(filePath).addSection(sectionName).commit();
+    }
     
-        while (getline(configFile, line)) {
-            trimmedLine = line;
-            // Remove carriage return if present
-            if (!trimmedLine.empty() && trimmedLine.back() == '\r') {
-                trimmedLine.pop_back();
-            }
-            trim(trimmedLine);
-    
-            if (!trimmedLine.empty() && trimmedLine.front() == '[' && trimmedLine.back() == ']') {
-                currentSection.assign(trimmedLine, 1, trimmedLine.length() - 2);
-                inTargetSection = (currentSection == sectionName);
-                tempFile << line << '\n';
-            } else if (inTargetSection) {
-                // Better key matching that handles spaces
-                eqPos = trimmedLine.find('=');
-                if (eqPos != std::string::npos) {
-                    lineKey.assign(trimmedLine, 0, eqPos);
-                    trim(lineKey);
-                    if (lineKey == keyName) {
-                        continue; // Skip this line
-                    }
-                }
-                tempFile << line << '\n';
-            } else {
-                tempFile << line << '\n';
-            }
-        }
     
-        configFile.close();
-        tempFile.close();
-    #endif
+    /**
+     * @brief Renames a section in an INI file.
+     *
+     * This function renames the section with the specified current name to the specified new name
+     * in the INI file located at the specified path. If the current section does not exist, it does nothing.
+     *
+     * @param filePath The path to the INI file.
+     * @param currentSectionName The name of the section to rename.
+     * @param newSectionName The new name for the section.
+     */
+    void renameIniSection(const std::string& filePath, const std::string& currentSectionName, const std::string& newSectionName) {
+        IniTransaction(filePath).renameSection(currentSectionName, newSectionName).commit();
+    }
+
     
-        // Replace the original file with the temp file
-        if (remove(filePath.c_str()) != 0) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Failed to delete the original file: " + filePath);
-            #endif
-            return;
-        }
+    /**
+     * @brief Removes a section from an INI file.
+     *
+     * This function removes the section with the specified name, including all its associated key-value
+     * pairs, from the INI file located at the specified path. If the section does not exist in the file,
+     * it does nothing.
+     *
+     * @param filePath The path to the INI file.
+     * @param sectionName The name of the section to remove.
+     */
+    void removeIniSection(const std::string& filePath, const std::string& sectionName) {
+        IniTransaction(filePath).removeSection(sectionName).commit();
+    }
     
-        if (rename(tempPath.c_str(), filePath.c_str()) != 0) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Failed to rename the temporary file: " + tempPath);
-            #endif
-        }
+
+    /**
+     * @brief Removes a key-value pair from an INI file.
+     */
+    void removeIniKey(const std::string& filePath, const std::string& sectionName, const std::string& keyName) {
+        IniTransaction(filePath).removeKey(sectionName, keyName).commit();
     }
     
     //void saveIniFileData(const std::string& filePath, const std::map<std::string, std::map<std::string, std::string>>& data) {
@@ -1987,6 +2305,56 @@ namespace ult {
     }
     
     
+    namespace {
+        // Splits [data, end) into arguments, honoring single and double quotes
+        std::vector<std::string> tokenizeCommandLine(const char* const data, const char* const end) {
+            std::vector<std::string> commandParts;
+            
+            const char* pos = data;
+            
+            //commandParts.reserve(8);
+            
+            while (pos < end) {
+                // Skip leading whitespace
+                while (pos < end && (*pos == ' ' || *pos == '\t')) {
+                    ++pos;
+                }
+                
+                if (pos >= end) break;
+                
+                const char* argStart = pos;
+                const char* argEnd = pos;
+                
+                if (*pos == '\'' || *pos == '"') {
+                    // Quoted argument
+                    const char quoteChar = *pos;
+                    ++pos; // Skip opening quote
+                    argStart = pos;
+                    
+                    // Find closing quote
+                    while (pos < end && *pos != quoteChar) {
+                        ++pos;
+                    }
+                    
+                    argEnd = pos;
+                    if (pos < end) ++pos; // Skip closing quote
+                } else {
+                    // Unquoted argument
+                    while (pos < end && *pos != ' ' && *pos != '\t' && *pos != '\'' && *pos != '"') {
+                        ++pos;
+                    }
+                    argEnd = pos;
+                }
+                
+                if (argEnd >= argStart) {
+                    commandParts.emplace_back(argStart, argEnd - argStart);
+                }
+            }
+            
+            return commandParts;
+        }
+    }
+    
     /**
      * @brief Parses a command line into individual parts, handling quoted strings.
      *
@@ -1994,59 +2362,236 @@ namespace ult {
      * @return A vector of strings containing the parsed command parts.
      */
     std::vector<std::string> parseCommandLine(const std::string& line) {
-        std::vector<std::string> commandParts;
-        
-        const char* const data = line.data();
-        const char* const end = data + line.length();
-        const char* pos = data;
-        
-        //commandParts.reserve(8);
+        return tokenizeCommandLine(line.data(), line.data() + line.length());
+    }
+    
+    
+    // Package options cache infrastructure
+    namespace {
+        using PackageOptions = std::vector<std::pair<std::string, std::vector<std::vector<std::string>>>>;
+        
+        constexpr uint32_t OPTIONS_CACHE_MAGIC = 0x434F4855; // "UHOC"
+        constexpr uint32_t OPTIONS_CACHE_VERSION = 1;
+        
+        // Source was modified within the mtime resolution of the sidecar write
+        constexpr uint32_t OPTIONS_CACHE_RACY = 1u << 0;
+        
+        std::atomic<size_t> optionsCacheHits{0};
+        std::atomic<size_t> optionsCacheMisses{0};
+        
+        /**
+         * @brief Header of a package options sidecar file.
+         *
+         * The sidecar is valid for a source INI whose size and mtime match. When only the
+         * mtime differs, a matching content hash still validates it. A sidecar written in
+         * the same second the source was modified is marked racy, since a second edit of
+         * the same size would keep the mtime, and is only trusted after a hash check.
+         */
+        struct OptionsCacheHeader {
+            uint32_t magic = OPTIONS_CACHE_MAGIC;
+            uint32_t version = OPTIONS_CACHE_VERSION;
+            uint32_t flags = 0;
+            uint32_t reserved = 0;
+            uint64_t sourceSize = 0;
+            int64_t sourceTime = 0;
+            uint64_t sourceHash = 0;
+        };
         
-        while (pos < end) {
-            // Skip leading whitespace
-            while (pos < end && (*pos == ' ' || *pos == '\t')) {
-                ++pos;
+        // 64-bit FNV-1a
+        uint64_t hashBytes(const char* data, size_t size) {
+            uint64_t hash = 0xcbf29ce484222325ULL;
+            for (size_t i = 0; i < size; ++i) {
+                hash ^= static_cast<unsigned char>(data[i]);
+                hash *= 0x100000001b3ULL;
+            }
+            return hash;
+        }
+        
+        std::string getOptionsCachePath(const std::string& packageIniPath) {
+            char name[32];
+            snprintf(name, sizeof(name), "%016llx.bin",
+                     static_cast<unsigned long long>(hashBytes(packageIniPath.data(), packageIniPath.size())));
+            return OPTIONS_CACHE_PATH + name;
+        }
+        
+        /**
+         * @brief Tokenizes every section of a package INI held in memory.
+         *
+         * Lines starting with '#' are skipped, and lines before the first non-empty
+         * section header are ignored.
+         */
+        PackageOptions parsePackageOptions(const char* data, size_t size) {
+            PackageOptions options;
+            options.reserve(32); // Reserve reasonable capacity
+            
+            std::string currentSection;
+            std::vector<std::vector<std::string>> sectionCommands;
+            sectionCommands.reserve(16);
+            
+            const char* lineStart = data;
+            const char* const dataEnd = data + size;
+            const char* lineEnd;
+            const char* end;
+            
+            while (lineStart < dataEnd) {
+                lineEnd = static_cast<const char*>(std::memchr(lineStart, '\n', dataEnd - lineStart));
+                if (!lineEnd) lineEnd = dataEnd;
+                
+                const char* start = lineStart;
+                end = lineEnd;
+                lineStart = (lineEnd < dataEnd) ? lineEnd + 1 : dataEnd;
+                
+                // Strip trailing carriage return
+                if (end > start && end[-1] == '\r') --end;
+                
+                if (start == end || *start == '#') continue;
+                
+                // Section header
+                if (*start == '[' && end[-1] == ']' && end - start >= 2) {
+                    if (!currentSection.empty()) {
+                        options.emplace_back(std::move(currentSection), std::move(sectionCommands));
+                        sectionCommands = std::vector<std::vector<std::string>>();
+                        sectionCommands.reserve(16);
+                    }
+                    currentSection.assign(start + 1, end - 1);
+                } else if (!currentSection.empty()) {
+                    sectionCommands.push_back(tokenizeCommandLine(start, end));
+                }
             }
             
-            if (pos >= end) break;
-            
-            const char* argStart = pos;
-            const char* argEnd = pos;
+            if (!currentSection.empty()) {
+                options.emplace_back(std::move(currentSection), std::move(sectionCommands));
+            }
             
-            if (*pos == '\'' || *pos == '"') {
-                // Quoted argument
-                const char quoteChar = *pos;
-                ++pos; // Skip opening quote
-                argStart = pos;
-                
-                // Find closing quote
-                while (pos < end && *pos != quoteChar) {
-                    ++pos;
+            return options;
+        }
+        
+        inline void appendU32(std::string& out, uint32_t value) {
+            out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+        
+        inline void appendString(std::string& out, const std::string& value) {
+            appendU32(out, static_cast<uint32_t>(value.size()));
+            out.append(value);
+        }
+        
+        /**
+         * @brief Serializes options as: header, source path, then length-prefixed
+         * sections, commands and arguments.
+         */
+        std::string serializePackageOptions(const OptionsCacheHeader& header, const std::string& packageIniPath, const PackageOptions& options) {
+            size_t totalSize = sizeof(OptionsCacheHeader) + 8 + packageIniPath.size();
+            for (const auto& [section, commands] : options) {
+                totalSize += 8 + section.size();
+                for (const auto& command : commands) {
+                    totalSize += 4;
+                    for (const auto& arg : command) totalSize += 4 + arg.size();
                 }
-                
-                argEnd = pos;
-                if (pos < end) ++pos; // Skip closing quote
-            } else {
-                // Unquoted argument
-                while (pos < end && *pos != ' ' && *pos != '\t' && *pos != '\'' && *pos != '"') {
-                    ++pos;
+            }
+            
+            std::string out;
+            out.reserve(totalSize);
+            out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+            appendString(out, packageIniPath);
+            appendU32(out, static_cast<uint32_t>(options.size()));
+            for (const auto& [section, commands] : options) {
+                appendString(out, section);
+                appendU32(out, static_cast<uint32_t>(commands.size()));
+                for (const auto& command : commands) {
+                    appendU32(out, static_cast<uint32_t>(command.size()));
+                    for (const auto& arg : command) appendString(out, arg);
                 }
-                argEnd = pos;
+            }
+            return out;
+        }
+        
+        // Bounds-checked cursor over a sidecar buffer
+        struct OptionsCacheReader {
+            const char* pos;
+            const char* end;
+            
+            bool readU32(uint32_t& value) {
+                if (end - pos < static_cast<ptrdiff_t>(sizeof(value))) return false;
+                std::memcpy(&value, pos, sizeof(value));
+                pos += sizeof(value);
+                return true;
             }
             
-            if (argEnd >= argStart) {
-                commandParts.emplace_back(argStart, argEnd - argStart);
+            bool readString(std::string& value) {
+                uint32_t length;
+                if (!readU32(length) || end - pos < static_cast<ptrdiff_t>(length)) return false;
+                value.assign(pos, length);
+                pos += length;
+                return true;
+            }
+        };
+        
+        bool deserializePackageOptions(const std::string& buffer, const std::string& packageIniPath, OptionsCacheHeader& header, PackageOptions& options) {
+            if (buffer.size() < sizeof(OptionsCacheHeader)) return false;
+            std::memcpy(&header, buffer.data(), sizeof(header));
+            if (header.magic != OPTIONS_CACHE_MAGIC || header.version != OPTIONS_CACHE_VERSION) return false;
+            
+            OptionsCacheReader reader{buffer.data() + sizeof(header), buffer.data() + buffer.size()};
+            
+            std::string storedPath;
+            if (!reader.readString(storedPath) || storedPath != packageIniPath) return false;
+            
+            uint32_t sectionCount, commandCount, argCount;
+            if (!reader.readU32(sectionCount)) return false;
+            
+            options.clear();
+            options.reserve(sectionCount);
+            for (uint32_t s = 0; s < sectionCount; ++s) {
+                auto& [section, commands] = options.emplace_back();
+                if (!reader.readString(section) || !reader.readU32(commandCount)) return false;
+                commands.reserve(commandCount);
+                for (uint32_t c = 0; c < commandCount; ++c) {
+                    auto& command = commands.emplace_back();
+                    if (!reader.readU32(argCount)) return false;
+                    command.reserve(argCount);
+                    for (uint32_t a = 0; a < argCount; ++a) {
+                        if (!reader.readString(command.emplace_back())) return false;
+                    }
+                }
             }
+            return reader.pos == reader.end;
         }
         
-        return commandParts;
+        void writeOptionsCache(const std::string& cachePath, const std::string& contents) {
+            auto cacheMutex = getFileMutex(cachePath);
+            std::unique_lock<std::shared_mutex> lock(*cacheMutex);
+            
+            createDirectory(OPTIONS_CACHE_PATH);
+            commitIniFileContents(cachePath, contents);
+        }
     }
-        
+    
+    /**
+     * @brief Returns the hit/miss counters of the package options sidecar cache.
+     */
+    IniCacheStats getOptionsCacheStats() {
+        IniCacheStats stats;
+        stats.hits = optionsCacheHits.load(std::memory_order_relaxed);
+        stats.misses = optionsCacheMisses.load(std::memory_order_relaxed);
+        return stats;
+    }
+    
+    /**
+     * @brief Deletes every package options sidecar file.
+     */
+    void clearOptionsCache() {
+        deleteFileOrDirectory(OPTIONS_CACHE_PATH);
+        optionsCacheHits.store(0, std::memory_order_relaxed);
+        optionsCacheMisses.store(0, std::memory_order_relaxed);
+    }
+    
     
     /**
      * @brief Loads and parses options from an INI file.
      *
      * This function reads and parses options from an INI file, organizing them by section.
+     * The tokenized result is stored in a binary sidecar under OPTIONS_CACHE_PATH and is
+     * loaded from there with a single read until the source INI changes.
      *
      * @param packageIniPath The path to the INI file.
      * @return A vector containing pairs of section names and their associated key-value pairs.
@@ -2055,87 +2600,59 @@ namespace ult {
         auto fileMutex = getFileMutex(packageIniPath);
         std::shared_lock<std::shared_mutex> lock(*fileMutex);
         
-    #if !USING_FSTREAM_DIRECTIVE
-        FILE* packageFile = fopen(packageIniPath.c_str(), "r");
-        if (!packageFile) return {};
+        struct stat sourceStat;
+        if (stat(packageIniPath.c_str(), &sourceStat) != 0 || !S_ISREG(sourceStat.st_mode)) {
+            return {};
+        }
         
-        std::vector<std::pair<std::string, std::vector<std::vector<std::string>>>> options;
-        options.reserve(32); // Reserve reasonable capacity
+        const std::string cachePath = getOptionsCachePath(packageIniPath);
+        PackageOptions options;
+        OptionsCacheHeader cachedHeader;
+        bool cacheValid = false;
         
-        char buffer[1024];
-        std::string currentSection;
-        std::vector<std::vector<std::string>> sectionCommands;
-        sectionCommands.reserve(16);
-    
-        while (fgets(buffer, sizeof(buffer), packageFile)) {
-            size_t len = strlen(buffer);
-            
-            // Strip trailing newline/carriage return
-            if (len > 0 && buffer[len-1] == '\n') {
-                if (--len > 0 && buffer[len-1] == '\r') --len;
-            }
-            
-            if (len == 0 || buffer[0] == '#') continue;
-            
-            // Section header
-            if (buffer[0] == '[' && buffer[len-1] == ']') {
-                if (!currentSection.empty()) {
-                    options.emplace_back(std::move(currentSection), std::move(sectionCommands));
-                    sectionCommands = std::vector<std::vector<std::string>>();
-                    sectionCommands.reserve(16);
-                }
-                currentSection.assign(buffer + 1, len - 2);
-            } else if (!currentSection.empty()) {
-                // Parse command directly from buffer - avoid string construction
-                sectionCommands.push_back(parseCommandLine(std::string(buffer, len)));
-            }
+        std::string cacheContents;
+        {
+            auto cacheMutex = getFileMutex(cachePath);
+            std::shared_lock<std::shared_mutex> cacheLock(*cacheMutex);
+            cacheValid = readIniFileContents(cachePath, cacheContents) &&
+                         deserializePackageOptions(cacheContents, packageIniPath, cachedHeader, options);
         }
-    
-        if (!currentSection.empty()) {
-            options.emplace_back(std::move(currentSection), std::move(sectionCommands));
+        cacheContents = std::string();
+        
+        const bool statMatches = cacheValid &&
+            cachedHeader.sourceSize == static_cast<uint64_t>(sourceStat.st_size) &&
+            cachedHeader.sourceTime == static_cast<int64_t>(sourceStat.st_mtime);
+        
+        if (statMatches && !(cachedHeader.flags & OPTIONS_CACHE_RACY)) {
+            optionsCacheHits.fetch_add(1, std::memory_order_relaxed);
+            return options;
         }
         
-        fclose(packageFile);
-    #else
-        std::ifstream packageFile(packageIniPath);
-        if (!packageFile) return {};
-    
-        std::vector<std::pair<std::string, std::vector<std::vector<std::string>>>> options;
-        options.reserve(32);
+        std::string source;
+        if (!readIniFileContents(packageIniPath, source)) {
+            return {};
+        }
         
-        std::string line;
-        line.reserve(256);
-        std::string currentSection;
-        std::vector<std::vector<std::string>> sectionCommands;
-        sectionCommands.reserve(16);
-    
-        while (std::getline(packageFile, line)) {
-            // Remove carriage return if present
-            if (!line.empty() && line.back() == '\r') {
-                line.pop_back();
-            }
-    
-            if (line.empty() || line[0] == '#') continue;
-    
-            if (line[0] == '[' && line.back() == ']') {
-                if (!currentSection.empty()) {
-                    options.emplace_back(std::move(currentSection), std::move(sectionCommands));
-                    sectionCommands = std::vector<std::vector<std::string>>();
-                    sectionCommands.reserve(16);
-                }
-                currentSection.assign(line, 1, line.size() - 2);
-            } else if (!currentSection.empty()) {
-                sectionCommands.push_back(parseCommandLine(line));
-            }
+        OptionsCacheHeader header;
+        header.sourceSize = source.size();
+        header.sourceTime = static_cast<int64_t>(sourceStat.st_mtime);
+        header.sourceHash = hashBytes(source.data(), source.size());
+        if (isRacyFileTime(header.sourceTime)) {
+            header.flags |= OPTIONS_CACHE_RACY;
         }
-    
-        if (!currentSection.empty()) {
-            options.emplace_back(std::move(currentSection), std::move(sectionCommands));
+        
+        // Same content under a new or racy mtime (e.g. the file was copied back): keep the tokens
+        if (cacheValid && cachedHeader.sourceSize == header.sourceSize && cachedHeader.sourceHash == header.sourceHash) {
+            optionsCacheHits.fetch_add(1, std::memory_order_relaxed);
+            if (statMatches && cachedHeader.flags == header.flags) {
+                return options;
+            }
+        } else {
+            optionsCacheMisses.fetch_add(1, std::memory_order_relaxed);
+            options = parsePackageOptions(source.data(), source.size());
         }
         
-        packageFile.close();
-    #endif
-    
+        writeOptionsCache(cachePath, serializePackageOptions(header, packageIniPath, options));
         return options;
     }
 
@@ -2152,90 +2669,55 @@ namespace ult {
         auto fileMutex = getFileMutex(packageIniPath);
         std::shared_lock<std::shared_mutex> lock(*fileMutex);
         
-    #if !USING_FSTREAM_DIRECTIVE
-        FILE* packageFile = fopen(packageIniPath.c_str(), "r");
-        if (!packageFile) return {};
+        const auto index = acquireSectionIndex(packageIniPath);
+        if (!index) return {};
+        
+        const auto& headers = index->headers;
+        
+        // First strict header of the target section
+        size_t first = 0;
+        while (first < headers.size() && !(headers[first].strict && headers[first].name == sectionName)) {
+            ++first;
+        }
+        if (first == headers.size()) return {};
+        
+        // The section runs until a strict header of another section; repeated target headers extend it
+        size_t next = first + 1;
+        while (next < headers.size() && !(headers[next].strict && headers[next].name != sectionName)) {
+            ++next;
+        }
+        const uint64_t spanEnd = (next < headers.size()) ? headers[next].lineStart : static_cast<uint64_t>(index->fileSize);
+        
+        std::string body;
+        if (!readIniFileRange(packageIniPath, headers[first].bodyStart, spanEnd, body)) return {};
         
         std::vector<std::vector<std::string>> sectionCommands;
         sectionCommands.reserve(16);
         
-        char buffer[1024];
-        bool inTargetSection = false;
+        const char* lineStart = body.data();
+        const char* const bodyEnd = lineStart + body.size();
+        const char* lineEnd;
+        const char* end;
         
-        while (fgets(buffer, sizeof(buffer), packageFile)) {
-            size_t len = strlen(buffer);
+        while (lineStart < bodyEnd) {
+            lineEnd = static_cast<const char*>(std::memchr(lineStart, '\n', bodyEnd - lineStart));
+            if (!lineEnd) lineEnd = bodyEnd;
             
-            // Strip trailing newline/carriage return
-            if (len > 0 && buffer[len-1] == '\n') {
-                if (--len > 0 && buffer[len-1] == '\r') --len;
-            }
+            const char* start = lineStart;
+            end = lineEnd;
+            lineStart = lineEnd + 1;
             
-            if (len == 0 || buffer[0] == '#') continue;
+            // Strip trailing carriage return
+            if (end > start && end[-1] == '\r') --end;
             
-            // Section header
-            if (buffer[0] == '[' && buffer[len-1] == ']') {
-                if (len > 2) {
-                    size_t sectionLen = len - 2;
-                    
-                    // Direct comparison without constructing string
-                    bool isTarget = (sectionLen == sectionName.length() && 
-                                    std::memcmp(buffer + 1, sectionName.data(), sectionLen) == 0);
-                    
-                    // Early exit: found target section and now leaving it
-                    if (inTargetSection && !isTarget) {
-                        break;
-                    }
-                    
-                    inTargetSection = isTarget;
-                }
-            } else if (inTargetSection) {
-                sectionCommands.push_back(parseCommandLine(std::string(buffer, len)));
-            }
+            if (start == end || *start == '#') continue;
+            
+            // Repeated target headers and empty "[]" headers are not commands
+            if (*start == '[' && end[-1] == ']' && end - start >= 2) continue;
+            
+            sectionCommands.push_back(tokenizeCommandLine(start, end));
         }
-    
-        fclose(packageFile);
-    #else
-        std::ifstream packageFile(packageIniPath);
-        if (!packageFile) return {};
         
-        std::string line;
-        line.reserve(256);
-        std::vector<std::vector<std::string>> sectionCommands;
-        sectionCommands.reserve(16);
-        bool inTargetSection = false;
-    
-        while (std::getline(packageFile, line)) {
-            // Remove carriage return if present
-            if (!line.empty() && line.back() == '\r') {
-                line.pop_back();
-            }
-    
-            if (line.empty() || line[0] == '#') continue;
-    
-            // Section header
-            if (line[0] == '[' && line.back() == ']') {
-                size_t sectionLen = line.size() - 2;
-                
-                if (sectionLen > 0) {
-                    // Direct comparison without constructing substring
-                    bool isTarget = (sectionLen == sectionName.length() && 
-                                    std::memcmp(line.data() + 1, sectionName.data(), sectionLen) == 0);
-                    
-                    // Early exit: found target section and now leaving it
-                    if (inTargetSection && !isTarget) {
-                        break;
-                    }
-                    
-                    inTargetSection = isTarget;
-                }
-            } else if (inTargetSection) {
-                sectionCommands.push_back(parseCommandLine(line));
-            }
-        }
-    
-        packageFile.close();
-    #endif
-    
         return sectionCommands;
     }
     
@@ -2252,6 +2734,7 @@ namespace ult {
     void saveIniFileData(const std::string& filePath, const std::map<std::string, std::map<std::string, std::string>>& data) {
         auto fileMutex = getFileMutex(filePath);
         std::unique_lock<std::shared_mutex> lock(*fileMutex);
+        invalidateIniCache(filePath);
         
     #if !USING_FSTREAM_DIRECTIVE
         FILE* file = fopen(filePath.c_str(), "w");
@@ -2265,6 +2748,7 @@ namespace ult {
         
         std::string buffer;
         buffer.reserve(2048); // Pre-allocate buffer
+        size_t bytesOut = 0;
         
         for (const auto& section : data) {
             buffer.clear();
@@ -2285,6 +2769,7 @@ namespace ult {
             
             // Write entire section at once
             fwrite(buffer.data(), 1, buffer.size(), file);
+            bytesOut += buffer.size();
         }
     
         fclose(file);
@@ -2300,6 +2785,7 @@ namespace ult {
         
         std::string buffer;
         buffer.reserve(2048);
+        size_t bytesOut = 0;
     
         for (const auto& section : data) {
             buffer.clear();
@@ -2320,9 +2806,11 @@ namespace ult {
             
             // Write entire section at once
             file.write(buffer.data(), buffer.size());
+            bytesOut += buffer.size();
         }
     
         file.close();
     #endif
+        recordIniWrite(bytesOut, 1);
     }
 }
\ No newline at end of file
@@ -26,6 +26,12 @@ namespace ult {
     
     size_t COPY_BUFFER_SIZE = 65536/8; // Back to non-const as requested
 
+    size_t COPY_THREADS = 2;
+
+    CopyBackend COPY_BACKEND = CopyBackend::Auto;
+
+    size_t DELETE_THREADS = 2;
+
     std::atomic<int> copyPercentage(-1);
     
     std::mutex logMutex2; // Mutex for thread-safe logging (defined here, declared as extern in header)
@@ -221,16 +227,52 @@ namespace ult {
     }
     
 
+    namespace {
+        // Appends `lines` to a log file with a single open
+        void appendLogLines(const std::string& logPath, const std::vector<std::string>& lines) {
+            if (logPath.empty() || lines.empty()) return;
+            createDirectory(getParentDirFromPath(logPath));
+            std::lock_guard<std::mutex> lock(logMutex2);
+        #if !USING_FSTREAM_DIRECTIVE
+            if (FILE* logFile = fopen(logPath.c_str(), "a")) {
+                for (const std::string& line : lines) {
+                    fprintf(logFile, "%s\n", line.c_str());
+                }
+                fclose(logFile);
+                return;
+            }
+        #else
+            std::ofstream logFile(logPath, std::ios::app);
+            if (logFile.is_open()) {
+                for (const std::string& line : lines) {
+                    logFile << line << '\n';
+                }
+                logFile.close();
+                return;
+            }
+        #endif
+            #if USING_LOGGING_DIRECTIVE
+            if (!disableLogging)
+                logMessage("Failed to open log file: " + logPath);
+            #endif
+        }
+
+    }
+
     /**
      * @brief Deletes a file or directory.
      *
      * This function deletes the file or directory specified by `path`. It can delete both files and directories.
      *
+     * A directory is walked once, trusting the entry types readdir reports and calling lstat only for
+     * DT_UNKNOWN entries. Its files are then unlinked by DELETE_THREADS workers, and the directories are
+     * removed deepest first. Deleted files are logged in walk order with a single open of `logSource`.
+     *
+     * Each log line is the path of a deleted file; only directories end in '/'.
+     *
      * @param path The path of the file or directory to be deleted.
      */
     void deleteFileOrDirectory(const std::string& pathToDelete, const std::string& logSource) {
-        std::vector<std::string> stack;
-        
         // Batch logging optimization - collect successful deletions instead of logging immediately
         std::vector<std::string> successfulDeletions;
         const bool needsLogging = !logSource.empty();
@@ -251,144 +293,99 @@ namespace ult {
                 }
             }
             
-            // Write log for single file deletion if needed
-            if (needsLogging && !successfulDeletions.empty()) {
-    #if !USING_FSTREAM_DIRECTIVE
-                createDirectory(getParentDirFromPath(logSource));
-                if (FILE* logFile = fopen(logSource.c_str(), "a")) {
-                    writeLog(logFile, pathToDelete);
-                    fclose(logFile);
-                }
-                #if USING_LOGGING_DIRECTIVE
-                else {
-                    if (!disableLogging)
-                        logMessage("Failed to open source log file: " + logSource);
-                }
-                #endif
-    #else
-                createDirectory(getParentDirFromPath(logSource));
-                std::ofstream logSourceFile(logSource, std::ios::app);
-                if (logSourceFile.is_open()) {
-                    writeLog(logSourceFile, pathToDelete);
-                    logSourceFile.close();
-                }
-                #if USING_LOGGING_DIRECTIVE
-                else {
-                    if (!disableLogging)
-                        logMessage("Failed to open source log file: " + logSource);
-                }
-                #endif
-    #endif
+            if (needsLogging) {
+                appendLogLines(logSource, successfulDeletions);
             }
             return;
         }
     
-        stack.push_back(pathToDelete);
-        struct stat pathStat;
-        std::string currentPath, filePath;
-        bool isEmpty;
-    
-        while (!stack.empty()) {
-            currentPath = stack.back();
+        // Walk once: parents are listed before their children
+        std::vector<std::string> files;
+        std::vector<std::string> directories;
+        directories.push_back(pathToDelete);
     
-            if (stat(currentPath.c_str(), &pathStat) != 0) {
-                stack.pop_back();
+        std::string entryPath;
+        struct stat entryStat;
+        bool isDir;
+        for (size_t directoryIndex = 0; directoryIndex < directories.size(); ++directoryIndex) {
+            DIR* directory = opendir(directories[directoryIndex].c_str());
+            if (!directory) {
+                #if USING_LOGGING_DIRECTIVE
+                if (!disableLogging)
+                    logMessage("Failed to open directory: " + directories[directoryIndex]);
+                #endif
                 continue;
             }
     
-            if (S_ISREG(pathStat.st_mode)) { // It's a file
-                stack.pop_back(); // Remove from stack before deletion
-                if (remove(currentPath.c_str()) == 0) {
-                    // Batch logging - store successful deletion instead of writing immediately
-                    if (needsLogging) {
-                        successfulDeletions.push_back(currentPath);
-                    }
+            const std::string currentPath = directories[directoryIndex];
+            dirent* entry;
+            while ((entry = readdir(directory)) != nullptr) {
+                if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+    
+                entryPath.assign(currentPath);
+                if (entryPath.back() != '/') entryPath += '/';
+                entryPath += entry->d_name;
+    
+                if (entry->d_type == DT_UNKNOWN) {
+                    if (lstat(entryPath.c_str(), &entryStat) != 0) continue;
+                    isDir = S_ISDIR(entryStat.st_mode);
                 } else {
-                    #if USING_LOGGING_DIRECTIVE
-                    if (!disableLogging)
-                        logMessage("Failed to delete file: " + currentPath);
-                    #endif
-                }
-            } else if (S_ISDIR(pathStat.st_mode)) { // It's a directory
-                DIR* directory = opendir(currentPath.c_str());
-                if (!directory) {
-                    #if USING_LOGGING_DIRECTIVE
-                    if (!disableLogging)
-                        logMessage("Failed to open directory: " + currentPath);
-                    #endif
-                    stack.pop_back();
-                    continue;
+                    isDir = entry->d_type == DT_DIR;
                 }
     
-                dirent* entry;
-                isEmpty = true;
-                while ((entry = readdir(directory)) != nullptr) {
-                    const std::string& fileName = entry->d_name;
-                    if (fileName != "." && fileName != "..") {
-                        filePath = currentPath + fileName;
-                        stack.push_back(filePath + (filePath.back() == '/' ? "" : "/"));
-                        isEmpty = false;
-                    }
-                }
-                closedir(directory);
-    
-                if (isEmpty) {
-                    stack.pop_back(); // Directory is now empty, safe to remove from stack
-                    if (rmdir(currentPath.c_str()) == 0) {
-                        // Note: Typically we don't log directory deletions, only files
-                        // If you want to log directory deletions too, uncomment the lines below:
-                        // if (needsLogging) {
-                        //     successfulDeletions.push_back(currentPath);
-                        // }
-                    } else {
-                        #if USING_LOGGING_DIRECTIVE
-                        if (!disableLogging)
-                            logMessage("Failed to delete directory: " + currentPath);
-                        #endif
-                    }
+                if (isDir) {
+                    entryPath += '/';
+                    directories.push_back(entryPath);
+                } else {
+                    files.push_back(entryPath);
                 }
-            } else {
-                stack.pop_back(); // Unknown file type, just remove from stack
+            }
+            closedir(directory);
+        }
+    
+        // Unlinks are independent of each other, so they are shared out to the workers
+        std::vector<char> deleted(files.size(), 0);
+        std::atomic<size_t> nextFile{0};
+        auto removeFiles = [&]() {
+            size_t i;
+            while ((i = nextFile.fetch_add(1, std::memory_order_relaxed)) < files.size()) {
+                deleted[i] = remove(files[i].c_str()) == 0;
                 #if USING_LOGGING_DIRECTIVE
-                if (!disableLogging)
-                    logMessage("Unknown file type: " + currentPath);
+                if (!deleted[i] && !disableLogging)
+                    logMessage("Failed to delete file: " + files[i]);
                 #endif
             }
+        };
+    
+        const size_t threadCount = std::min(DELETE_THREADS, files.size());
+        std::vector<std::thread> workers;
+        if (threadCount > 1) {
+            workers.reserve(threadCount - 1);
+            for (size_t t = 1; t < threadCount; ++t) {
+                workers.emplace_back(removeFiles);
+            }
+        }
+        removeFiles();  // The calling thread takes part
+        for (auto& thread : workers) {
+            thread.join();
         }
     
-        // KEY OPTIMIZATION: Batch write all successful deletions to log file at the end
-        // This eliminates the overhead of logging inside the hot loop
-        if (needsLogging && !successfulDeletions.empty()) {
-    #if !USING_FSTREAM_DIRECTIVE
-            createDirectory(getParentDirFromPath(logSource));
-            if (FILE* logFile = fopen(logSource.c_str(), "a")) {
-                for (const auto& deletedPath : successfulDeletions) {
-                    writeLog(logFile, deletedPath);
-                }
-                fclose(logFile);
-            }
-            #if USING_LOGGING_DIRECTIVE
-            else {
+        // Children were listed after their parents, so walking back removes each directory once it is empty
+        for (auto it = directories.rbegin(); it != directories.rend(); ++it) {
+            if (rmdir(it->c_str()) != 0) {
+                #if USING_LOGGING_DIRECTIVE
                 if (!disableLogging)
-                    logMessage("Failed to open source log file: " + logSource);
-            }
-            #endif
-    #else
-            createDirectory(getParentDirFromPath(logSource));
-            std::ofstream logSourceFile(logSource, std::ios::app);
-            if (logSourceFile.is_open()) {
-                for (const auto& deletedPath : successfulDeletions) {
-                    writeLog(logSourceFile, deletedPath);
-                }
-                logSourceFile.close();
+                    logMessage("Failed to delete directory: " + *it);
+                #endif
             }
-            #if USING_LOGGING_DIRECTIVE
-            else {
-                if (!disableLogging)
-                    logMessage("Failed to open source log file: " + logSource);
+        }
+    
+        // Only files are logged, all with one open of the log
+        if (needsLogging) {
+            for (size_t i = 0; i < files.size(); ++i) {
+                if (deleted[i]) successfulDeletions.push_back(std::move(files[i]));
             }
-            #endif
-    #endif
+            appendLogLines(logSource, successfulDeletions);
         }
     }
     
@@ -812,24 +809,187 @@ namespace ult {
         fileList.shrink_to_fit();
     }
     
+    namespace {
+        // Files at least this large are streamed one at a time on the calling thread,
+        // and double-buffered when COPY_BACKEND is Auto
+        constexpr long long COPY_STREAM_MIN_SIZE = 1 << 20;
+
+        enum class CopyResult { Copied, Failed, Unsupported };
+
+        inline void addCopyProgress(std::atomic<long long>& totalBytesCopied, long long bytes, long long totalSize) {
+            const long long copied = totalBytesCopied.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+            if (totalSize > 0) {
+                copyPercentage.store(static_cast<int>(100 * copied / totalSize), std::memory_order_release);
+            }
+        }
+
+    #if !USING_FSTREAM_DIRECTIVE
+        // Writes all of `length` bytes, handling partial writes
+        bool writeAll(FILE* destFile, const char* data, size_t length) {
+            size_t written;
+            while (length > 0) {
+                written = fwrite(data, 1, length, destFile);
+                if (written == 0) {
+                    #if USING_LOGGING_DIRECTIVE
+                    if (!disableLogging)
+                        logMessage("Error writing to destination file");
+                    #endif
+                    return false;
+                }
+                data += written;
+                length -= written;
+            }
+            return true;
+        }
+
+        /**
+         * @brief The plain loop: read a buffer, write it, repeat.
+         */
+        CopyResult copyBuffered(FILE* srcFile, FILE* destFile, std::atomic<long long>& totalBytesCopied,
+                                const long long totalSize, char* bufferPtr, const size_t bufferSize) {
+            size_t bytesRead;
+            while ((bytesRead = fread(bufferPtr, 1, bufferSize, srcFile)) > 0) {
+                if (abortFileOp.load(std::memory_order_acquire)) return CopyResult::Failed;
+                if (!writeAll(destFile, bufferPtr, bytesRead)) return CopyResult::Failed;
+                addCopyProgress(totalBytesCopied, static_cast<long long>(bytesRead), totalSize);
+            }
+            
+            // Check for read errors
+            if (ferror(srcFile)) {
+                #if USING_LOGGING_DIRECTIVE
+                if (!disableLogging)
+                    logMessage("Error reading from source file");
+                #endif
+                return CopyResult::Failed;
+            }
+            return CopyResult::Copied;
+        }
+
+        /**
+         * @brief Overlaps reads and writes: a reader thread fills one buffer while the caller writes the other.
+         *
+         * The caller's buffer is one of the two; the second is allocated here.
+         */
+        CopyResult copyDoubleBuffered(FILE* srcFile, FILE* destFile, std::atomic<long long>& totalBytesCopied,
+                                      const long long totalSize, char* bufferPtr, const size_t bufferSize) {
+            std::unique_ptr<char[]> secondBuffer(new char[bufferSize]);
+            char* buffers[2] = {bufferPtr, secondBuffer.get()};
+            size_t filled[2] = {0, 0};
+            bool ready[2] = {false, false};
+            bool stop = false, readError = false;
+            std::mutex slotMutex;
+            std::condition_variable slotReady;
+
+            std::thread reader([&]() {
+                size_t bytesRead, slot;
+                for (size_t n = 0; ; ++n) {
+                    slot = n & 1;
+                    {
+                        std::unique_lock<std::mutex> lock(slotMutex);
+                        slotReady.wait(lock, [&] { return !ready[slot] || stop; });
+                        if (stop) return;
+                    }
+                    bytesRead = fread(buffers[slot], 1, bufferSize, srcFile);
+                    {
+                        std::lock_guard<std::mutex> lock(slotMutex);
+                        filled[slot] = bytesRead;
+                        ready[slot] = true;
+                        readError = bytesRead < bufferSize && ferror(srcFile);
+                    }
+                    slotReady.notify_all();
+                    if (bytesRead < bufferSize) return;  // End of file or error; the short slot marks the end
+                }
+            });
+
+            CopyResult result = CopyResult::Copied;
+            size_t bytes, slot;
+            for (size_t n = 0; ; ++n) {
+                slot = n & 1;
+                {
+                    std::unique_lock<std::mutex> lock(slotMutex);
+                    slotReady.wait(lock, [&] { return ready[slot]; });
+                    bytes = filled[slot];
+                    if (bytes < bufferSize && readError) {
+                        #if USING_LOGGING_DIRECTIVE
+                        if (!disableLogging)
+                            logMessage("Error reading from source file");
+                        #endif
+                        result = CopyResult::Failed;
+                        break;
+                    }
+                }
+                if (abortFileOp.load(std::memory_order_acquire) || !writeAll(destFile, buffers[slot], bytes)) {
+                    result = CopyResult::Failed;
+                    break;
+                }
+                addCopyProgress(totalBytesCopied, static_cast<long long>(bytes), totalSize);
+                if (bytes < bufferSize) break;
+                {
+                    std::lock_guard<std::mutex> lock(slotMutex);
+                    ready[slot] = false;
+                }
+                slotReady.notify_all();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(slotMutex);
+                stop = true;
+            }
+            slotReady.notify_all();
+            reader.join();
+            return result;
+        }
+
+    #if USING_KERNEL_COPY_DIRECTIVE
+        constexpr size_t KERNEL_COPY_CHUNK = 4 << 20;  // Progress and abort are checked between chunks
+
+        /**
+         * @brief Copies inside the kernel with copy_file_range, or sendfile where that is refused.
+         *
+         * Unsupported is only returned before any byte was copied, so the caller can fall back.
+         */
+        CopyResult copyKernel(FILE* srcFile, FILE* destFile, std::atomic<long long>& totalBytesCopied, const long long totalSize) {
+            const int srcFd = fileno(srcFile);
+            const int destFd = fileno(destFile);
+            bool useSendfile = false;
+            bool copiedAny = false;
+            ssize_t copied;
+            while (true) {
+                if (abortFileOp.load(std::memory_order_acquire)) return CopyResult::Failed;
+                copied = useSendfile ? sendfile(destFd, srcFd, nullptr, KERNEL_COPY_CHUNK)
+                                     : copy_file_range(srcFd, nullptr, destFd, nullptr, KERNEL_COPY_CHUNK, 0);
+                if (copied < 0) {
+                    if (!copiedAny && (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP)) {
+                        if (useSendfile) return CopyResult::Unsupported;
+                        useSendfile = true;
+                        continue;
+                    }
+                    #if USING_LOGGING_DIRECTIVE
+                    if (!disableLogging)
+                        logMessage("Error copying file data: " + std::string(strerror(errno)));
+                    #endif
+                    return CopyResult::Failed;
+                }
+                if (copied == 0) return CopyResult::Copied;
+                copiedAny = true;
+                addCopyProgress(totalBytesCopied, static_cast<long long>(copied), totalSize);
+            }
+        }
+    #endif
+    #endif
+    }
+
     /**
-     * @brief Copies a single file from the source path to the destination path.
+     * @brief Copies the contents of `fromFile` to `toFile` using the caller's buffer.
      *
-     * This function copies a single file specified by `fromFile` to the location specified by `toFile`.
+     * Progress is added to the shared `totalBytesCopied`, so several files can be copied at once.
+     * The contents are moved by the COPY_BACKEND backend. A failed or aborted copy removes `toFile`.
      *
-     * @param fromFile The path of the source file to be copied.
-     * @param toFile The path of the destination where the file will be copied.
+     * @return True if the whole file was copied.
      */
-    void copySingleFile(const std::string& fromFile, const std::string& toFile, long long& totalBytesCopied, 
-                        const long long totalSize, const std::string& logSource, const std::string& logDestination) {
+    static bool copyFileData(const std::string& fromFile, const std::string& toFile, std::atomic<long long>& totalBytesCopied,
+                             const long long totalSize, char* bufferPtr, const size_t bufferSize) {
         static constexpr size_t maxRetries = 10;
-        const size_t bufferSize = COPY_BUFFER_SIZE;
-        
-        // Create destination directory once
-        createDirectory(getParentDirFromPath(toFile));
-        
-        // Use heap allocation for the buffer to avoid stack overflow with large buffer sizes
-        std::unique_ptr<char[]> buffer(new char[bufferSize]);
     
     #if !USING_FSTREAM_DIRECTIVE
         FILE* srcFile = nullptr;
@@ -844,7 +1004,7 @@ namespace ult {
                     if (!disableLogging)
                         logMessage("Error: Failed to open source file after " + std::to_string(maxRetries) + " retries");
                     #endif
-                    return;
+                    return false;
                 }
                 continue;
             }
@@ -857,7 +1017,7 @@ namespace ult {
                     if (!disableLogging)
                         logMessage("Error: Failed to open destination file after " + std::to_string(maxRetries) + " retries");
                     #endif
-                    return;
+                    return false;
                 }
                 continue;
             }
@@ -869,51 +1029,29 @@ namespace ult {
         FileGuard srcGuard(srcFile);
         FileGuard destGuard(destFile);
         
-        // Main copy loop - optimized for performance
-        size_t bytesRead;
-        char* bufferPtr = buffer.get();
-        size_t remainingBytes, written;
-        while ((bytesRead = fread(bufferPtr, 1, bufferSize, srcFile)) > 0) {
-            if (abortFileOp.load(std::memory_order_acquire)) {
-                remove(toFile.c_str());
-                copyPercentage.store(-1, std::memory_order_release);
-                return;
-            }
-            
-            // Write all bytes - handle partial writes
-            char* writePtr = bufferPtr;
-            remainingBytes = bytesRead;
-            
-            while (remainingBytes > 0) {
-                written = fwrite(writePtr, 1, remainingBytes, destFile);
-                if (written == 0) {
-                    #if USING_LOGGING_DIRECTIVE
-                    if (!disableLogging)
-                        logMessage("Error writing to destination file");
-                    #endif
-                    remove(toFile.c_str());
-                    copyPercentage.store(-1, std::memory_order_release);
-                    return;
-                }
-                writePtr += written;
-                remainingBytes -= written;
-            }
-            
-            totalBytesCopied += bytesRead;
-            if (totalSize > 0) {
-                copyPercentage.store(static_cast<int>(100 * totalBytesCopied / totalSize), std::memory_order_release);
+        CopyBackend backend = COPY_BACKEND;
+        CopyResult result = CopyResult::Unsupported;
+    #if USING_KERNEL_COPY_DIRECTIVE
+        if (backend == CopyBackend::Auto || backend == CopyBackend::Kernel) {
+            result = copyKernel(srcFile, destFile, totalBytesCopied, totalSize);
+        }
+    #endif
+        if (result == CopyResult::Unsupported) {
+            if (backend == CopyBackend::Auto) {
+                struct stat srcStat;
+                backend = (fstat(fileno(srcFile), &srcStat) == 0 && srcStat.st_size >= COPY_STREAM_MIN_SIZE)
+                    ? CopyBackend::DoubleBuffered : CopyBackend::Buffered;
             }
+            result = (backend == CopyBackend::DoubleBuffered)
+                ? copyDoubleBuffered(srcFile, destFile, totalBytesCopied, totalSize, bufferPtr, bufferSize)
+                : copyBuffered(srcFile, destFile, totalBytesCopied, totalSize, bufferPtr, bufferSize);
         }
         
-        // Check for read errors
-        if (ferror(srcFile)) {
-            #if USING_LOGGING_DIRECTIVE
-            if (!disableLogging)
-                logMessage("Error reading from source file");
-            #endif
+        if (result != CopyResult::Copied || fclose(destGuard.release()) != 0) {
+            if (FILE* openFile = destGuard.release()) fclose(openFile);
             remove(toFile.c_str());
             copyPercentage.store(-1, std::memory_order_release);
-            return;
+            return false;
         }
     
     #else
@@ -937,19 +1075,18 @@ namespace ult {
                 if (!disableLogging)
                     logMessage("Error: Failed to open files after " + std::to_string(maxRetries) + " retries");
                 #endif
-                return;
+                return false;
             }
         }
         
         // Main copy loop
-        char* bufferPtr = buffer.get();
         while (srcFile.read(bufferPtr, bufferSize) || srcFile.gcount() > 0) {
             if (abortFileOp.load(std::memory_order_acquire)) {
                 srcFile.close();
                 destFile.close();
                 remove(toFile.c_str());
                 copyPercentage.store(-1, std::memory_order_release);
-                return;
+                return false;
             }
             
             std::streamsize bytesToWrite = srcFile.gcount();
@@ -964,18 +1101,40 @@ namespace ult {
                 destFile.close();
                 remove(toFile.c_str());
                 copyPercentage.store(-1, std::memory_order_release);
-                return;
+                return false;
             }
             
-            totalBytesCopied += bytesToWrite;
-            if (totalSize > 0) {
-                copyPercentage.store(static_cast<int>(100 * totalBytesCopied / totalSize), std::memory_order_release);
-            }
+            addCopyProgress(totalBytesCopied, bytesToWrite, totalSize);
         }
         
         srcFile.close();
         destFile.close();
     #endif
+        return true;
+    }
+
+    /**
+     * @brief Copies a single file from the source path to the destination path.
+     *
+     * This function copies a single file specified by `fromFile` to the location specified by `toFile`.
+     *
+     * @param fromFile The path of the source file to be copied.
+     * @param toFile The path of the destination where the file will be copied.
+     */
+    void copySingleFile(const std::string& fromFile, const std::string& toFile, long long& totalBytesCopied, 
+                        const long long totalSize, const std::string& logSource, const std::string& logDestination) {
+        const size_t bufferSize = COPY_BUFFER_SIZE;
+        
+        // Create destination directory once
+        createDirectory(getParentDirFromPath(toFile));
+        
+        // Use heap allocation for the buffer to avoid stack overflow with large buffer sizes
+        std::unique_ptr<char[]> buffer(new char[bufferSize]);
+        
+        std::atomic<long long> bytesCopied(totalBytesCopied);
+        const bool success = copyFileData(fromFile, toFile, bytesCopied, totalSize, buffer.get(), bufferSize);
+        totalBytesCopied = bytesCopied.load(std::memory_order_relaxed);
+        if (!success) return;
         
         // Only open and write to log files if they're needed - this is the key optimization!
         if (!logSource.empty()) {
@@ -1064,91 +1223,80 @@ namespace ult {
         return 0; // Non-file/directory entries
     }
     
-    /**
-     * @brief Copies a file or directory from the source path to the destination path.
-     *
-     * This function copies a file or directory specified by `fromFileOrDirectory` to the location specified by `toFileOrDirectory`.
-     * If the source is a regular file, it copies the file to the destination. If the source is a directory, it recursively copies
-     * the entire directory and its contents to the destination.
-     *
-     * @param fromPath The path of the source file or directory to be copied.
-     * @param toPath The path of the destination where the file or directory will be copied.
-     */
-    void copyFileOrDirectory(const std::string& fromPath, const std::string& toPath, long long* totalBytesCopied, long long totalSize,
-        const std::string& logSource, const std::string& logDestination) {
-        bool isTopLevelCall = totalBytesCopied == nullptr;
-        long long tempBytesCopied = 0;
-    
-        // Batch logging optimization - collect successful operations instead of logging immediately
-        std::vector<std::string> successfulSources, successfulDestinations;
-        bool needsLogging = !logSource.empty() || !logDestination.empty();
-        bool filesCopied = false;
-    
-        if (isTopLevelCall) {
-            totalSize = getTotalSize(fromPath);
-            totalBytesCopied = &tempBytesCopied;
-        }
-    
-        if (toPath.back() != '/') {
-            // If toPath is a file, create its parent directory and copy the file
-            createDirectory(getParentDirFromPath(toPath));
-            copySingleFile(fromPath, toPath, *totalBytesCopied, totalSize, logSource, logDestination);
-            return;
+    namespace {
+        struct CopyJob {
+            std::string from;
+            std::string to;
+            long long size;
+        };
+
+        /**
+         * @brief Everything a copy will touch, gathered in one walk before any data moves.
+         */
+        struct CopyPlan {
+            std::vector<CopyJob> files;
+            std::vector<std::string> roots;  // Destination roots, created with their parents
+            std::vector<std::pair<std::string, std::string>> directories;  // Non-empty (from, to) pairs, parents first
+            long long totalSize = 0;
+        };
+
+        inline std::string joinPath(const std::string& directory, const char* name) {
+            std::string path;
+            path.reserve(directory.size() + strlen(name) + 1);
+            path = directory;
+            if (path.empty() || path.back() != '/') path += '/';
+            path += name;
+            return path;
         }
-    
-        // Ensure the toPath directory exists
-        createDirectory(toPath);
-    
-        std::vector<std::pair<std::string, std::string>> directories;
-        directories.emplace_back(fromPath, toPath); // Use emplace_back for efficiency
-    
-        size_t currentDirectoryIndex = 0;
-        
-        // Pre-declare strings to avoid repeated allocations
-        std::string filename, toFilePath, toDirPath, currentFromPath, currentToPath;
-        std::string subFromPath, subToPath;
-    
-        struct stat fromStat;
-    
-        while (currentDirectoryIndex < directories.size()) {
-            if (abortFileOp.load(std::memory_order_acquire)) {
-                copyPercentage.store(-1, std::memory_order_release);
-                return;
-            }
-            
-            // Use structured binding more efficiently
-            const auto& [currentFrom, currentTo] = directories[currentDirectoryIndex++];
-            currentFromPath = currentFrom;
-            currentToPath = currentTo;
-    
-            if (stat(currentFromPath.c_str(), &fromStat) != 0) {
+
+        /**
+         * @brief Adds what copyFileOrDirectory(fromPath, toPath) would copy to `plan`.
+         *
+         * Each directory is read once and each entry is stat'ed at most once; entries the
+         * directory listing already reports as directories are not stat'ed at all.
+         *
+         * @return False if the walk was aborted.
+         */
+        bool planCopy(const std::string& fromPath, const std::string& toPath, CopyPlan& plan) {
+            struct stat fromStat;
+            if (stat(fromPath.c_str(), &fromStat) != 0) {
                 #if USING_LOGGING_DIRECTIVE
                 if (!disableLogging)
-                    logMessage("Failed to get stat of " + currentFromPath);
+                    logMessage("Failed to get stat of " + fromPath);
                 #endif
-                continue;
+                return true;
+            }
+    
+            if (toPath.back() != '/') {
+                if (S_ISREG(fromStat.st_mode)) {
+                    plan.roots.push_back(getParentDirFromPath(toPath));
+                    plan.files.push_back({fromPath, toPath, static_cast<long long>(fromStat.st_size)});
+                    plan.totalSize += fromStat.st_size;
+                }
+                return true;
             }
     
+            plan.roots.push_back(toPath);
             if (S_ISREG(fromStat.st_mode)) {
-                // If it's a regular file, copy it to the toPath directory
-                filename = getNameFromPath(currentFromPath);
-                
-                // More efficient path building
-                toFilePath.assign(getParentDirFromPath(currentToPath));
-                toFilePath += '/';
-                toFilePath += filename;
-                
-                createDirectory(getParentDirFromPath(toFilePath)); // Ensure the parent directory exists
-                copySingleFile(currentFromPath, toFilePath, *totalBytesCopied, totalSize, logSource, logDestination);
-                
-                // Mark that files were copied
-                filesCopied = true;
+                plan.files.push_back({fromPath, joinPath(toPath, getNameFromPath(fromPath).c_str()), static_cast<long long>(fromStat.st_size)});
+                plan.totalSize += fromStat.st_size;
+                return true;
+            }
+            if (!S_ISDIR(fromStat.st_mode)) return true;
+    
+            std::vector<std::pair<std::string, std::string>> pending;  // Directories still to read
+            pending.emplace_back(fromPath, toPath);
     
-                if (totalSize > 0) {
-                    copyPercentage.store(static_cast<int>((*totalBytesCopied * 100) / totalSize), std::memory_order_release); // Update progress
+            std::string subFromPath;
+            bool isDir;
+            for (size_t currentDirectoryIndex = 0; currentDirectoryIndex < pending.size(); ++currentDirectoryIndex) {
+                if (abortFileOp.load(std::memory_order_acquire)) {
+                    return false;
                 }
-            } else if (S_ISDIR(fromStat.st_mode)) {
-                // If it's a directory, iterate over its contents and add them to the vector for processing
+                
+                const std::string currentFromPath = pending[currentDirectoryIndex].first;
+                const std::string currentToPath = pending[currentDirectoryIndex].second;
+    
                 DIR* dir = opendir(currentFromPath.c_str());
                 if (!dir) {
                     #if USING_LOGGING_DIRECTIVE
@@ -1159,108 +1307,178 @@ namespace ult {
                 }
     
                 bool hasContent = false;
-                // Cache current path lengths for efficient string building
                 dirent* entry;
                 while ((entry = readdir(dir)) != nullptr) {
                     if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
                     
                     hasContent = true;
-                    
-                    // More efficient path building
-                    subFromPath.clear();
-                    subFromPath.assign(currentFromPath);
-                    subFromPath += '/';
-                    subFromPath += entry->d_name;
-                    
-                    subToPath.clear();
-                    subToPath.assign(currentToPath);
-                    subToPath += '/';
-                    subToPath += entry->d_name;
-                    
-                    directories.emplace_back(std::move(subFromPath), std::move(subToPath)); // Use move semantics
+                    subFromPath = joinPath(currentFromPath, entry->d_name);
+                    isDir = entry->d_type == DT_DIR;
+                    if (!isDir) {
+                        if (stat(subFromPath.c_str(), &fromStat) != 0) {
+                            #if USING_LOGGING_DIRECTIVE
+                            if (!disableLogging)
+                                logMessage("Failed to get stat of " + subFromPath);
+                            #endif
+                            continue;
+                        }
+                        if (S_ISREG(fromStat.st_mode)) {
+                            plan.files.push_back({std::move(subFromPath), joinPath(currentToPath, entry->d_name), static_cast<long long>(fromStat.st_size)});
+                            plan.totalSize += fromStat.st_size;
+                            continue;
+                        }
+                        isDir = S_ISDIR(fromStat.st_mode);
+                    }
+                    if (isDir) {
+                        pending.emplace_back(std::move(subFromPath), joinPath(currentToPath, entry->d_name));
+                    }
                 }
                 closedir(dir);
                 
-                // Log this directory if it has content and we need logging
-                if (hasContent && needsLogging) {
-                    successfulSources.push_back(currentFromPath + "/");
-                    successfulDestinations.push_back(currentToPath + "/");
+                if (hasContent) {
+                    plan.directories.emplace_back(currentFromPath, currentToPath);
                 }
             }
+            return true;
         }
+
+        /**
+         * @brief Creates the directories of `plan` and copies its files.
+         *
+         * Files under COPY_STREAM_MIN_SIZE are shared out to COPY_THREADS workers while the calling
+         * thread streams the larger ones. Copied files are logged in plan order; with `logDirectories`
+         * the directories follow, deepest first. `copiedJobs`, when given, receives 1 for each
+         * job of `plan.files` that was copied.
+         *
+         * @return The number of files copied.
+         */
+        size_t runCopyPlan(CopyPlan& plan, long long& totalBytesCopied, long long totalSize,
+                         const std::string& logSource, const std::string& logDestination, bool logDirectories,
+                         std::vector<char>* copiedJobs = nullptr) {
+            for (const std::string& root : plan.roots) {
+                createDirectory(root);
+            }
+            // Parents come before children in walk order, so each level needs a single mkdir
+            for (const auto& directory : plan.directories) {
+                createSingleDirectory(directory.second);
+            }
     
-        // Batch write all successful operations to log files at the end
-        if (isTopLevelCall && needsLogging && filesCopied && !successfulSources.empty()) {
-    #if !USING_FSTREAM_DIRECTIVE
-            if (!logSource.empty()) {
-                createDirectory(getParentDirFromPath(logSource));
-                if (FILE* logFile = fopen(logSource.c_str(), "a")) {
-                    for (auto it = successfulSources.rbegin(); it != successfulSources.rend(); ++it) {
-                        writeLog(logFile, *it);
-                    }
-                    fclose(logFile);
-                }
-                #if USING_LOGGING_DIRECTIVE
-                else {
-                    if (!disableLogging)
-                        logMessage("Failed to open source log file: " + logSource);
-                }
-                #endif
+            std::vector<CopyJob>& jobs = plan.files;
+            std::vector<size_t> smallJobs, largeJobs;
+            for (size_t i = 0; i < jobs.size(); ++i) {
+                (jobs[i].size < COPY_STREAM_MIN_SIZE ? smallJobs : largeJobs).push_back(i);
             }
     
-            if (!logDestination.empty()) {
-                createDirectory(getParentDirFromPath(logDestination));
-                if (FILE* logFile = fopen(logDestination.c_str(), "a")) {
-                    for (auto it = successfulDestinations.rbegin(); it != successfulDestinations.rend(); ++it) {
-                        writeLog(logFile, *it);
-                    }
-                    fclose(logFile);
+            const size_t bufferSize = COPY_BUFFER_SIZE;
+            std::atomic<long long> bytesCopied(totalBytesCopied);
+            std::vector<char> copied(jobs.size(), 0);
+            std::atomic<size_t> nextSmallJob{0};
+    
+            auto copySmallFiles = [&]() {
+                std::unique_ptr<char[]> buffer;
+                size_t i;
+                while (!abortFileOp.load(std::memory_order_acquire) &&
+                       (i = nextSmallJob.fetch_add(1, std::memory_order_relaxed)) < smallJobs.size()) {
+                    if (!buffer) buffer.reset(new char[bufferSize]);
+                    const CopyJob& job = jobs[smallJobs[i]];
+                    copied[smallJobs[i]] = copyFileData(job.from, job.to, bytesCopied, totalSize, buffer.get(), bufferSize);
                 }
-                #if USING_LOGGING_DIRECTIVE
-                else {
-                    if (!disableLogging)
-                        logMessage("Failed to open destination log file: " + logDestination);
+            };
+    
+            const size_t threadCount = std::min(COPY_THREADS, smallJobs.size());
+            std::vector<std::thread> workers;
+            if (threadCount > 1) {
+                workers.reserve(threadCount - 1);
+                for (size_t t = 1; t < threadCount; ++t) {
+                    workers.emplace_back(copySmallFiles);
                 }
-                #endif
             }
-    #else
-            if (!logSource.empty()) {
-                createDirectory(getParentDirFromPath(logSource));
-                std::ofstream logSourceFile(logSource, std::ios::app);
-                if (logSourceFile.is_open()) {
-                    for (auto it = successfulSources.rbegin(); it != successfulSources.rend(); ++it) {
-                        writeLog(logSourceFile, *it);
-                    }
-                    logSourceFile.close();
-                }
-                #if USING_LOGGING_DIRECTIVE
-                else {
-                    if (!disableLogging)
-                        logMessage("Failed to open source log file: " + logSource);
+    
+            // Large files are bandwidth-bound; stream them here while the workers take the small ones
+            if (!largeJobs.empty()) {
+                std::unique_ptr<char[]> buffer(new char[bufferSize]);
+                for (size_t i : largeJobs) {
+                    if (abortFileOp.load(std::memory_order_acquire)) break;
+                    copied[i] = copyFileData(jobs[i].from, jobs[i].to, bytesCopied, totalSize, buffer.get(), bufferSize);
                 }
-                #endif
             }
+            copySmallFiles();  // The calling thread takes part once its own files are done
+            for (auto& thread : workers) {
+                thread.join();
+            }
+            totalBytesCopied = bytesCopied.load(std::memory_order_relaxed);
     
-            if (!logDestination.empty()) {
-                createDirectory(getParentDirFromPath(logDestination));
-                std::ofstream logDestFile(logDestination, std::ios::app);
-                if (logDestFile.is_open()) {
-                    for (auto it = successfulDestinations.rbegin(); it != successfulDestinations.rend(); ++it) {
-                        writeLog(logDestFile, *it);
-                    }
-                    logDestFile.close();
+            const bool aborted = abortFileOp.load(std::memory_order_acquire);
+    
+            if (!logSource.empty() || !logDestination.empty()) {
+                std::vector<std::string> sourceLines, destinationLines;
+                for (size_t i = 0; i < jobs.size(); ++i) {
+                    if (!copied[i]) continue;
+                    if (!logSource.empty()) sourceLines.push_back(std::move(jobs[i].from));
+                    if (!logDestination.empty()) destinationLines.push_back(std::move(jobs[i].to));
                 }
-                #if USING_LOGGING_DIRECTIVE
-                else {
-                    if (!disableLogging)
-                        logMessage("Failed to open destination log file: " + logDestination);
+                if (logDirectories && !aborted && !jobs.empty()) {
+                    for (auto it = plan.directories.rbegin(); it != plan.directories.rend(); ++it) {
+                        if (!logSource.empty()) sourceLines.push_back(it->first.back() == '/' ? it->first : it->first + "/");
+                        if (!logDestination.empty()) destinationLines.push_back(it->second.back() == '/' ? it->second : it->second + "/");
+                    }
                 }
-                #endif
+                appendLogLines(logSource, sourceLines);
+                appendLogLines(logDestination, destinationLines);
             }
-    #endif
+    
+            if (aborted) {
+                copyPercentage.store(-1, std::memory_order_release);
+            }
+            const size_t copiedCount = static_cast<size_t>(std::count(copied.begin(), copied.end(), 1));
+            if (copiedJobs) *copiedJobs = std::move(copied);
+            return copiedCount;
         }
+    }
+
+    /**
+     * @brief Copies a file or directory from the source path to the destination path.
+     *
+     * This function copies a file or directory specified by `fromFileOrDirectory` to the location specified by `toFileOrDirectory`.
+     * If the source is a regular file, it copies the file to the destination. If the source is a directory, it recursively copies
+     * the entire directory and its contents to the destination.
+     *
+     * A directory is walked once to list its files, then every destination directory is created before any
+     * data is copied. Files under COPY_STREAM_MIN_SIZE are shared out to COPY_THREADS workers while the
+     * calling thread streams the larger ones. Log lines are collected and appended once at the end.
+     *
+     * @param fromPath The path of the source file or directory to be copied.
+     * @param toPath The path of the destination where the file or directory will be copied.
+     */
+    void copyFileOrDirectory(const std::string& fromPath, const std::string& toPath, long long* totalBytesCopied, long long totalSize,
+        const std::string& logSource, const std::string& logDestination) {
+        bool isTopLevelCall = totalBytesCopied == nullptr;
+        long long tempBytesCopied = 0;
     
         if (isTopLevelCall) {
+            totalBytesCopied = &tempBytesCopied;
+        }
+    
+        if (toPath.back() != '/') {
+            // If toPath is a file, create its parent directory and copy the file
+            if (isTopLevelCall) totalSize = getTotalSize(fromPath);
+            createDirectory(getParentDirFromPath(toPath));
+            copySingleFile(fromPath, toPath, *totalBytesCopied, totalSize, logSource, logDestination);
+            return;
+        }
+    
+        CopyPlan plan;
+        if (!planCopy(fromPath, toPath, plan)) {
+            copyPercentage.store(-1, std::memory_order_release);
+            return;
+        }
+        if (isTopLevelCall) {
+            totalSize = plan.totalSize;
+        }
+    
+        runCopyPlan(plan, *totalBytesCopied, totalSize, logSource, logDestination, isTopLevelCall);
+    
+        if (isTopLevelCall && !abortFileOp.load(std::memory_order_acquire)) {
             copyPercentage.store(100, std::memory_order_release); // Set progress to 100% on completion of top-level call
         }
     }
@@ -1273,30 +1491,286 @@ namespace ult {
      * This function identifies files or directories that match the `sourcePathPattern` and copies them to the `toDirectory`.
      * It processes each matching entry in the source directory pattern and copies them to the specified destination.
      *
+     * All matches are walked once into a single copy plan, whose sizes also give the progress total,
+     * and the plan is then copied in one run.
+     *
      * @param sourcePathPattern The pattern used to match files or directories to be copied.
      * @param toDirectory The destination directory where matching files or directories will be copied.
      */
     void copyFileOrDirectoryByPattern(const std::string& sourcePathPattern, const std::string& toDirectory,
         const std::string& logSource, const std::string& logDestination) {
         fileList = getFilesListByWildcards(sourcePathPattern);
-        long long totalSize = 0;
-        for (const std::string& path : fileList) {
-            totalSize += getTotalSize(path);
-        }
     
-        long long totalBytesCopied = 0;
+        CopyPlan plan;
+        bool planned = true;
         for (std::string& sourcePath : fileList) {
-            copyFileOrDirectory(sourcePath, toDirectory, &totalBytesCopied, totalSize, logSource, logDestination);
+            planned = planned && planCopy(sourcePath, toDirectory, plan);
             sourcePath = "";
         }
-
         fileList.clear();
         fileList.shrink_to_fit();
+    
+        if (!planned) {
+            copyPercentage.store(-1, std::memory_order_release);
+            return;
+        }
+    
+        long long totalBytesCopied = 0;
+        runCopyPlan(plan, totalBytesCopied, plan.totalSize, logSource, logDestination, false);
         //copyPercentage.store(-1, std::memory_order_release);  // Reset after operation
     }
 
 
     
+    namespace {
+        // True if the two files hold the same bytes; both are known to have `size` bytes
+        bool sameFileContents(const std::string& firstPath, const std::string& secondPath, long long size, char* buffers, size_t bufferSize) {
+        #if !USING_FSTREAM_DIRECTIVE
+            FileGuard first(fopen(firstPath.c_str(), "rb"));
+            FileGuard second(fopen(secondPath.c_str(), "rb"));
+            if (!first.get() || !second.get()) return false;
+            size_t length;
+            while (size > 0) {
+                length = static_cast<size_t>(std::min<long long>(size, static_cast<long long>(bufferSize)));
+                if (fread(buffers, 1, length, first.get()) != length ||
+                    fread(buffers + bufferSize, 1, length, second.get()) != length ||
+                    std::memcmp(buffers, buffers + bufferSize, length) != 0) {
+                    return false;
+                }
+                size -= static_cast<long long>(length);
+            }
+        #else
+            std::ifstream first(firstPath, std::ios::binary);
+            std::ifstream second(secondPath, std::ios::binary);
+            if (!first.is_open() || !second.is_open()) return false;
+            size_t length;
+            while (size > 0) {
+                length = static_cast<size_t>(std::min<long long>(size, static_cast<long long>(bufferSize)));
+                if (!first.read(buffers, length) || !second.read(buffers + bufferSize, length) ||
+                    std::memcmp(buffers, buffers + bufferSize, length) != 0) {
+                    return false;
+                }
+                size -= static_cast<long long>(length);
+            }
+        #endif
+            return true;
+        }
+
+        // What mirrorFilesDelta saw of one file when it last copied it
+        struct MirrorRecord {
+            long long size = 0;
+            long long sourceTime = 0;
+            long long targetTime = 0;
+        };
+
+        using MirrorState = std::unordered_map<std::string, MirrorRecord>;  // Keyed by path relative to the roots
+
+        // State file of one source/target pair, named from a 64-bit FNV-1a hash of both paths
+        std::string getMirrorStatePath(const std::string& sourcePath, const std::string& targetPath) {
+            uint64_t hash = 0xcbf29ce484222325ULL;
+            const auto mix = [&hash](const std::string& text) {
+                for (unsigned char c : text) {
+                    hash ^= c;
+                    hash *= 0x100000001b3ULL;
+                }
+                hash ^= '\n';
+                hash *= 0x100000001b3ULL;
+            };
+            mix(sourcePath);
+            mix(targetPath);
+            char name[32];
+            snprintf(name, sizeof(name), "%016llx.txt", static_cast<unsigned long long>(hash));
+            return MIRROR_STATE_PATH + name;
+        }
+
+        // Parses a "<size> <source mtime> <target mtime> <relative path>" line
+        void parseMirrorRecord(const std::string& line, MirrorState& state) {
+            const char* cursor = line.c_str();
+            char* next;
+            MirrorRecord record;
+            record.size = std::strtoll(cursor, &next, 10);
+            if (next == cursor || *next != ' ') return;
+            cursor = next + 1;
+            record.sourceTime = std::strtoll(cursor, &next, 10);
+            if (next == cursor || *next != ' ') return;
+            cursor = next + 1;
+            record.targetTime = std::strtoll(cursor, &next, 10);
+            if (next == cursor || *next != ' ' || next[1] == '\0') return;
+            state[std::string(next + 1)] = record;
+        }
+
+        MirrorState loadMirrorState(const std::string& statePath) {
+            MirrorState state;
+        #if !USING_FSTREAM_DIRECTIVE
+            FileGuard file(fopen(statePath.c_str(), "r"));
+            if (!file.get()) return state;
+            char buffer[1024];
+            std::string line;
+            size_t length;
+            while (fgets(buffer, sizeof(buffer), file.get())) {
+                line += buffer;
+                length = line.size();
+                if (length == 0 || line[length - 1] != '\n') continue;  // Longer than the buffer
+                line.pop_back();
+                parseMirrorRecord(line, state);
+                line.clear();
+            }
+        #else
+            std::ifstream file(statePath);
+            if (!file.is_open()) return state;
+            std::string line;
+            while (std::getline(file, line)) {
+                parseMirrorRecord(line, state);
+            }
+        #endif
+            return state;
+        }
+
+        void saveMirrorState(const std::string& statePath, const MirrorState& state) {
+            createDirectory(MIRROR_STATE_PATH);
+        #if !USING_FSTREAM_DIRECTIVE
+            FileGuard file(fopen(statePath.c_str(), "w"));
+            if (!file.get()) return;
+            for (const auto& [path, record] : state) {
+                fprintf(file.get(), "%lld %lld %lld %s\n", record.size, record.sourceTime, record.targetTime, path.c_str());
+            }
+        #else
+            std::ofstream file(statePath, std::ios::trunc);
+            if (!file.is_open()) return;
+            for (const auto& [path, record] : state) {
+                file << record.size << ' ' << record.sourceTime << ' ' << record.targetTime << ' ' << path << '\n';
+            }
+        #endif
+        }
+    }
+
+    /**
+     * @brief Copies only the files of `sourcePath` whose mirror under `targetPath` is missing or out of date.
+     *
+     * Every copy records the size and the source and target mtimes under MIRROR_STATE_PATH. A target file
+     * is current when it still has the source's size and both mtimes match that record, so a source that
+     * arrives with an older mtime (e.g. extracted from an archive) still counts as changed. Files copied
+     * while their source mtime was within the 2 s racy window are not recorded and are copied again on the
+     * next run. With `compareContents`, files of equal size are compared byte for byte instead. The changed
+     * files are copied through the copy engine, and the target paths actually written replace the contents
+     * of `manifestPath`, one per line, in the format of the copy logs.
+     *
+     * A same-size change that leaves both mtimes as recorded, such as a restore that preserves timestamps
+     * or a target edit within 2 s of the copy, is only detected with `compareContents`.
+     *
+     * @param sourcePath The path of the source directory.
+     * @param targetPath The path of the target directory.
+     * @param compareContents Whether to compare the contents of equally sized files.
+     * @param manifestPath Optional file that receives the list of copied target files.
+     * @return Counts of copied, unchanged and failed files.
+     */
+    MirrorResult mirrorFilesDelta(const std::string& sourcePath, const std::string& targetPath,
+        bool compareContents, const std::string& manifestPath) {
+        MirrorResult result;
+        fileList = getFilesListFromDirectory(sourcePath);
+    
+        const std::string statePath = getMirrorStatePath(sourcePath, targetPath);
+        const MirrorState previousState = loadMirrorState(statePath);
+        MirrorState state;
+        std::vector<std::pair<std::string, MirrorRecord>> pending;  // Parallel to plan.files
+    
+        CopyPlan plan;
+        std::unique_ptr<char[]> compareBuffers;
+        std::string relativePath, updatedPath;
+        struct stat sourceStat, targetStat;
+        MirrorState::const_iterator record;
+        bool unchanged;
+        for (std::string& path : fileList) {
+            if (abortFileOp.load(std::memory_order_acquire)) break;
+    
+            relativePath = path.substr(sourcePath.size());
+            updatedPath = targetPath + relativePath;
+            if (path == updatedPath || stat(path.c_str(), &sourceStat) != 0 || !S_ISREG(sourceStat.st_mode)) {
+                path = "";
+                continue;
+            }
+    
+            unchanged = stat(updatedPath.c_str(), &targetStat) == 0 && S_ISREG(targetStat.st_mode) &&
+                        targetStat.st_size == sourceStat.st_size;
+            if (unchanged) {
+                if (compareContents) {
+                    if (!compareBuffers) compareBuffers.reset(new char[COPY_BUFFER_SIZE * 2]);
+                    unchanged = sameFileContents(path, updatedPath, static_cast<long long>(sourceStat.st_size),
+                                                 compareBuffers.get(), COPY_BUFFER_SIZE);
+                } else {
+                    record = previousState.find(relativePath);
+                    unchanged = record != previousState.end() &&
+                                record->second.size == static_cast<long long>(sourceStat.st_size) &&
+                                record->second.sourceTime == static_cast<long long>(sourceStat.st_mtime) &&
+                                record->second.targetTime == static_cast<long long>(targetStat.st_mtime);
+                }
+            }
+    
+            if (unchanged) {
+                ++result.skipped;
+                if (!compareContents) {
+                    state.emplace(std::move(relativePath), record->second);
+                } else if (!isRacyFileTime(static_cast<long long>(sourceStat.st_mtime))) {
+                    state.emplace(std::move(relativePath), MirrorRecord{static_cast<long long>(sourceStat.st_size),
+                        static_cast<long long>(sourceStat.st_mtime), static_cast<long long>(targetStat.st_mtime)});
+                }
+            } else {
+                pending.emplace_back(std::move(relativePath), MirrorRecord{static_cast<long long>(sourceStat.st_size),
+                                                                           static_cast<long long>(sourceStat.st_mtime), 0});
+                plan.files.push_back({std::move(path), updatedPath, static_cast<long long>(sourceStat.st_size)});
+                plan.totalSize += sourceStat.st_size;
+            }
+            path = "";
+        }
+        fileList.clear();
+        fileList.shrink_to_fit();
+    
+        if (abortFileOp.load(std::memory_order_acquire)) {
+            copyPercentage.store(-1, std::memory_order_release);
+            return result;
+        }
+    
+        // Only the parents of changed files need to exist
+        for (const CopyJob& job : plan.files) {
+            plan.roots.push_back(getParentDirFromPath(job.to));
+        }
+        std::sort(plan.roots.begin(), plan.roots.end());
+        plan.roots.erase(std::unique(plan.roots.begin(), plan.roots.end()), plan.roots.end());
+    
+        if (!manifestPath.empty()) {
+            createDirectory(getParentDirFromPath(manifestPath));
+        #if !USING_FSTREAM_DIRECTIVE
+            if (FILE* manifest = fopen(manifestPath.c_str(), "w")) fclose(manifest);
+        #else
+            std::ofstream manifest(manifestPath, std::ios::trunc);
+        #endif
+        }
+        // Target paths are moved out of the plan when the manifest is written
+        std::vector<std::string> copiedTargets;
+        copiedTargets.reserve(plan.files.size());
+        for (const CopyJob& job : plan.files) {
+            copiedTargets.push_back(job.to);
+        }
+    
+        long long totalBytesCopied = 0;
+        const size_t planned = plan.files.size();
+        std::vector<char> copiedJobs;
+        result.copied = planned ? runCopyPlan(plan, totalBytesCopied, plan.totalSize, "", manifestPath, false, &copiedJobs) : 0;
+        result.failed = planned - result.copied;
+    
+        for (size_t i = 0; i < copiedJobs.size(); ++i) {
+            // A source still inside the racy window may change again without its mtime moving
+            if (!copiedJobs[i] || isRacyFileTime(pending[i].second.sourceTime) ||
+                stat(copiedTargets[i].c_str(), &targetStat) != 0) {
+                continue;
+            }
+            pending[i].second.targetTime = static_cast<long long>(targetStat.st_mtime);
+            state.insert_or_assign(std::move(pending[i].first), pending[i].second);
+        }
+        saveMirrorState(statePath, state);
+        return result;
+    }
+
     /**
      * @brief Mirrors the deletion of files from a source directory to a target directory.
      *
@@ -1306,8 +1780,14 @@ namespace ult {
      * @param sourcePath The path of the source directory.
      * @param targetPath The path of the target directory where files will be mirrored and deleted.
      *                   Default is "sdmc:/". You can specify a different target path if needed.
+     * @param mode "delete", "copy", or "copy_delta" to copy only files that changed (see mirrorFilesDelta).
      */
     void mirrorFiles(const std::string& sourcePath, const std::string targetPath, const std::string mode) {
+        if (mode == "copy_delta") {
+            mirrorFilesDelta(sourcePath, targetPath);
+            return;
+        }
+    
         fileList = getFilesListFromDirectory(sourcePath);
         std::string updatedPath;
         long long totalSize = 0;
@@ -1484,4 +1964,97 @@ namespace ult {
             closedir(directory);
         }
     }
+
+
+    MappedFile::MappedFile(const std::string& filePath, Access access) {
+        struct stat fileStat;
+        if (stat(filePath.c_str(), &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) return;
+        fileSize = static_cast<size_t>(fileStat.st_size);
+
+    #if USING_MMAP_DIRECTIVE
+        pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        descriptor = open(filePath.c_str(), O_RDONLY);
+        if (descriptor >= 0 && fileSize > 0) {
+            void* mapped = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (mapped != MAP_FAILED) {
+                mapping = static_cast<unsigned char*>(mapped);
+                madvise(mapped, fileSize, access == Access::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+                opened = true;
+                return;
+            }
+        }
+        if (descriptor >= 0) {
+            close(descriptor);
+            descriptor = -1;
+        }
+    #else
+        (void)access;
+    #endif
+
+        // Buffered fallback; reads go straight into the caller-sized buffer
+    #if !USING_FSTREAM_DIRECTIVE
+        file = fopen(filePath.c_str(), "rb");
+        if (!file) return;
+        setvbuf(file, nullptr, _IONBF, 0);
+    #else
+        file.rdbuf()->pubsetbuf(nullptr, 0);
+        file.open(filePath, std::ios::binary);
+        if (!file.is_open()) return;
+    #endif
+        opened = true;
+    }
+
+    MappedFile::~MappedFile() {
+    #if USING_MMAP_DIRECTIVE
+        if (mapping) munmap(mapping, fileSize);
+        if (descriptor >= 0) close(descriptor);
+    #endif
+    #if !USING_FSTREAM_DIRECTIVE
+        if (file) fclose(file);
+    #endif
+    }
+
+    void MappedFile::adviseRange(size_t offset, size_t length) {
+    #if USING_MMAP_DIRECTIVE
+        // Only a partial walk needs the hint; MADV_SEQUENTIAL already reads ahead over the whole file
+        if (!mapping || length == fileSize) return;
+        const size_t alignedOffset = offset / pageSize * pageSize;
+        madvise(mapping + alignedOffset, length + (offset - alignedOffset), MADV_WILLNEED);
+    #else
+        (void)offset;
+        (void)length;
+    #endif
+    }
+
+    void MappedFile::releaseRange(size_t offset, size_t length) {
+    #if USING_MMAP_DIRECTIVE
+        // Drops this process's page mappings only; the data stays in the page cache
+        const size_t first = (offset + pageSize - 1) / pageSize * pageSize;
+        const size_t last = std::min(offset + length, fileSize) / pageSize * pageSize;
+        if (mapping && last > first) {
+            madvise(mapping + first, last - first, MADV_DONTNEED);
+        }
+    #else
+        (void)offset;
+        (void)length;
+    #endif
+    }
+
+    bool MappedFile::seekTo(size_t offset) {
+    #if !USING_FSTREAM_DIRECTIVE
+        return fseek(file, static_cast<long>(offset), SEEK_SET) == 0;
+    #else
+        file.clear();
+        return static_cast<bool>(file.seekg(static_cast<std::streamoff>(offset)));
+    #endif
+    }
+
+    size_t MappedFile::readInto(unsigned char* destination, size_t length) {
+    #if !USING_FSTREAM_DIRECTIVE
+        return fread(destination, 1, length, file);
+    #else
+        file.read(reinterpret_cast<char*>(destination), static_cast<std::streamsize>(length));
+        return static_cast<size_t>(file.gcount());
+    #endif
+    }
 }
\ No newline at end of file